@@ -0,0 +1,133 @@
+#pragma once
+
+#include "logger/LogEvent.h"
+#include "logger/LogFormatter.h"
+#include "common/alias.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <format>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace Bench {
+
+    /** @brief 什么都不写的 Appender，用来隔离出日志前端本身的开销 */
+    class NullAppender{
+    public:
+        static void log(const LogFormatter&, const LogEvent&) {}
+    };
+
+    /** @brief 延迟分位数统计（单位：纳秒） */
+    struct Percentiles{
+        uint64_t p50  = 0;
+        uint64_t p99  = 0;
+        uint64_t p999 = 0;
+        uint64_t max  = 0;
+    };
+
+    inline auto ComputePercentiles(std::vector<uint64_t>& samples) -> Percentiles
+    {
+        if(samples.empty())
+        {
+            return {};
+        }
+        std::ranges::sort(samples);
+        auto at = [&samples](double q) -> uint64_t {
+            auto idx = static_cast<size_t>(q * static_cast<double>(samples.size() - 1));
+            return samples[idx];
+        };
+        return Percentiles{at(0.50), at(0.99), at(0.999), samples.back()};
+    }
+
+    inline auto NowNs() -> uint64_t
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+    }
+
+    /**
+     * @brief 把一个 benchmark 的结果写成 JSON，便于在版本之间 diff
+     * @details 命令行带 --json <文件> 时在析构时写出，不带时什么都不做，表格输出照旧。格式：
+     *          {"benchmark": "...", "results": [
+     *            {"case": "...", "<指标>": 数值, ...},
+     *          ]}
+     *          每个 case 占一行，指标按 add() 时的顺序输出，逐行比较即可看出变化
+     */
+    class JsonReport{
+    public:
+        JsonReport(std::string benchmark, int argc, char** argv) : benchmark_{std::move(benchmark)}
+        {
+            for(auto i = 1; i + 1 < argc; ++i)
+            {
+                if(std::string_view{argv[i]} == "--json")
+                {
+                    path_ = argv[i + 1];
+                }
+            }
+        }
+
+        JsonReport(const JsonReport&)            = delete;
+        JsonReport& operator=(const JsonReport&) = delete;
+
+        ~JsonReport()
+        {
+            if(path_.empty())
+            {
+                return;
+            }
+            auto out = std::ofstream{path_, std::ios::out | std::ios::trunc};
+            out << std::format("{{\"benchmark\": \"{}\", \"results\": [\n", Escape_(benchmark_));
+            for(auto i = size_t{0}; i < results_.size(); ++i)
+            {
+                out << "  {" << results_[i] << (i + 1 < results_.size() ? "},\n" : "}\n");
+            }
+            out << "]}\n";
+            if(not out)
+            {
+                std::cerr << "failed to write " << path_ << "\n";
+            }
+        }
+
+        auto add(std::string_view name, std::initializer_list<std::pair<std::string_view, double>> metrics) -> void
+        {
+            auto line = std::format("\"case\": \"{}\"", Escape_(name));
+            for(const auto& [key, value] : metrics)
+            {
+                line += std::format(", \"{}\": {}", Escape_(key), value);
+            }
+            results_.push_back(std::move(line));
+        }
+
+        auto add(std::string_view name, const Percentiles& p) -> void
+        {
+            add(name, {{"p50_ns", static_cast<double>(p.p50)}, {"p99_ns", static_cast<double>(p.p99)},
+                       {"p999_ns", static_cast<double>(p.p999)}, {"max_ns", static_cast<double>(p.max)}});
+        }
+
+    private:
+        static auto Escape_(std::string_view text) -> std::string
+        {
+            auto escaped = std::string{};
+            for(auto c : text)
+            {
+                if(c == '"' or c == '\\')
+                {
+                    escaped.push_back('\\');
+                }
+                escaped.push_back(c);
+            }
+            return escaped;
+        }
+
+        std::string benchmark_;
+        std::string path_;
+        std::vector<std::string> results_;
+    };
+
+} // namespace Bench
@@ -0,0 +1,12 @@
+#!/bin/bash
+
+# 编译并运行所有 benchmark，参数与 test/test.bash 一致，额外开启 -O2
+# 结果同时写成 JSON 放在 bench_results/<名称>.json；用 CMake 时对应 cmake --build <build> --target bench
+# 用法: ./bench.bash [bench_xxx]   不带参数时运行全部
+
+benches=${@:-$(ls bench_*.cpp | sed 's/\.cpp$//')}
+
+mkdir -p bench_results
+for b in $benches; do
+    g++ $b.cpp ../src/*.cpp ../net/*.cpp -I../include -I.. -std=c++23 -O2 -lpthread -lz -o $b && ./$b --json bench_results/$b.json
+done
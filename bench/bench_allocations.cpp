@@ -0,0 +1,126 @@
+#include "BenchCommon.hpp"
+#include "common/LogMacros.h"
+#include "logger/AsyncLogger.h"
+#include "logger/Logger.h"
+#include "logger/LoggerAppender.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <new>
+
+/**
+ * @brief 每次日志调用的堆分配次数(整个进程，包括 AsyncLogger 的后台线程)：
+ *        - sync/null     : 同步 Logger + 空 appender，日志宏带 3 个参数
+ *        - sync/file     : 同步 Logger + RollingFileAppender
+ *        - sync/long     : 同上，消息超过 LogEvent 的内联容量
+ *        - async/<前端>  : AsyncLogger + 空 appender，统计到 stop() 为止
+ *        每种情况先热身一轮，线程局部缓存、内存池等一次性分配不计入
+ */
+
+namespace {
+    std::atomic<size_t> g_alloc_count = 0;
+}
+
+// 替换全局 operator new，统计堆分配次数
+auto operator new(std::size_t size) -> void*
+{
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    if(auto* p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+// 按缓存行对齐的类型(事件缓冲、AsyncLogger 本身)走对齐版本，同样计数
+auto operator new(std::size_t size, std::align_val_t align) -> void*
+{
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    auto alignment = static_cast<std::size_t>(align);
+    if(auto* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+// 上面两个 operator new 都是 malloc/aligned_alloc 分配的，这里配对的 free 是对的；
+// GCC 把 delete 内联到 new 表达式旁边后只看到 new 配 free，会误报 -Wmismatched-new-delete
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+constexpr size_t c_calls = 100000;
+constexpr auto c_output_file = "bench_allocations.log";
+
+template <typename LoggerPtr>
+auto LogMany(const LoggerPtr& logger, std::string_view payload) -> void
+{
+    for(auto i = size_t{0}; i < c_calls; ++i)
+    {
+        COTTON_LOG_INFO(logger, "order {} filled qty={} note={}", i, 100 + i % 7, payload);
+    }
+}
+
+auto Report(Bench::JsonReport& report, std::string_view label, size_t allocs) -> void
+{
+    auto per_call = static_cast<double>(allocs) / c_calls;
+    std::cout << std::format("{:<22}{:>14.3f}\n", label, per_call);
+    report.add(label, {{"allocs_per_call", per_call}});
+}
+
+template <typename Appender, typename... Args>
+auto RunSync(Bench::JsonReport& report, std::string_view label, std::string_view payload, Args&&... args) -> void
+{
+    auto logger = std::make_shared<Logger>("bench");
+    logger->addAppender(std::make_shared<AppenderProxy<Appender>>(LogFormatter{}, std::forward<Args>(args)...));
+    LogMany(logger, payload);
+
+    auto before = g_alloc_count.load();
+    LogMany(logger, payload);
+    Report(report, label, g_alloc_count.load() - before);
+}
+
+auto RunAsync(Bench::JsonReport& report, std::string_view label, AsyncFrontEnd front_end) -> void
+{
+    auto logger = std::make_shared<AsyncLogger>(1, front_end);
+    logger->addAppender(std::make_shared<AppenderProxy<Bench::NullAppender>>());
+    logger->start();
+    LogMany(logger, "short");
+
+    auto before = g_alloc_count.load();
+    LogMany(logger, "short");
+    logger->stop();
+    Report(report, label, g_alloc_count.load() - before);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_allocations", argc, argv};
+    std::cout << std::format("{:<22}{:>14}\n", "path", "allocs/call");
+
+    RunSync<Bench::NullAppender>(report, "sync/null", "short");
+    RunSync<RollingFileAppender>(report, "sync/file", "short", c_output_file, 4_gb);
+    RunSync<Bench::NullAppender>(report, "sync/long", std::string(1024, 'x'));
+    std::filesystem::remove(c_output_file);
+
+    RunAsync(report, "async/DoubleBuffer", AsyncFrontEnd::DoubleBuffer);
+    RunAsync(report, "async/MpscRing", AsyncFrontEnd::MpscRing);
+    RunAsync(report, "async/ThreadLocal", AsyncFrontEnd::ThreadLocal);
+    return 0;
+}
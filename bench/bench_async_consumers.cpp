@@ -0,0 +1,87 @@
+#include "BenchCommon.hpp"
+#include "common/LogMacros.h"
+#include "logger/AsyncLogger.h"
+#include "logger/LoggerAppender.h"
+
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <thread>
+
+/**
+ * @brief AsyncLogger 单消费者与并行消费(consumer_threads)的端到端吞吐量：
+ *        一个写文件的 appender 加一个每批固定耗时的慢 appender(模拟终端/网络)，
+ *        Block 策略保证不丢事件，计时从第一条日志到 stop() 写完为止
+ */
+
+namespace {
+
+constexpr size_t c_lines = 400'000;
+constexpr size_t c_producers = 4;
+constexpr auto c_output_file = "bench_async_consumers.log";
+
+// 每批睡 50us，代表写终端或网络这类和事件数关系不大的固定开销
+class SlowSinkAppender{
+public:
+    static void log(const LogFormatter&, const LogEvent&) {}
+
+    static void log(const LogFormatter&, std::span<const LogEvent>)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds{50});
+    }
+};
+
+auto Run(Bench::JsonReport& report, size_t consumers) -> void
+{
+    std::filesystem::remove(c_output_file);
+    auto options = AsyncLoggerOptions{.consumer_threads = consumers};
+    options.overflow.policy = OverflowPolicy::Block;
+    options.overflow.block_timeout = std::chrono::seconds{10};
+
+    auto metrics = AsyncLoggerMetrics{};
+    auto begin = Bench::NowNs();
+    {
+        auto logger = std::make_shared<AsyncLogger>(options);
+        logger->addAppender(std::make_shared<AppenderProxy<RollingFileAppender>>(LogFormatter{}, c_output_file, 4_gb));
+        logger->addAppender(std::make_shared<AppenderProxy<SlowSinkAppender>>());
+        logger->start();
+
+        auto workers = std::vector<std::thread>{};
+        for(auto t = size_t{0}; t < c_producers; ++t)
+        {
+            workers.emplace_back([&logger]{
+                for(auto i = size_t{0}; i < c_lines / c_producers; ++i)
+                {
+                    COTTON_LOG_INFO(logger, "order {} filled qty={} px={:.4f}", i, 100 + i % 7, 101.25 + static_cast<double>(i % 13));
+                }
+            });
+        }
+        for(auto& worker : workers)
+        {
+            worker.join();
+        }
+        logger->stop();
+        metrics = logger->getMetrics();
+    }
+    auto elapsed = Bench::NowNs() - begin;
+    std::filesystem::remove(c_output_file);
+
+    auto lines_per_s = static_cast<double>(metrics.written) / (static_cast<double>(elapsed) / 1e9);
+    std::cout << std::format("{:<12}{:>16.0f}{:>12}{:>12}\n", consumers, lines_per_s, metrics.written, metrics.totalDropped());
+    report.add(std::format("consumers/{}", consumers), {{"lines_per_s", lines_per_s},
+                                                        {"dropped", static_cast<double>(metrics.totalDropped())}});
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_async_consumers", argc, argv};
+    std::cout << std::format("hardware threads: {}\n", std::thread::hardware_concurrency());
+    std::cout << std::format("{:<12}{:>16}{:>12}{:>12}\n", "consumers", "lines/s", "written", "dropped");
+    for(auto consumers : {size_t{1}, size_t{2}, size_t{4}})
+    {
+        Run(report, consumers);
+    }
+    return 0;
+}
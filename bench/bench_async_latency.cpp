@@ -0,0 +1,86 @@
+#include "BenchCommon.hpp"
+#include "logger/AsyncLogger.h"
+#include "logger/AppenderProxy.hpp"
+
+#include <iostream>
+#include <format>
+#include <thread>
+
+/**
+ * @brief AsyncLogger 生产者延迟测试：分别统计 DoubleBuffer / MpscRing / ThreadLocal 三种前端
+ *        在 1/8/32/64 个生产者线程下 append() 的 p50/p99/p999/max
+ */
+
+namespace {
+
+constexpr size_t c_events_per_thread = 20000;
+
+auto FrontEndName(AsyncFrontEnd front_end) -> std::string_view
+{
+    switch(front_end)
+    {
+        case AsyncFrontEnd::DoubleBuffer: return "DoubleBuffer";
+        case AsyncFrontEnd::MpscRing:     return "MpscRing";
+        case AsyncFrontEnd::ThreadLocal:  return "ThreadLocal";
+    }
+    return "Unknown";
+}
+
+auto RunOnce(AsyncFrontEnd front_end, size_t thread_count) -> Bench::Percentiles
+{
+    auto logger = std::make_shared<AsyncLogger>(1, front_end);
+    logger->addAppender(std::make_shared<AppenderProxy<Bench::NullAppender>>());
+    logger->start();
+
+    auto samples = std::vector<std::vector<uint64_t>>(thread_count);
+    auto threads = std::vector<std::thread>{};
+    threads.reserve(thread_count);
+
+    for(auto t = size_t{0}; t < thread_count; ++t)
+    {
+        threads.emplace_back([&logger, &local = samples[t], t]{
+            local.reserve(c_events_per_thread);
+            for(auto i = size_t{0}; i < c_events_per_thread; ++i)
+            {
+                // 事件构造不计入延迟，只测 append 本身
+                auto event = LogEvent{"bench", LogLevel::INFO, 0, static_cast<uint32_t>(t), "bench", 0, 0};
+                auto begin = Bench::NowNs();
+                logger->append(std::move(event));
+                local.push_back(Bench::NowNs() - begin);
+            }
+        });
+    }
+    for(auto& th : threads)
+    {
+        th.join();
+    }
+    logger->stop();
+
+    auto merged = std::vector<uint64_t>{};
+    merged.reserve(thread_count * c_events_per_thread);
+    for(auto& local : samples)
+    {
+        merged.insert(merged.end(), local.begin(), local.end());
+    }
+    return Bench::ComputePercentiles(merged);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_async_latency", argc, argv};
+    std::cout << std::format("{:<14}{:>8}{:>10}{:>10}{:>10}{:>12}\n", "front_end", "threads", "p50(ns)", "p99(ns)", "p999(ns)", "max(ns)");
+    for(auto front_end : {AsyncFrontEnd::DoubleBuffer, AsyncFrontEnd::MpscRing, AsyncFrontEnd::ThreadLocal})
+    {
+        for(auto threads : {1, 8, 32, 64})
+        {
+            auto result = RunOnce(front_end, static_cast<size_t>(threads));
+            std::cout << std::format("{:<14}{:>8}{:>10}{:>10}{:>10}{:>12}\n",
+                                     FrontEndName(front_end),
+                                     threads, result.p50, result.p99, result.p999, result.max);
+            report.add(std::format("{}/{}", FrontEndName(front_end), threads), result);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "BenchCommon.hpp"
+#include "logger/AppenderProxy.hpp"
+#include "logger/Logger.h"
+#include "logger/LoggerAppender.h"
+
+#include <filesystem>
+#include <format>
+#include <iostream>
+
+/**
+ * @brief 二进制 appender 与文本 appender 的单条耗时和落盘字节数(默认模式，同一批日志)：
+ *        - text/print      : print() 立即格式化消息，RollingFileAppender 按默认模式写文本
+ *        - binary/print    : print() 立即格式化消息，BinaryFileAppender 写消息文本，其余字段写二进制
+ *        - binary/deferred : printDeferred() 只拷参数，BinaryFileAppender 原样写出参数字节，不做任何格式化
+ *        - logger/deferred : 同上，但经 Logger::log 交给 appender，日志器不渲染(BinaryFileAppender::wantsDeferred)
+ */
+
+namespace {
+
+constexpr size_t c_lines = 500000;
+constexpr auto c_output_file = "bench_binary_appender.log";
+
+auto Report(Bench::JsonReport& report, std::string_view label, uint64_t elapsed) -> void
+{
+    auto bytes = std::filesystem::file_size(c_output_file);
+    std::filesystem::remove(c_output_file);
+    std::cout << std::format("{:<18}{:>10.1f}{:>14.1f}\n", label,
+                             static_cast<double>(elapsed) / c_lines,
+                             static_cast<double>(bytes) / c_lines);
+    report.add(label, {{"ns_per_line", static_cast<double>(elapsed) / c_lines},
+                       {"bytes_per_line", static_cast<double>(bytes) / c_lines}});
+}
+
+template <typename Appender, typename Print>
+auto Run(Bench::JsonReport& report, std::string_view label, Print&& print) -> void
+{
+    std::filesystem::remove(c_output_file);
+    auto formatter = LogFormatter{};
+    auto begin = Bench::NowNs();
+    {
+        auto appender = Appender{c_output_file, 4_gb};
+        for(auto i = size_t{0}; i < c_lines; ++i)
+        {
+            auto event = LogEvent{"bench", LogLevel::INFO, 0, 1, "worker", 1700000000, 0};
+            print(event, i);
+            appender.log(formatter, event);
+        }
+    }
+    Report(report, label, Bench::NowNs() - begin);
+}
+
+template <typename Print>
+auto RunLogger(Bench::JsonReport& report, std::string_view label, Print&& print) -> void
+{
+    std::filesystem::remove(c_output_file);
+    auto begin = Bench::NowNs();
+    {
+        auto logger = Logger{"bench"};
+        logger.addAppender(std::make_shared<AppenderProxy<BinaryFileAppender>>(LogFormatter{}, c_output_file, 4_gb));
+        for(auto i = size_t{0}; i < c_lines; ++i)
+        {
+            auto event = LogEvent{"bench", LogLevel::INFO, 0, 1, "worker", 1700000000, 0};
+            print(event, i);
+            logger.log(event);
+        }
+    }
+    Report(report, label, Bench::NowNs() - begin);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_binary_appender", argc, argv};
+    std::cout << std::format("{:<18}{:>10}{:>14}\n", "path", "ns/line", "bytes/line");
+
+    Run<RollingFileAppender>(report, "text/print", [](LogEvent& event, size_t i){
+        event.print("order {} filled qty={} px={:.4f}", i, 100 + i % 7, 101.25 + static_cast<double>(i % 13));
+    });
+    Run<BinaryFileAppender>(report, "binary/print", [](LogEvent& event, size_t i){
+        event.print("order {} filled qty={} px={:.4f}", i, 100 + i % 7, 101.25 + static_cast<double>(i % 13));
+    });
+    Run<BinaryFileAppender>(report, "binary/deferred", [](LogEvent& event, size_t i){
+        event.printDeferred("order {} filled qty={} px={:.4f}", i, 100 + i % 7, 101.25 + static_cast<double>(i % 13));
+    });
+    RunLogger(report, "logger/deferred", [](LogEvent& event, size_t i){
+        event.printDeferred("order {} filled qty={} px={:.4f}", i, 100 + i % 7, 101.25 + static_cast<double>(i % 13));
+    });
+    return 0;
+}
@@ -0,0 +1,224 @@
+#include "BenchCommon.hpp"
+#include "logger/AsyncLogger.h"
+#include "logger/AppenderProxy.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <format>
+#include <iostream>
+#include <linux/perf_event.h>
+#include <optional>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * @brief 用硬件性能计数器(perf_event_open)统计每条事件的缓存未命中次数：
+ *        - async/<前端>/<线程数> : AsyncLogger + 空 appender，1/8/32/64 个生产者，从第一条 append 到 stop() 写完为止，
+ *                                  统计整个进程(含后台线程)的 cache-misses 和 L1D 读未命中
+ *        - sharing/packed|padded : 生产者计数和消费者计数挨在一起 / 各占一个缓存行，两个线程各自累加，直接看伪共享的代价
+ *        内核不允许访问计数器时(容器、perf_event_paranoid 过高)计数列输出 n/a，只保留耗时
+ */
+
+namespace {
+
+constexpr size_t c_events = 400'000;
+constexpr size_t c_increments = 20'000'000;
+
+auto FrontEndName(AsyncFrontEnd front_end) -> std::string_view
+{
+    switch(front_end)
+    {
+        case AsyncFrontEnd::DoubleBuffer: return "DoubleBuffer";
+        case AsyncFrontEnd::MpscRing:     return "MpscRing";
+        case AsyncFrontEnd::ThreadLocal:  return "ThreadLocal";
+    }
+    return "Unknown";
+}
+
+/** @brief 一个硬件计数器，统计本进程内打开之后创建的所有线程(inherit)，线程退出后计数并入 */
+class PerfCounter{
+public:
+    PerfCounter(uint32_t type, uint64_t config)
+    {
+        auto attr = perf_event_attr{};
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+
+    PerfCounter(const PerfCounter&)            = delete;
+    PerfCounter& operator=(const PerfCounter&) = delete;
+
+    ~PerfCounter()
+    {
+        if(fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+    }
+
+    auto start() -> void
+    {
+        if(fd_ >= 0)
+        {
+            ::ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+            ::ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+
+    // 停止计数并读出，计数器不可用时返回空
+    auto stop() -> std::optional<uint64_t>
+    {
+        if(fd_ < 0)
+        {
+            return std::nullopt;
+        }
+        ::ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        auto value = uint64_t{0};
+        if(::read(fd_, &value, sizeof(value)) != sizeof(value))
+        {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+/** @brief 同时统计 cache-misses(一般是末级缓存)和 L1D 读未命中 */
+struct CacheCounters{
+    PerfCounter llc {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES};
+    PerfCounter l1d {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                                         | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)};
+
+    auto start() -> void
+    {
+        llc.start();
+        l1d.start();
+    }
+};
+
+auto PerEvent(std::optional<uint64_t> count, size_t events) -> double
+{
+    return count ? static_cast<double>(*count) / static_cast<double>(events) : -1.0;
+}
+
+auto FormatCount(double value) -> std::string
+{
+    return value < 0 ? std::string{"n/a"} : std::format("{:.3f}", value);
+}
+
+auto Report(Bench::JsonReport& report, const std::string& label, uint64_t elapsed_ns, size_t events,
+            double llc, double l1d) -> void
+{
+    auto ns = static_cast<double>(elapsed_ns) / static_cast<double>(events);
+    std::cout << std::format("{:<26}{:>12.1f}{:>16}{:>16}\n", label, ns, FormatCount(llc), FormatCount(l1d));
+    report.add(label, {{"ns_per_event", ns}, {"llc_misses_per_event", llc}, {"l1d_misses_per_event", l1d}});
+}
+
+auto RunAsync(Bench::JsonReport& report, AsyncFrontEnd front_end, size_t threads) -> void
+{
+    auto options = AsyncLoggerOptions{.flush_interval = 1, .front_end = front_end};
+    // 不丢事件，每条事件都走完整条流水线
+    options.overflow.policy = OverflowPolicy::Block;
+    options.overflow.block_timeout = std::chrono::seconds{10};
+
+    auto counters = CacheCounters{};
+    auto logger = std::make_shared<AsyncLogger>(options);
+    logger->addAppender(std::make_shared<AppenderProxy<Bench::NullAppender>>());
+
+    // 后台线程在计数器打开之后创建，才能被 inherit 统计到
+    counters.start();
+    auto begin = Bench::NowNs();
+    logger->start();
+    auto workers = std::vector<std::thread>{};
+    for(auto t = size_t{0}; t < threads; ++t)
+    {
+        workers.emplace_back([&logger, threads, t]{
+            for(auto i = size_t{0}; i < c_events / threads; ++i)
+            {
+                logger->append(LogEvent{"bench", LogLevel::INFO, 0, static_cast<uint32_t>(t), "bench", 0, 0});
+            }
+        });
+    }
+    for(auto& worker : workers)
+    {
+        worker.join();
+    }
+    logger->stop();
+    auto elapsed = Bench::NowNs() - begin;
+    auto llc = counters.llc.stop();
+    auto l1d = counters.l1d.stop();
+
+    auto events = (c_events / threads) * threads;
+    Report(report, std::format("async/{}/{}", FrontEndName(front_end), threads), elapsed, events,
+           PerEvent(llc, events), PerEvent(l1d, events));
+}
+
+// 生产者计数和消费者计数紧挨着，落在同一个缓存行
+struct PackedCounters{
+    std::atomic<uint64_t> produced {0};
+    std::atomic<uint64_t> consumed {0};
+};
+
+// 各占一个缓存行，AsyncLogger 现在的成员布局就是这样分组的
+struct PaddedCounters{
+    alignas(c_k_cache_line) std::atomic<uint64_t> produced {0};
+    alignas(c_k_cache_line) std::atomic<uint64_t> consumed {0};
+};
+
+template <typename Counters>
+auto RunSharing(Bench::JsonReport& report, std::string_view label) -> void
+{
+    auto counters = CacheCounters{};
+    auto shared = Counters{};
+    counters.start();
+    auto begin = Bench::NowNs();
+    auto producer = std::thread{[&shared]{
+        for(auto i = size_t{0}; i < c_increments; ++i)
+        {
+            shared.produced.fetch_add(1, std::memory_order_relaxed);
+        }
+    }};
+    auto consumer = std::thread{[&shared]{
+        for(auto i = size_t{0}; i < c_increments; ++i)
+        {
+            shared.consumed.fetch_add(1, std::memory_order_relaxed);
+        }
+    }};
+    producer.join();
+    consumer.join();
+    auto elapsed = Bench::NowNs() - begin;
+    auto llc = counters.llc.stop();
+    auto l1d = counters.l1d.stop();
+    Report(report, std::format("sharing/{}", label), elapsed, 2 * c_increments,
+           PerEvent(llc, 2 * c_increments), PerEvent(l1d, 2 * c_increments));
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_cache_misses", argc, argv};
+    std::cout << std::format("hardware threads: {}\n", std::thread::hardware_concurrency());
+    std::cout << std::format("{:<26}{:>12}{:>16}{:>16}\n", "case", "ns/event", "llc-miss/event", "l1d-miss/event");
+    for(auto front_end : {AsyncFrontEnd::DoubleBuffer, AsyncFrontEnd::MpscRing, AsyncFrontEnd::ThreadLocal})
+    {
+        for(auto threads : {size_t{1}, size_t{8}, size_t{32}, size_t{64}})
+        {
+            RunAsync(report, front_end, threads);
+        }
+    }
+    RunSharing<PackedCounters>(report, "packed");
+    RunSharing<PaddedCounters>(report, "padded");
+    return 0;
+}
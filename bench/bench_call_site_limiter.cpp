@@ -0,0 +1,67 @@
+#include "BenchCommon.hpp"
+#include "common/LogMacros.h"
+#include "logger/AppenderProxy.hpp"
+#include "logger/CallSiteLimiter.h"
+
+#include <format>
+#include <iostream>
+
+/**
+ * @brief 调用点限流的开销(ns/次)：
+ *        - check/xxx : 单独调用 CallSiteLimiter::check()，allowed 是令牌充足时的放行路径，
+ *                      denied 是令牌耗尽时的拒绝路径，sample 是 1-in-100 采样
+ *        - macro/xxx : 同一调用点洪水式打 WARN，unlimited 每条都构造事件并交给不写任何东西的 appender，
+ *                      rate/every_n 是限流宏，绝大部分调用在 check() 之后就返回
+ */
+
+namespace {
+
+constexpr size_t c_iterations = 10'000'000;
+
+volatile uint64_t g_sink = 0;
+
+class NullAppender{
+public:
+    static void log(const LogFormatter&, const LogEvent& event) { g_sink = g_sink + event.getLine(); }
+};
+
+template <typename Func>
+auto Measure(Bench::JsonReport& report, std::string_view label, Func&& func) -> void
+{
+    auto begin = Bench::NowNs();
+    for(auto i = size_t{0}; i < c_iterations; ++i)
+    {
+        func(i);
+    }
+    auto ns = static_cast<double>(Bench::NowNs() - begin) / c_iterations;
+    std::cout << std::format("{:<20}{:>12.2f}\n", label, ns);
+    report.add(label, {{"ns_per_call", ns}});
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_call_site_limiter", argc, argv};
+    std::cout << std::format("{:<20}{:>12}\n", "path", "ns/call");
+
+    auto allowed = CallSiteLimiter{RateLimit{.per_second = 1'000'000'000, .burst = 1'000'000}};
+    Measure(report, "check/allowed", [&allowed](size_t){ g_sink = allowed.check().allowed_; });
+    auto denied = CallSiteLimiter{RateLimit{.per_second = 1, .burst = 1}};
+    Measure(report, "check/denied", [&denied](size_t){ g_sink = denied.check().allowed_; });
+    auto sampler = CallSiteLimiter{RateLimit{.one_in = 100}};
+    Measure(report, "check/sample", [&sampler](size_t){ g_sink = sampler.check().allowed_; });
+
+    auto logger = std::make_shared<Logger>("bench");
+    logger->addAppender(std::make_shared<AppenderProxy<NullAppender>>());
+    Measure(report, "macro/unlimited", [&logger](size_t i){
+        COTTON_LOG_WARN(logger, "upstream {} timed out after {}ms", i, 250);
+    });
+    Measure(report, "macro/rate", [&logger](size_t i){
+        COTTON_LOG_RATE(logger, LogLevel::WARN, 100, 10, "upstream {} timed out after {}ms", i, 250);
+    });
+    Measure(report, "macro/every_n", [&logger](size_t i){
+        COTTON_LOG_EVERY_N(logger, LogLevel::WARN, 1000, "upstream {} timed out after {}ms", i, 250);
+    });
+    return 0;
+}
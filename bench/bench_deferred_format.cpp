@@ -0,0 +1,62 @@
+#include "BenchCommon.hpp"
+#include "logger/LogEvent.h"
+
+#include <format>
+#include <iostream>
+
+/**
+ * @brief 调用方线程上 print() 与 printDeferred() 的开销对比
+ *        每次采样 = 构造事件 + 写入消息，不含 appender；另外统计后台线程 rendered() 的开销
+ */
+
+namespace {
+
+constexpr size_t c_samples = 200000;
+
+template <typename Func>
+auto Measure(Func&& func) -> Bench::Percentiles
+{
+    auto samples = std::vector<uint64_t>{};
+    samples.reserve(c_samples);
+    for(auto i = size_t{0}; i < c_samples; ++i)
+    {
+        auto begin = Bench::NowNs();
+        func(i);
+        samples.push_back(Bench::NowNs() - begin);
+    }
+    return Bench::ComputePercentiles(samples);
+}
+
+auto Report(Bench::JsonReport& report, std::string_view label, const Bench::Percentiles& result) -> void
+{
+    report.add(label, result);
+    std::cout << std::format("{:<18}{:>10}{:>10}{:>10}{:>12}\n", label, result.p50, result.p99, result.p999, result.max);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_deferred_format", argc, argv};
+    std::cout << std::format("{:<18}{:>10}{:>10}{:>10}{:>12}\n", "mode", "p50(ns)", "p99(ns)", "p999(ns)", "max(ns)");
+
+    Report(report, "eager print", Measure([](size_t i){
+        auto event = LogEvent{"bench", LogLevel::INFO, 0, 1, "worker", 0, 0};
+        event.print("order {} filled qty={} px={:.4f} latency={}us", i, 100 + i % 7, 101.25 + static_cast<double>(i % 13), i % 97);
+        return event.getLevel();
+    }));
+
+    Report(report, "deferred capture", Measure([](size_t i){
+        auto event = LogEvent{"bench", LogLevel::INFO, 0, 1, "worker", 0, 0};
+        event.printDeferred("order {} filled qty={} px={:.4f} latency={}us", i, 100 + i % 7, 101.25 + static_cast<double>(i % 13), i % 97);
+        return event.getLevel();
+    }));
+
+    // 后台线程的代价：把延迟参数格式化成最终文本
+    auto event = LogEvent{"bench", LogLevel::INFO, 0, 1, "worker", 0, 0};
+    event.printDeferred("order {} filled qty={} px={:.4f} latency={}us", size_t{42}, 105, 107.25, 13);
+    Report(report, "deferred render", Measure([&event](size_t){
+        return event.rendered().getContent().size();
+    }));
+    return 0;
+}
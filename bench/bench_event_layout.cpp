@@ -0,0 +1,93 @@
+#include "BenchCommon.hpp"
+#include "logger/EventFixedBuffer.hpp"
+#include "logger/LogEvent.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <format>
+#include <iostream>
+#include <new>
+
+/**
+ * @brief LogEvent 布局测试：sizeof(LogEvent)、构造 EventFixedBuffer 的分配次数、
+ *        以及每条日志(构造事件 + print + 移入缓冲)的堆分配次数
+ */
+
+namespace {
+    std::atomic<size_t> g_alloc_count = 0;
+}
+
+// 替换全局 operator new，统计堆分配次数
+auto operator new(std::size_t size) -> void*
+{
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    if(auto* p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+constexpr size_t c_lines = 100000;
+
+// 统计 func 执行期间的分配次数
+template <typename Func>
+auto CountAllocs(Func&& func) -> size_t
+{
+    auto before = g_alloc_count.load();
+    func();
+    return g_alloc_count.load() - before;
+}
+
+auto AllocsPerLine(Bench::JsonReport& report, std::string_view label, size_t repeat) -> void
+{
+    auto buffer = std::make_unique<EventFixedBuffer<>>();
+    // 先热身一轮，让内存池等一次性初始化不计入结果
+    for(auto i = size_t{0}; i < c_k_event_count; ++i)
+    {
+        auto event = LogEvent{"bench", LogLevel::INFO, 0, 1, "worker", 0, 0};
+        event.print("{}", std::string(repeat, 'x'));
+        buffer->append(std::move(event));
+    }
+    buffer->reset();
+
+    auto allocs = CountAllocs([&buffer, repeat]{
+        auto payload = std::string(repeat, 'x');
+        for(auto i = size_t{0}; i < c_lines; ++i)
+        {
+            if(buffer->available() == 0)
+            {
+                buffer->reset();
+            }
+            auto event = LogEvent{"bench", LogLevel::INFO, 0, 1, "worker", 0, 0};
+            event.print("user {} request {}", i, std::string_view{payload});
+            buffer->append(std::move(event));
+        }
+    });
+    std::cout << std::format("allocs per line ({:<14}): {:.2f}\n", label, static_cast<double>(allocs) / c_lines);
+    report.add(label, {{"allocs_per_line", static_cast<double>(allocs) / c_lines}});
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_event_layout", argc, argv};
+    std::cout << std::format("sizeof(LogEvent)                   : {} bytes\n", sizeof(LogEvent));
+    std::cout << std::format("sizeof(EventFixedBuffer<64>)       : {} bytes\n", sizeof(EventFixedBuffer<>));
+
+    auto buffer_allocs = CountAllocs([]{ auto buffer = std::make_unique<EventFixedBuffer<>>(); });
+    std::cout << std::format("allocs to construct EventFixedBuffer<64>: {}\n", buffer_allocs);
+    report.add("layout", {{"sizeof_log_event", static_cast<double>(sizeof(LogEvent))},
+                          {"sizeof_event_buffer", static_cast<double>(sizeof(EventFixedBuffer<>))},
+                          {"allocs_to_construct_buffer", static_cast<double>(buffer_allocs)}});
+
+    AllocsPerLine(report, "short message", 8);
+    AllocsPerLine(report, "long message", 1024);
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "BenchCommon.hpp"
+#include "logger/EventFixedBuffer.hpp"
+#include "logger/LoggerAppender.h"
+
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+
+/**
+ * @brief 文件 appender 吞吐量(本地磁盘，MB/s 与 lines/s)：
+ *        - ofstream/event : 上一版 RollingFileAppender 的写法，每条格式化后写进 std::ofstream
+ *        - fd/event       : RollingFileAppender::log(event)，按 flush 策略攒够再 writev
+ *        - fd/batch       : RollingFileAppender::log(span)，每批 64 条一次 writev(AsyncLogger 后台线程的用法)
+ *        - mmap/event     : MmapFileAppender::log(event)，直接拷进映射区
+ *        - mmap/batch     : MmapFileAppender::log(span)
+ */
+
+namespace {
+
+constexpr size_t c_lines = 1000000;
+constexpr auto c_output_file = "bench_file_appender.log";
+
+// 复刻上一版的逐条写 ofstream
+class OfstreamAppender{
+public:
+    explicit OfstreamAppender(const std::string& filename)
+        : stream_{filename, std::ios::out | std::ios::app | std::ios::binary} {}
+
+    void log(const LogFormatter& fmter, const LogEvent& event)
+    {
+        auto _ = std::lock_guard{mutex_};
+        buffer_.clear();
+        fmter.format(buffer_, event);
+        stream_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    }
+
+private:
+    std::mutex mutex_;
+    std::ofstream stream_;
+    LogBuffer buffer_;
+};
+
+struct Result{
+    double seconds = 0;
+    uint64_t bytes = 0;
+};
+
+template <typename Func>
+auto Run(Func&& func) -> Result
+{
+    std::filesystem::remove(c_output_file);
+    auto begin = Bench::NowNs();
+    func();
+    auto elapsed = Bench::NowNs() - begin;
+    auto result = Result{static_cast<double>(elapsed) / 1e9, std::filesystem::file_size(c_output_file)};
+    std::filesystem::remove(c_output_file);
+    return result;
+}
+
+auto Report(Bench::JsonReport& report, std::string_view label, const Result& result) -> void
+{
+    report.add(label, {{"mb_per_s", static_cast<double>(result.bytes) / (1024.0 * 1024.0) / result.seconds},
+                       {"lines_per_s", static_cast<double>(c_lines) / result.seconds}});
+    std::cout << std::format("{:<16}{:>12.1f}{:>16.0f}\n", label,
+                             static_cast<double>(result.bytes) / (1024.0 * 1024.0) / result.seconds,
+                             static_cast<double>(c_lines) / result.seconds);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_file_appender", argc, argv};
+    auto formatter = LogFormatter{};
+    // 一整块缓冲的事件反复使用，只测格式化 + 写文件
+    auto batch = std::make_unique<EventFixedBuffer<>>();
+    for(auto i = size_t{0}; i < c_k_event_count; ++i)
+    {
+        auto event = LogEvent{"bench", LogLevel::INFO, 0, static_cast<uint32_t>(i), "worker", 1700000000, 0};
+        event.print("order {} filled qty={} px={:.4f}", i, 100 + i % 7, 101.25 + static_cast<double>(i % 13));
+        batch->append(std::move(event));
+    }
+    auto events = batch->getEventSpan();
+
+    std::cout << std::format("{:<16}{:>12}{:>16}\n", "path", "MB/s", "lines/s");
+
+    Report(report, "ofstream/event", Run([&]{
+        auto appender = OfstreamAppender{c_output_file};
+        for(auto i = size_t{0}; i < c_lines; ++i)
+        {
+            appender.log(formatter, events[i % events.size()]);
+        }
+    }));
+
+    Report(report, "fd/event", Run([&]{
+        auto appender = RollingFileAppender{c_output_file, 4_gb};
+        for(auto i = size_t{0}; i < c_lines; ++i)
+        {
+            appender.log(formatter, events[i % events.size()]);
+        }
+    }));
+
+    Report(report, "fd/batch", Run([&]{
+        auto appender = RollingFileAppender{c_output_file, 4_gb};
+        for(auto i = size_t{0}; i < c_lines; i += events.size())
+        {
+            appender.log(formatter, events);
+        }
+    }));
+
+    Report(report, "mmap/event", Run([&]{
+        auto appender = MmapFileAppender{c_output_file, 4_gb};
+        for(auto i = size_t{0}; i < c_lines; ++i)
+        {
+            appender.log(formatter, events[i % events.size()]);
+        }
+    }));
+
+    Report(report, "mmap/batch", Run([&]{
+        auto appender = MmapFileAppender{c_output_file, 4_gb};
+        for(auto i = size_t{0}; i < c_lines; i += events.size())
+        {
+            appender.log(formatter, events);
+        }
+    }));
+    return 0;
+}
@@ -0,0 +1,128 @@
+#include "BenchCommon.hpp"
+#include "logger/LogFormatter.h"
+#include "logger/StaticLogFormatter.hpp"
+
+#include <format>
+#include <iostream>
+#include <filesystem>
+#include <fstream>
+
+/**
+ * @brief 三种格式器写入 std::ofstream 的单行耗时(默认模式，以及去掉 %d 的模式，后者不被 localtime/strftime 掩盖)：
+ *        - legacy  : 原来的 vector<shared_ptr<Facade>> + 虚函数调用，每个 Item 直接写流并调用两次 tellp()
+ *        - variant : LogFormatter 编译后的 variant 数组，整行写入 LogBuffer 后对流 write 一次
+ *        - static  : StaticLogFormatter 编译期展开，同样整行 write 一次
+ */
+
+namespace {
+
+constexpr size_t c_lines = 500000;
+
+// 复刻原来的 PatternItemFacade / PatternItemProxy
+class LegacyItemFacade{
+public:
+    virtual auto format(std::ostream& os, const LogEvent& event) -> size_t = 0;
+    virtual ~LegacyItemFacade() = default;
+};
+
+template <typename ItemImpl>
+class LegacyItemProxy : public LegacyItemFacade{
+public:
+    explicit LegacyItemProxy(ItemImpl item) : item_{std::move(item)} {}
+    auto format(std::ostream& os, const LogEvent& event) -> size_t override
+    {
+        std::streampos start = os.tellp();
+        buffer_.clear();
+        item_.format(buffer_, event);
+        os.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        return static_cast<size_t>(os.tellp() - start);
+    }
+private:
+    ItemImpl item_;
+    LogBuffer buffer_;
+};
+
+class LegacyFormatter{
+public:
+    explicit LegacyFormatter(const LogFormatter& formatter)
+    {
+        for(const auto& item : formatter.getItems())
+        {
+            items_.push_back(std::visit([](const auto& impl) -> Sptr<LegacyItemFacade> {
+                return std::make_shared<LegacyItemProxy<std::remove_cvref_t<decltype(impl)>>>(impl);
+            }, item));
+        }
+    }
+
+    auto format(std::ostream& os, const LogEvent& event) const -> size_t
+    {
+        auto total_size = size_t{0};
+        std::ranges::for_each(items_, [&os, &event, &total_size](const Sptr<LegacyItemFacade> item){
+            total_size += item->format(os, event);
+        });
+        return total_size;
+    }
+
+private:
+    std::vector<Sptr<LegacyItemFacade>> items_;
+};
+
+constexpr auto c_output_file = "bench_formatter.out";
+
+template <typename Formatter>
+auto NsPerLine(const Formatter& formatter, const LogEvent& event) -> double
+{
+    auto os = std::ofstream{c_output_file, std::ios::out | std::ios::trunc | std::ios::binary};
+    auto total = size_t{0};
+    auto begin = Bench::NowNs();
+    for(auto i = size_t{0}; i < c_lines; ++i)
+    {
+        total += formatter.format(os, event);
+    }
+    os.flush();
+    auto elapsed = Bench::NowNs() - begin;
+    if(total == 0)
+    {
+        std::cout << "unexpected empty output\n";
+    }
+    return static_cast<double>(elapsed) / c_lines;
+}
+
+// 同一模式分别用三种格式器各跑一遍
+template <FixedString Pattern>
+auto RunPattern(Bench::JsonReport& report, std::string_view name, const LogEvent& event) -> void
+{
+    auto runtime = LogFormatter{std::string{Pattern.view()}};
+    auto legacy = LegacyFormatter{runtime};
+    auto compiled = StaticLogFormatter<Pattern>{};
+
+    std::cout << std::format("pattern: {}\n", Pattern.view());
+    std::cout << std::format("{:<10}{:>12}\n", "formatter", "ns/line");
+    auto legacy_ns = NsPerLine(legacy, event);
+    auto variant_ns = NsPerLine(runtime, event);
+    auto static_ns = NsPerLine(compiled, event);
+    std::cout << std::format("{:<10}{:>12.1f}\n", "legacy", legacy_ns);
+    std::cout << std::format("{:<10}{:>12.1f}\n", "variant", variant_ns);
+    std::cout << std::format("{:<10}{:>12.1f}\n", "static", static_ns);
+    report.add(std::format("{}/legacy", name), {{"ns_per_line", legacy_ns}});
+    report.add(std::format("{}/variant", name), {{"ns_per_line", variant_ns}});
+    report.add(std::format("{}/static", name), {{"ns_per_line", static_ns}});
+}
+
+constexpr char c_millis_pattern[] = "%d{%Y-%m-%d %H:%M:%S.%L} [%p]%T[%c]%T%m%n";
+constexpr char c_no_date_pattern[] = "[%rms] %t%T%N%T%F%T[%p]%T[%c]%T[%f:%l]%T[%v]%T%m%n";
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_formatter", argc, argv};
+    auto event = LogEvent{"bench", LogLevel::INFO, 12, 4242, "worker", 1700000000, 7};
+    event.print("user {} logged in from {}", 1234, "10.0.0.1");
+
+    RunPattern<c_k_default_pattern>(report, "default", event);
+    RunPattern<c_millis_pattern>(report, "millis", event);
+    RunPattern<c_no_date_pattern>(report, "no_date", event);
+    std::filesystem::remove(c_output_file);
+    return 0;
+}
@@ -0,0 +1,84 @@
+#include "BenchCommon.hpp"
+#include "common/LogMacros.h"
+#include "logger/Logger.h"
+
+#include <format>
+#include <iostream>
+
+/**
+ * @brief 被级别关掉的日志调用的开销(ns/次)：
+ *        - eager    : 上一版 log() 的做法，先构造事件、格式化参数，交给 Logger::log 时才判断级别
+ *        - runtime  : COTTON_LOG_DEBUG，运行期级别判断不通过，参数不求值
+ *        - compile  : COTTON_MIN_LOG_LEVEL=3 之后展开的 COTTON_LOG_DEBUG，整段被 if constexpr 丢弃
+ *        最后一列是每次调用里参数表达式被求值的次数
+ */
+
+namespace {
+
+constexpr size_t c_calls = 10'000'000;
+
+// 每次求值都有副作用，编译器不能把它省掉
+inline size_t g_evaluated = 0;
+
+auto Expensive() -> size_t
+{
+    return ++g_evaluated;
+}
+
+// 复刻上一版：先取时间、构造事件、格式化，最后由 Logger::log 丢弃
+auto EagerDebug(const Logger& logger) -> void
+{
+    auto event = LogEvent{logger.getLoggerNameId(), LogLevel::DEBUG, 0, 0, LogNameRegistry::Intern("MainThread"),
+                          std::chrono::system_clock::to_time_t(std::chrono::system_clock::now()), 0};
+    event.print("order {} filled qty={}", Expensive(), 100);
+    logger.log(event);
+}
+
+auto RuntimeDebug(const Sptr<Logger>& logger) -> void
+{
+    COTTON_LOG_DEBUG(logger, "order {} filled qty={}", Expensive(), 100);
+}
+
+template <typename Fn>
+auto Measure(Bench::JsonReport& report, std::string_view label, Fn&& fn) -> void
+{
+    g_evaluated = 0;
+    auto begin = Bench::NowNs();
+    for(auto i = size_t{0}; i < c_calls; ++i)
+    {
+        fn();
+    }
+    auto elapsed = Bench::NowNs() - begin;
+    std::cout << std::format("{:<10}{:>12.2f}{:>12.2f}\n", label,
+                             static_cast<double>(elapsed) / c_calls, static_cast<double>(g_evaluated) / c_calls);
+    report.add(label, {{"ns_per_call", static_cast<double>(elapsed) / c_calls},
+                       {"evals_per_call", static_cast<double>(g_evaluated) / c_calls}});
+}
+
+} // namespace
+
+// 之后展开的日志宏按新的下限裁剪，DEBUG(2) 低于 3
+#undef COTTON_MIN_LOG_LEVEL
+#define COTTON_MIN_LOG_LEVEL 3
+
+namespace {
+
+auto CompiledOutDebug(const Sptr<Logger>& logger) -> void
+{
+    COTTON_LOG_DEBUG(logger, "order {} filled qty={}", Expensive(), 100);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_log_macros", argc, argv};
+    auto logger = std::make_shared<Logger>("bench");
+    logger->setLogLevel(LogLevel::INFO);
+
+    std::cout << std::format("{:<10}{:>12}{:>12}\n", "disabled", "ns/call", "evals/call");
+    Measure(report, "eager", [&]{ EagerDebug(*logger); });
+    Measure(report, "runtime", [&]{ RuntimeDebug(logger); });
+    Measure(report, "compile", [&]{ CompiledOutDebug(logger); });
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "BenchCommon.hpp"
+#include "logger/Logger.h"
+#include "logger/LogManager.h"
+
+#include <format>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+/**
+ * @brief 按名称查找已存在的日志器(ns/次)：
+ *        - mutex    : 上一版的 getLogger，加锁 + 每次构造临时 std::string 查 unordered_map
+ *        - lockfree : LoggerManager，字面量的哈希编译期算好，无锁查表
+ *        两者都要复制返回的 shared_ptr，这部分开销相同
+ *        线程数大于 1 时上一版的锁在各核之间争抢，只有一个核时这部分差别看不出来
+ */
+
+namespace {
+
+constexpr size_t c_lookups = 2'000'000;
+
+// 复刻上一版 LoggerManager::getLogger 的查找路径
+class MutexRegistry{
+public:
+    auto getLogger(std::string_view logger_name) -> Sptr<Logger>
+    {
+        auto _ = std::lock_guard<std::mutex>{mtx_};
+        if(auto it = loggers_.find(std::string(logger_name)); it != loggers_.end())
+            return it->second;
+        auto logger = std::make_shared<Logger>(std::string{logger_name});
+        loggers_.emplace(logger_name, logger);
+        return logger;
+    }
+
+private:
+    std::mutex mtx_;
+    std::unordered_map<std::string, Sptr<Logger>> loggers_;
+};
+
+template <typename Lookup>
+auto Measure(Bench::JsonReport& report, std::string_view label, size_t threads, Lookup&& lookup) -> void
+{
+    auto workers = std::vector<std::thread>{};
+    auto begin = Bench::NowNs();
+    for(auto t = size_t{0}; t < threads; ++t)
+    {
+        workers.emplace_back([&]{
+            for(auto i = size_t{0}; i < c_lookups / threads; ++i)
+            {
+                lookup();
+            }
+        });
+    }
+    for(auto& worker : workers)
+    {
+        worker.join();
+    }
+    auto elapsed = Bench::NowNs() - begin;
+    std::cout << std::format("{:<10}{:>8}{:>12.2f}\n", label, threads, static_cast<double>(elapsed) / c_lookups);
+    report.add(std::format("{}/{}", label, threads), {{"ns_per_lookup", static_cast<double>(elapsed) / c_lookups}});
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_logger_registry", argc, argv};
+    auto old_registry = MutexRegistry{};
+    auto manager = LoggerManager{};
+    // 名称超过 std::string 的短字符串优化长度，上一版每次查找都要分配
+    old_registry.getLogger("service.order.matching.engine");
+    manager.getLogger("service.order.matching.engine");
+
+    std::cout << std::format("{:<10}{:>8}{:>12}\n", "lookup", "threads", "ns/lookup");
+    for(auto threads : {size_t{1}, size_t{4}})
+    {
+        Measure(report, "mutex", threads, [&]{ old_registry.getLogger("service.order.matching.engine"); });
+        Measure(report, "lockfree", threads, [&]{ manager.getLogger("service.order.matching.engine"); });
+    }
+    return 0;
+}
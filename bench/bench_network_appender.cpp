@@ -0,0 +1,187 @@
+#include "BenchCommon.hpp"
+#include "logger/EventFixedBuffer.hpp"
+#include "logger/LoggerAppender.h"
+#include "logger/NetworkAppender.h"
+
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+/**
+ * @brief 直接发给本机收集端 vs 先写文件(sidecar 再读回去)：
+ *        - file/batch         : RollingFileAppender::log(span)，现在 sidecar 读取的那份文件
+ *        - tcp|unix|udp/text  : NetworkAppender::log(span)，收集端是同进程里只读不处理的线程
+ *        - unix/binary        : 同上，发 BinaryLogFormat 的块
+ *        计时到 appender 析构(积压的全部交给内核)为止；events/send 是每次 send/sendmsg 带走的事件数，
+ *        dropped 是超过 in-flight 上限被丢弃的事件数
+ */
+
+namespace {
+
+constexpr size_t c_lines = 1000000;
+constexpr auto c_output_file = "bench_network_appender.log";
+constexpr auto c_socket = "bench_network_appender.sock";
+
+struct Result{
+    double seconds = 0;
+    uint64_t bytes = 0;
+    NetworkAppenderStats stats;
+};
+
+auto Report(Bench::JsonReport& report, std::string_view label, const Result& result) -> void
+{
+    auto mb_per_s = static_cast<double>(result.bytes) / (1024.0 * 1024.0) / result.seconds;
+    auto lines_per_s = static_cast<double>(c_lines) / result.seconds;
+    auto per_send = result.stats.send_calls == 0
+        ? 0.0 : static_cast<double>(result.stats.sent_events) / static_cast<double>(result.stats.send_calls);
+    report.add(label, {{"mb_per_s", mb_per_s}, {"lines_per_s", lines_per_s}, {"events_per_send", per_send},
+                       {"dropped", static_cast<double>(result.stats.dropped_events)}});
+    std::cout << std::format("{:<16}{:>12.1f}{:>16.0f}{:>14.1f}{:>10}\n", label, mb_per_s, lines_per_s, per_send,
+                             result.stats.dropped_events);
+}
+
+// 收集端：接受一个连接(UDP 直接收)，读到对端关闭或 1 秒没有数据为止，统计收到的字节数
+class Collector{
+public:
+    Collector(int family, int type)
+    {
+        fd_ = ::socket(family, type | SOCK_CLOEXEC, 0);
+        if(family == AF_UNIX)
+        {
+            std::filesystem::remove(c_socket);
+            auto addr = sockaddr_un{};
+            addr.sun_family = AF_UNIX;
+            std::strcpy(addr.sun_path, c_socket);
+            ::bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+            address_ = std::string{"unix://"} + c_socket;
+        }
+        else
+        {
+            auto addr = sockaddr_in{};
+            addr.sin_family = AF_INET;
+            addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+            auto len = socklen_t{sizeof(addr)};
+            ::bind(fd_, reinterpret_cast<sockaddr*>(&addr), len);
+            ::getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+            address_ = std::format("{}://127.0.0.1:{}", type == SOCK_STREAM ? "tcp" : "udp", ntohs(addr.sin_port));
+            // 给 UDP 留足接收缓冲，少丢一些数据报
+            auto size = static_cast<int>(8_mb);
+            ::setsockopt(fd_, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+        }
+        auto timeout = timeval{.tv_sec = 1, .tv_usec = 0};
+        ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        if(type == SOCK_STREAM)
+        {
+            ::listen(fd_, 4);
+        }
+        thread_ = std::thread{[this, type]{ run_(type); }};
+    }
+
+    ~Collector()
+    {
+        ::close(fd_);
+        std::filesystem::remove(c_socket);
+    }
+
+    [[nodiscard]] auto address() const -> const std::string& { return address_; }
+
+    auto join() -> uint64_t
+    {
+        thread_.join();
+        return received_;
+    }
+
+private:
+    auto run_(int type) -> void
+    {
+        auto conn = type == SOCK_STREAM ? ::accept(fd_, nullptr, nullptr) : fd_;
+        auto buf = std::vector<char>(64_kb);
+        for(;;)
+        {
+            auto n = ::recv(conn, buf.data(), buf.size(), 0);
+            if(n <= 0)
+            {
+                break;
+            }
+            received_ += static_cast<uint64_t>(n);
+        }
+        if(conn != fd_)
+        {
+            ::close(conn);
+        }
+    }
+
+    int fd_ = -1;
+    std::string address_;
+    std::thread thread_;
+    uint64_t received_ = 0;
+};
+
+auto RunNetwork(const LogFormatter& formatter, std::span<const LogEvent> events,
+                int family, int type, NetworkPayload payload) -> Result
+{
+    auto collector = Collector{family, type};
+    auto result = Result{};
+    auto begin = Bench::NowNs();
+    {
+        auto appender = NetworkAppender{NetworkAppenderOptions{
+            .address = collector.address(),
+            .payload = payload,
+            .max_in_flight_bytes = 64_mb,
+        }};
+        for(auto i = size_t{0}; i < c_lines; i += events.size())
+        {
+            appender.log(formatter, events);
+        }
+        appender.waitIdle(std::chrono::seconds{30});
+        result.stats = appender.getStats();
+    }
+    result.seconds = static_cast<double>(Bench::NowNs() - begin) / 1e9;
+    result.bytes = collector.join();
+    return result;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_network_appender", argc, argv};
+    auto formatter = LogFormatter{};
+    auto batch = std::make_unique<EventFixedBuffer<>>();
+    for(auto i = size_t{0}; i < c_k_event_count; ++i)
+    {
+        auto event = LogEvent{"bench", LogLevel::INFO, 0, static_cast<uint32_t>(i), "worker", 1700000000, 0};
+        event.print("order {} filled qty={} px={:.4f}", i, 100 + i % 7, 101.25 + static_cast<double>(i % 13));
+        batch->append(std::move(event));
+    }
+    auto events = batch->getEventSpan();
+
+    std::cout << std::format("{:<16}{:>12}{:>16}{:>14}{:>10}\n", "path", "MB/s", "lines/s", "events/send", "dropped");
+
+    {
+        std::filesystem::remove(c_output_file);
+        auto begin = Bench::NowNs();
+        {
+            auto appender = RollingFileAppender{c_output_file, 4_gb};
+            for(auto i = size_t{0}; i < c_lines; i += events.size())
+            {
+                appender.log(formatter, events);
+            }
+        }
+        auto result = Result{static_cast<double>(Bench::NowNs() - begin) / 1e9, std::filesystem::file_size(c_output_file), {}};
+        std::filesystem::remove(c_output_file);
+        Report(report, "file/batch", result);
+    }
+
+    Report(report, "tcp/text", RunNetwork(formatter, events, AF_INET, SOCK_STREAM, NetworkPayload::Text));
+    Report(report, "unix/text", RunNetwork(formatter, events, AF_UNIX, SOCK_STREAM, NetworkPayload::Text));
+    Report(report, "unix/binary", RunNetwork(formatter, events, AF_UNIX, SOCK_STREAM, NetworkPayload::Binary));
+    Report(report, "udp/text", RunNetwork(formatter, events, AF_INET, SOCK_DGRAM, NetworkPayload::Text));
+    return 0;
+}
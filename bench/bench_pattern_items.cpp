@@ -0,0 +1,80 @@
+#include "BenchCommon.hpp"
+#include "logger/LogFormatter.h"
+
+#include <array>
+#include <format>
+#include <iostream>
+
+/**
+ * @brief PatternItemImpl.cpp 里每种模式项单独的格式化开销(ns/次)
+ *        每个模式只含一项，格式化进一个反复清空的 LogBuffer，不含写文件；
+ *        %d 同一秒内走缓存，date/uncached 每次换一秒，测的是 strftime 本身
+ */
+
+namespace {
+
+constexpr size_t c_iterations = 2'000'000;
+
+struct ItemCase{
+    std::string_view name_;
+    std::string_view pattern_;
+};
+
+constexpr auto c_cases = std::to_array<ItemCase>({
+    {"message",     "%m"},
+    {"level",       "%p"},
+    {"elapse",      "%r"},
+    {"logger_name", "%c"},
+    {"thread_id",   "%t"},
+    {"fiber_id",    "%F"},
+    {"thread_name", "%N"},
+    {"newline",     "%n"},
+    {"filename",    "%f"},
+    {"line",        "%l"},
+    {"function",    "%v"},
+    {"tab",         "%T"},
+    {"percent",     "%%"},
+    {"string",      "[literal]"},
+    {"date",        "%d{%Y-%m-%d %H:%M:%S}"},
+    {"date_millis", "%d{%Y-%m-%d %H:%M:%S.%L}"},
+});
+
+auto NsPerFormat(const LogFormatter& formatter, LogEvent& event, bool new_second) -> double
+{
+    auto buffer = LogBuffer{};
+    auto begin = Bench::NowNs();
+    for(auto i = size_t{0}; i < c_iterations; ++i)
+    {
+        if(new_second)
+        {
+            event.setTimePoint(std::chrono::system_clock::time_point{std::chrono::seconds{1700000000 + i}});
+        }
+        buffer.clear();
+        formatter.format(buffer, event);
+    }
+    auto elapsed = Bench::NowNs() - begin;
+    return static_cast<double>(elapsed) / c_iterations;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_pattern_items", argc, argv};
+    auto event = LogEvent{"bench", LogLevel::INFO, 12, 4242, "worker", 1700000000, 7};
+    event.setTimePoint(std::chrono::system_clock::time_point{std::chrono::seconds{1700000000}});
+    event.print("user {} logged in from {}", 1234, "10.0.0.1");
+
+    std::cout << std::format("{:<16}{:<28}{:>10}\n", "item", "pattern", "ns/item");
+    auto run = [&](std::string_view name, std::string_view pattern, bool new_second){
+        auto ns = NsPerFormat(LogFormatter{std::string{pattern}}, event, new_second);
+        std::cout << std::format("{:<16}{:<28}{:>10.2f}\n", name, pattern, ns);
+        report.add(name, {{"ns_per_item", ns}});
+    };
+    for(const auto& item : c_cases)
+    {
+        run(item.name_, item.pattern_, false);
+    }
+    run("date/uncached", "%d{%Y-%m-%d %H:%M:%S}", true);
+    return 0;
+}
@@ -0,0 +1,129 @@
+#include "BenchCommon.hpp"
+#include "logger/LoggerAppender.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief 频繁滚动时单次 log() 的延迟(每 256 KiB 滚动一次)：
+ *        - sync       : 上一版的滚动方式，写日志的线程自己 close + rename + open
+ *        - background : RollingFileAppender，只换一个预先打开的 fd，其余交给 RotationWorker
+ *        - background+gz : 同上，旧文件在后台压缩，只保留 4 个
+ *        后台线程需要一个空闲的核，只有一个核时它和写日志的线程抢同一个 CPU，尾延迟看不出差别
+ */
+
+namespace {
+
+constexpr size_t c_lines = 200000;
+constexpr size_t c_roll_bytes = 256 * 1024;
+constexpr auto c_dir = "bench_rotation";
+
+// 复刻上一版 rollFile_：写完缓冲后在调用线程上关闭、重命名、重新打开
+class SyncRollAppender{
+public:
+    explicit SyncRollAppender(std::string filename) : filename_{std::move(filename)} { open_(); }
+    ~SyncRollAppender()
+    {
+        flush_();
+        ::close(fd_);
+    }
+
+    void log(const LogFormatter& fmter, const LogEvent& event)
+    {
+        if(offset_ > c_roll_bytes)
+        {
+            flush_();
+            ::close(fd_);
+            auto rotated = std::format("{}.{}", filename_, ++seq_);
+            std::rename(filename_.c_str(), rotated.c_str());
+            open_();
+        }
+        offset_ += fmter.format(buffer_, event);
+        if(buffer_.size() >= 64 * 1024)
+        {
+            flush_();
+        }
+    }
+
+private:
+    auto open_() -> void
+    {
+        fd_ = ::open(filename_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        offset_ = 0;
+    }
+
+    auto flush_() -> void
+    {
+        if(::write(fd_, buffer_.data(), buffer_.size()) < 0)
+        {
+            std::cerr << "write failed\n";
+        }
+        buffer_.clear();
+    }
+
+    std::string filename_;
+    int fd_ = -1;
+    size_t offset_ = 0;
+    size_t seq_ = 0;
+    LogBuffer buffer_;
+};
+
+template <typename Appender>
+auto Measure(Appender& appender, const LogFormatter& formatter, const LogEvent& event) -> Bench::Percentiles
+{
+    auto samples = std::vector<uint64_t>{};
+    samples.reserve(c_lines);
+    for(auto i = size_t{0}; i < c_lines; ++i)
+    {
+        auto begin = Bench::NowNs();
+        appender.log(formatter, event);
+        samples.push_back(Bench::NowNs() - begin);
+    }
+    return Bench::ComputePercentiles(samples);
+}
+
+auto Report(Bench::JsonReport& report, std::string_view label, const Bench::Percentiles& p) -> void
+{
+    report.add(label, p);
+    std::cout << std::format("{:<16}{:>10}{:>10}{:>10}{:>12}\n", label, p.p50, p.p99, p.p999, p.max);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_rotation", argc, argv};
+    auto formatter = LogFormatter{};
+    auto event = LogEvent{"bench", LogLevel::INFO, 0, 1, "worker", 1700000000, 0};
+    event.print("order {} filled qty={} px={:.4f}", 42, 100, 101.25);
+    auto file = std::string{c_dir} + "/rotation.log";
+
+    std::cout << std::format("{:<16}{:>10}{:>10}{:>10}{:>12}\n", "rotation", "p50(ns)", "p99", "p999", "max");
+
+    std::filesystem::remove_all(c_dir);
+    std::filesystem::create_directory(c_dir);
+    {
+        auto appender = SyncRollAppender{file};
+        Report(report, "sync", Measure(appender, formatter, event));
+    }
+
+    std::filesystem::remove_all(c_dir);
+    std::filesystem::create_directory(c_dir);
+    {
+        auto appender = RollingFileAppender{file, c_roll_bytes};
+        Report(report, "background", Measure(appender, formatter, event));
+    }
+
+    std::filesystem::remove_all(c_dir);
+    std::filesystem::create_directory(c_dir);
+    {
+        auto appender = RollingFileAppender{file, c_roll_bytes, Seconds{60 * 60}, RotationPolicy{.compress_ = true, .max_files_ = 4}};
+        Report(report, "background+gz", Measure(appender, formatter, event));
+    }
+    std::filesystem::remove_all(c_dir);
+    return 0;
+}
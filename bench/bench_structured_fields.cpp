@@ -0,0 +1,75 @@
+#include "BenchCommon.hpp"
+#include "logger/LogFormatter.h"
+
+#include <format>
+#include <iostream>
+
+/**
+ * @brief 结构化字段在调用方线程和格式化线程上的开销：
+ *        - inline text     : 键值对直接拼进消息 "user_id=... px=..."，调用方 std::format
+ *        - with() capture  : 消息只有固定文本，键值对用 with() 按原始字节附加
+ *        - json/logfmt     : 格式化线程把带字段的事件输出成 JSON(c_k_json_pattern)/logfmt 行
+ */
+
+namespace {
+
+constexpr size_t c_samples = 200000;
+
+template <typename Func>
+auto Measure(Func&& func) -> Bench::Percentiles
+{
+    auto samples = std::vector<uint64_t>{};
+    samples.reserve(c_samples);
+    for(auto i = size_t{0}; i < c_samples; ++i)
+    {
+        auto begin = Bench::NowNs();
+        func(i);
+        samples.push_back(Bench::NowNs() - begin);
+    }
+    return Bench::ComputePercentiles(samples);
+}
+
+auto Report(Bench::JsonReport& report, std::string_view label, const Bench::Percentiles& result) -> void
+{
+    report.add(label, result);
+    std::cout << std::format("{:<18}{:>10}{:>10}{:>10}{:>12}\n", label, result.p50, result.p99, result.p999, result.max);
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_structured_fields", argc, argv};
+    std::cout << std::format("{:<18}{:>10}{:>10}{:>10}{:>12}\n", "mode", "p50(ns)", "p99(ns)", "p999(ns)", "max(ns)");
+
+    Report(report, "inline text", Measure([](size_t i){
+        auto event = LogEvent{"bench", LogLevel::INFO, 0, 1, "worker", 0, 0};
+        event.print("order filled user_id={} qty={} px={:.4f} ok={}", i, 100 + i % 7, 101.25 + static_cast<double>(i % 13), true);
+        return event.getLevel();
+    }));
+
+    Report(report, "with() capture", Measure([](size_t i){
+        auto event = LogEvent{"bench", LogLevel::INFO, 0, 1, "worker", 0, 0};
+        event.print("order filled");
+        event.with("user_id", i).with("qty", 100 + i % 7).with("px", 101.25 + static_cast<double>(i % 13)).with("ok", true);
+        return event.getLevel();
+    }));
+
+    auto event = LogEvent{"bench", LogLevel::INFO, 0, 1, "worker", 1700000000, 0};
+    event.print("order \"filled\"");
+    event.with("user_id", size_t{42}).with("qty", 105).with("px", 107.25).with("ok", true).with("route", "/api/v1/orders");
+    auto json = LogFormatter{c_k_json_pattern};
+    auto logfmt = LogFormatter{c_k_logfmt_pattern};
+    auto buf = LogBuffer{};
+    Report(report, "json render", Measure([&](size_t){
+        buf.clear();
+        json.format(buf, event);
+        return buf.size();
+    }));
+    Report(report, "logfmt render", Measure([&](size_t){
+        buf.clear();
+        logfmt.format(buf, event);
+        return buf.size();
+    }));
+    return 0;
+}
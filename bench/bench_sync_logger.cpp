@@ -0,0 +1,65 @@
+#include "BenchCommon.hpp"
+#include "common/LogMacros.h"
+#include "logger/Logger.h"
+#include "logger/LoggerAppender.h"
+
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <thread>
+
+/**
+ * @brief 同步 Logger 写文件的端到端吞吐量(默认模式，RollingFileAppender)：
+ *        调用线程上完成 日志宏 → 构造事件 → 格式化 → 写文件，统计 lines/s 与 MB/s
+ */
+
+namespace {
+
+constexpr size_t c_lines = 1'000'000;
+constexpr auto c_output_file = "bench_sync_logger.log";
+
+auto Run(Bench::JsonReport& report, size_t threads) -> void
+{
+    std::filesystem::remove(c_output_file);
+    // 计时包含 logger 析构，也就是把 appender 缓冲里剩下的写进文件
+    auto begin = Bench::NowNs();
+    {
+        auto logger = std::make_shared<Logger>("bench");
+        logger->addAppender(std::make_shared<AppenderProxy<RollingFileAppender>>(LogFormatter{}, c_output_file, 4_gb));
+
+        auto workers = std::vector<std::thread>{};
+        for(auto t = size_t{0}; t < threads; ++t)
+        {
+            workers.emplace_back([&logger, threads]{
+                for(auto i = size_t{0}; i < c_lines / threads; ++i)
+                {
+                    COTTON_LOG_INFO(logger, "order {} filled qty={} px={:.4f}", i, 100 + i % 7, 101.25 + static_cast<double>(i % 13));
+                }
+            });
+        }
+        for(auto& worker : workers)
+        {
+            worker.join();
+        }
+    }
+    auto elapsed = Bench::NowNs() - begin;
+    auto seconds = static_cast<double>(elapsed) / 1e9;
+    auto megabytes = static_cast<double>(std::filesystem::file_size(c_output_file)) / (1024.0 * 1024.0);
+    std::filesystem::remove(c_output_file);
+
+    std::cout << std::format("{:<10}{:>12.1f}{:>16.0f}\n", threads, megabytes / seconds, c_lines / seconds);
+    report.add(std::format("threads/{}", threads), {{"mb_per_s", megabytes / seconds}, {"lines_per_s", c_lines / seconds}});
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_sync_logger", argc, argv};
+    std::cout << std::format("{:<10}{:>12}{:>16}\n", "threads", "MB/s", "lines/s");
+    for(auto threads : {size_t{1}, size_t{4}})
+    {
+        Run(report, threads);
+    }
+    return 0;
+}
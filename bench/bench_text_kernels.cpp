@@ -0,0 +1,126 @@
+#include "BenchCommon.hpp"
+#include "logger/LogBuffer.hpp"
+#include "logger/TextKernels.h"
+
+#include <charconv>
+#include <format>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+/**
+ * @brief TextKernels 各内核与原来写法的对比(ns/次)：
+ *        - escape/<长度>  : 在不含需要转义字节的消息里找第一个要转义的字节，scalar/sse2/avx2 逐一对比
+ *        - copy/<长度>    : 把字面量或消息体追加进缓冲；ostream 是原来 `os << str` 的写法，
+ *                           string 是改动前 LogBuffer 的 std::string::append，logbuffer 是现在的 CopyBytes
+ *        - int/<位数>     : %l、%t、%r 的整数输出；ostream 是 `os << n`，to_chars 是改动前的 to_chars + append
+ */
+
+namespace {
+
+constexpr size_t c_iterations = 5'000'000;
+
+// 防止编译器把循环体优化掉
+volatile size_t g_sink = 0;
+
+template <typename Func>
+auto Measure(Bench::JsonReport& report, std::string_view group, std::string_view label, Func&& func) -> void
+{
+    auto begin = Bench::NowNs();
+    for(auto i = size_t{0}; i < c_iterations; ++i)
+    {
+        func(i);
+    }
+    auto ns = static_cast<double>(Bench::NowNs() - begin) / c_iterations;
+    std::cout << std::format("{:<14}{:<12}{:>10.2f}\n", group, label, ns);
+    report.add(std::format("{}/{}", group, label), {{"ns_per_call", ns}});
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_text_kernels", argc, argv};
+    std::cout << std::format("best isa: {}\n", TextKernels::IsaName(TextKernels::BestIsa()));
+    std::cout << std::format("{:<14}{:<12}{:>10}\n", "kernel", "impl", "ns/call");
+
+    for(auto length : {size_t{16}, size_t{64}, size_t{256}, size_t{4096}})
+    {
+        auto text = std::string(length, 'x');
+        auto group = std::format("escape/{}", length);
+        for(auto isa : {TextKernels::Isa::Scalar, TextKernels::Isa::Sse2, TextKernels::Isa::Avx2})
+        {
+            Measure(report, group, TextKernels::IsaName(isa), [&text, isa](size_t){
+                g_sink = TextKernels::FindJsonEscape(text, isa);
+            });
+        }
+    }
+
+    for(auto length : {size_t{3}, size_t{11}, size_t{27}, size_t{120}})
+    {
+        auto text = std::string(length, 'm');
+        auto group = std::format("copy/{}", length);
+        auto os = std::ostringstream{};
+        Measure(report, group, "ostream", [&os, &text](size_t i){
+            if(i % 64 == 0)
+            {
+                os.str({});
+            }
+            os << text;
+        });
+        auto string = std::string{};
+        string.reserve(LogBuffer::c_k_initial_capacity * 64);
+        Measure(report, group, "string", [&string, &text](size_t i){
+            if(i % 64 == 0)
+            {
+                string.clear();
+            }
+            string.append(text);
+            g_sink = string.size();
+        });
+        auto buf = LogBuffer{};
+        Measure(report, group, "logbuffer", [&buf, &text](size_t i){
+            if(i % 64 == 0)
+            {
+                buf.clear();
+            }
+            buf.append(text);
+            g_sink = buf.size();
+        });
+    }
+
+    for(auto value : {uint32_t{42}, uint32_t{4242}, uint32_t{1234567}, uint32_t{4000000000}})
+    {
+        auto group = std::format("int/{}", TextKernels::DecimalDigits(value));
+        auto os = std::ostringstream{};
+        Measure(report, group, "ostream", [&os, value](size_t i){
+            if(i % 64 == 0)
+            {
+                os.str({});
+            }
+            os << value + static_cast<uint32_t>(i & 1);
+        });
+        auto string = std::string{};
+        string.reserve(LogBuffer::c_k_initial_capacity * 4);
+        Measure(report, group, "to_chars", [&string, value](size_t i){
+            if(i % 64 == 0)
+            {
+                string.clear();
+            }
+            char digits[24];
+            auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value + static_cast<uint32_t>(i & 1));
+            string.append(digits, end);
+            g_sink = string.size();
+        });
+        auto buf = LogBuffer{};
+        Measure(report, group, "logbuffer", [&buf, value](size_t i){
+            if(i % 64 == 0)
+            {
+                buf.clear();
+            }
+            buf.appendInt(value + static_cast<uint32_t>(i & 1));
+            g_sink = buf.size();
+        });
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+#include "BenchCommon.hpp"
+#include "logger/Logger.h"
+#include "logger/ThreadContext.h"
+
+#include <format>
+#include <functional>
+#include <iostream>
+#include <thread>
+
+/**
+ * @brief 填写 LogEvent 身份字段(线程号、线程名、协程号)的开销：
+ *        - hash    : 原来的做法，每次 std::hash(std::this_thread::get_id())，线程名写死
+ *        - context : ThreadContext 的线程局部缓存
+ *        以及整条 MakeLogEvent(含取时间)的耗时
+ */
+
+namespace {
+
+constexpr size_t c_iterations = 10'000'000;
+
+// 防止编译器把循环体优化掉
+volatile uint32_t g_sink = 0;
+
+template <typename Func>
+auto Measure(Bench::JsonReport& report, std::string_view label, Func&& func) -> void
+{
+    auto begin = Bench::NowNs();
+    for(auto i = size_t{0}; i < c_iterations; ++i)
+    {
+        func();
+    }
+    auto ns = static_cast<double>(Bench::NowNs() - begin) / c_iterations;
+    std::cout << std::format("{:<20}{:>12.2f}\n", label, ns);
+    report.add(label, {{"ns_per_call", ns}});
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    auto report = Bench::JsonReport{"bench_thread_context", argc, argv};
+    auto logger = std::make_shared<Logger>("bench");
+    ThreadContext::SetName("bench-main");
+
+    std::cout << std::format("{:<20}{:>12}\n", "identity", "ns/call");
+    Measure(report, "hash", []{
+        static const auto s_thread_name = LogNameRegistry::Intern("MainThread");
+        g_sink = static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) + s_thread_name;
+    });
+    Measure(report, "context", []{
+        g_sink = ThreadContext::GetTid() + ThreadContext::GetNameId() + ThreadContext::GetFiberId();
+    });
+    Measure(report, "MakeLogEvent", [&logger]{
+        auto event = MakeLogEvent(*logger, LogLevel::INFO, std::source_location::current());
+        g_sink = event.getThreadId();
+    });
+    return 0;
+}
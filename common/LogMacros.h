@@ -1,10 +1,115 @@
-#pragma
+#pragma once
 
+#include "logger/CallSiteLimiter.h"
 #include "logger/Logger.h"
 #include "logger/LogLevel.h"
 #include <format>
+#include <source_location>
+#include <utility>
 
+/**
+ * @brief 日志宏：COTTON_LOG_DEBUG(logger, "user {} logged in", id) 等
+ * @details - 编译期：级别低于 COTTON_MIN_LOG_LEVEL(LogLevel 的数值，默认 1 即 ALL)的调用被 if constexpr 整段丢弃，
+ *            参数不求值、也不生成代码。例如 -DCOTTON_MIN_LOG_LEVEL=3 去掉所有 DEBUG
+ *          - 运行期：先调用 logger->isLevelEnable(一次 relaxed 原子读 + 一次比较)，通过后才求值参数、构造 LogEvent，
+ *            被关掉的调用不会执行参数里的任何表达式
+ *          - logger 可以是 Logger/AsyncLogger 的指针或智能指针，AsyncLogger 走 append() 入队，其余走 log()
+ *          - 格式串必须是字面量，参数能延迟格式化时只拷贝参数(见 LogEvent::printDeferred)
+ *          - 每个宏展开成一条完整语句，可以放在不带花括号的 if/else 里
+ *          - 限流版本(COTTON_LOG_LIMITED/EVERY_N/RATE)在每个调用点放一个静态的 CallSiteLimiter，
+ *            级别判断通过后再查限流，被挡掉的调用同样不求值参数；隔一段时间在同一调用点补一条
+ *            "suppressed N similar messages"(带 suppressed 字段)
+ */
+#ifndef COTTON_MIN_LOG_LEVEL
+#define COTTON_MIN_LOG_LEVEL 1
+#endif
 
-#define LOG_LEVEL(logger, level) \
-    if(logger->getLevel() <= level) \
-        LogEventWrap(Sptr(new LogEvent("Root", level, 0, (), "Thread Name", time(0))))
\ No newline at end of file
+namespace LogMacro {
+
+    /**
+     * @brief 构造事件并交给 logger
+     * @details 不内联到调用点：调用点只剩级别判断和一次函数调用，关掉的日志不占指令缓存
+     */
+    template <typename LoggerPtr, typename... Args>
+    [[gnu::noinline]] auto Emit(const LoggerPtr& logger, LogLevel level, std::source_location source_loc,
+                                std::format_string<Args...> fmt, Args&&... args) -> void
+    {
+        auto event = MakeLogEvent(*logger, level, source_loc);
+        event.printDeferred(fmt, std::forward<Args>(args)...);
+        if constexpr (requires { logger->append(std::move(event)); })
+        {
+            logger->append(std::move(event));
+        }
+        else
+        {
+            logger->log(event);
+        }
+    }
+
+    // 限流汇总：同一调用点、同一级别，消息里和 suppressed 字段里都是被挡掉的条数
+    template <typename LoggerPtr>
+    [[gnu::noinline]] auto EmitSuppressed(const LoggerPtr& logger, LogLevel level, std::source_location source_loc,
+                                          uint64_t suppressed) -> void
+    {
+        auto event = MakeLogEvent(*logger, level, source_loc);
+        event.print("suppressed {} similar messages", suppressed);
+        event.with("suppressed", suppressed);
+        if constexpr (requires { logger->append(std::move(event)); })
+        {
+            logger->append(std::move(event));
+        }
+        else
+        {
+            logger->log(event);
+        }
+    }
+
+} // namespace LogMacro
+
+#define COTTON_LOG_LEVEL(logger, level, fmt, ...)                                                           \
+    do {                                                                                                    \
+        if constexpr ((level) >= static_cast<LogLevel>(COTTON_MIN_LOG_LEVEL))                               \
+        {                                                                                                   \
+            if(const auto& cotton_logger_ = (logger); cotton_logger_->isLevelEnable(level))                 \
+            {                                                                                               \
+                LogMacro::Emit(cotton_logger_, level, std::source_location::current(), fmt __VA_OPT__(,) __VA_ARGS__); \
+            }                                                                                               \
+        }                                                                                                   \
+    } while(0)
+
+#define COTTON_LOG_DEBUG(logger, fmt, ...) COTTON_LOG_LEVEL(logger, LogLevel::DEBUG, fmt __VA_OPT__(,) __VA_ARGS__)
+#define COTTON_LOG_INFO(logger, fmt, ...)  COTTON_LOG_LEVEL(logger, LogLevel::INFO,  fmt __VA_OPT__(,) __VA_ARGS__)
+#define COTTON_LOG_TRACE(logger, fmt, ...) COTTON_LOG_LEVEL(logger, LogLevel::TRACE, fmt __VA_OPT__(,) __VA_ARGS__)
+#define COTTON_LOG_WARN(logger, fmt, ...)  COTTON_LOG_LEVEL(logger, LogLevel::WARN,  fmt __VA_OPT__(,) __VA_ARGS__)
+#define COTTON_LOG_ERROR(logger, fmt, ...) COTTON_LOG_LEVEL(logger, LogLevel::ERROR, fmt __VA_OPT__(,) __VA_ARGS__)
+#define COTTON_LOG_FATAL(logger, fmt, ...) COTTON_LOG_LEVEL(logger, LogLevel::FATAL, fmt __VA_OPT__(,) __VA_ARGS__)
+
+// limit 是一个 RateLimit 表达式，含逗号时加括号：COTTON_LOG_LIMITED(logger, LogLevel::WARN, (RateLimit{.per_second = 10, .burst = 20}), ...)
+#define COTTON_LOG_LIMITED(logger, level, limit, fmt, ...)                                                  \
+    do {                                                                                                    \
+        if constexpr ((level) >= static_cast<LogLevel>(COTTON_MIN_LOG_LEVEL))                               \
+        {                                                                                                   \
+            if(const auto& cotton_logger_ = (logger); cotton_logger_->isLevelEnable(level))                 \
+            {                                                                                               \
+                static CallSiteLimiter cotton_limiter_{limit};                                              \
+                const auto cotton_decision_ = cotton_limiter_.check();                                      \
+                if(cotton_decision_.suppressed_ != 0)                                                       \
+                {                                                                                           \
+                    LogMacro::EmitSuppressed(cotton_logger_, level, std::source_location::current(),        \
+                                             cotton_decision_.suppressed_);                                 \
+                }                                                                                           \
+                if(cotton_decision_.allowed_)                                                               \
+                {                                                                                           \
+                    LogMacro::Emit(cotton_logger_, level, std::source_location::current(), fmt __VA_OPT__(,) __VA_ARGS__); \
+                }                                                                                           \
+            }                                                                                               \
+        }                                                                                                   \
+    } while(0)
+
+// 每 n 次调用输出 1 次
+#define COTTON_LOG_EVERY_N(logger, level, n, fmt, ...) \
+    COTTON_LOG_LIMITED(logger, level, (RateLimit{.one_in = (n)}), fmt __VA_OPT__(,) __VA_ARGS__)
+
+// 令牌桶：平均每秒最多 rate 条，允许一次突发 burst_size 条
+#define COTTON_LOG_RATE(logger, level, rate, burst_size, fmt, ...) \
+    COTTON_LOG_LIMITED(logger, level, (RateLimit{.per_second = (rate), .burst = (burst_size)}), fmt __VA_OPT__(,) __VA_ARGS__)
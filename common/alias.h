@@ -3,6 +3,7 @@
 #include <chrono>
 #include <cstddef>  // for size_t
 #include <memory>
+#include <vector>
 
 /*========================标准库别名========================*/
 template <typename T>
@@ -18,6 +19,12 @@ template <typename T, typename Alloctor = std::allocator<T>>
 using list = std::vector<T, Alloctor>;
 
 
+/*========================缓存行========================*/
+// 分隔生产者/消费者热点数据的对齐值，取 std::hardware_destructive_interference_size 在 x86-64 上的值。
+// 标准库的那个常量随编译器版本和 -mtune 变化，用在头文件里的布局上会让不同编译单元看到不同的布局，所以固定下来
+inline constexpr size_t c_k_cache_line = 64;
+
+
 /*========================时间别名========================*/
 using Clock = std::chrono::steady_clock;
 
@@ -1,6 +1,9 @@
 #pragma once
 
-class LogEvent;
+#include "LogEvent.h"
+#include "LogMetrics.h"
+#include <span>
+#include <string_view>
 
 /* Abstract base class for appenders */
 
@@ -13,5 +16,21 @@ public:
     AppenderFacade(const AppenderFacade&) = default;
     AppenderFacade(AppenderFacade&&) = default;
     virtual void log(const LogEvent& event) = 0;
+    // 批量接口：AsyncLogger 的后台线程一次交一整块缓冲，默认逐条转发
+    virtual void log(std::span<const LogEvent> events)
+    {
+        for(const auto& event : events)
+        {
+            log(event);
+        }
+    }
+    // 指标里显示的名字
+    [[nodiscard]] virtual auto getName() const -> std::string_view { return "appender"; }
+    // 滚动次数和耗时，不滚动的 appender 返回空快照
+    [[nodiscard]] virtual auto getRotationStats() const -> Histogram::Snapshot { return {}; }
+    // 滚动时没拿到后台预先打开的文件、在写日志的线程上同步打开的次数
+    [[nodiscard]] virtual auto getRotationFallbacks() const -> uint64_t { return 0; }
+    // 是否直接接收延迟格式化(printDeferred)的事件：返回 true 时日志器把原始参数原样交给它，不先调用 std::format 渲染
+    [[nodiscard]] virtual auto wantsDeferred() const -> bool { return false; }
     virtual ~AppenderFacade() = default;
 };
\ No newline at end of file
@@ -2,6 +2,9 @@
 
 #include "AppenderFacade.h"
 #include "LogFormatter.h"
+#include "common/util.hpp"
+
+#include <span>
 
 class LogFormatter;
 class LogEvent;
@@ -11,6 +14,12 @@ concept IsAppenderImpl = requires(T x, LogFormatter y, LogEvent z) {
     x.log(y, z);
 };
 
+// 具体 appender 可以额外提供 log(formatter, span) 批量接口，一次处理一整批事件
+template<typename T>
+concept IsBatchAppenderImpl = requires(T x, LogFormatter y, std::span<const LogEvent> z) {
+    x.log(y, z);
+};
+
 /**
  * @brief thread-safe, actually a proxy of the concrete appender
  */
@@ -36,6 +45,10 @@ public:
         return formatter_;
     }
 
+    // 具体 appender，读它自己的统计之类的接口(比如 NetworkAppender::getStats)
+    [[nodiscard]] auto GetImpl() -> Impl& { return impl_; }
+    [[nodiscard]] auto GetImpl() const -> const Impl& { return impl_; }
+
     auto SetFormatterPattern(LogFormatter formatter) -> void
     {
         formatter_ = std::move(formatter);
@@ -46,6 +59,62 @@ public:
         impl_.log(formatter_, event);
     }
 
+    void log(std::span<const LogEvent> events) override
+    {
+        if constexpr (IsBatchAppenderImpl<Impl>)
+        {
+            impl_.log(formatter_, events);
+        }
+        else
+        {
+            for(const auto& event : events)
+            {
+                impl_.log(formatter_, event);
+            }
+        }
+    }
+
+    [[nodiscard]] auto getName() const -> std::string_view override
+    {
+        return UtilT::GetTypename<Impl>();
+    }
+
+    [[nodiscard]] auto getRotationStats() const -> Histogram::Snapshot override
+    {
+        if constexpr (requires(const Impl& impl) { impl.getRotationStats(); })
+        {
+            return impl_.getRotationStats();
+        }
+        else
+        {
+            return {};
+        }
+    }
+
+    [[nodiscard]] auto getRotationFallbacks() const -> uint64_t override
+    {
+        if constexpr (requires(const Impl& impl) { impl.getRotationFallbacks(); })
+        {
+            return impl_.getRotationFallbacks();
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    [[nodiscard]] auto wantsDeferred() const -> bool override
+    {
+        if constexpr (requires(const Impl& impl) { impl.wantsDeferred(); })
+        {
+            return impl_.wantsDeferred();
+        }
+        else
+        {
+            return false;
+        }
+    }
+
     ~AppenderProxy() override = default;
 
 private:
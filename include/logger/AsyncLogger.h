@@ -1,31 +1,174 @@
 #pragma once
 
 #include "EventFixedBuffer.hpp"
+#include "EventBufferPool.hpp"
+#include "MpscRingQueue.hpp"
 #include "logger/Logger.h"
+#include "logger/LogFormatter.h"
+#include "logger/LogMetrics.h"
+#include "logger/AppenderFacade.h"
 #include "common/alias.h"
 #include <algorithm>
 #include <vector>
 #include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <map>
 #include "common/util.hpp"
 #include <latch>
 
+/**
+ * @brief 应用线程写入 AsyncLogger 的前端实现
+ * - DoubleBuffer : 互斥锁 + 双缓冲（默认）
+ * - MpscRing     : 有界无锁多生产者/单消费者环形队列，后台线程批量取出
+ * - ThreadLocal  : 每个生产者线程先写自己的暂存缓冲，写满(或超时老化)后整块交给后台线程，
+ *                  共享锁每 c_k_event_count 个事件才拿一次
+ */
+enum class AsyncFrontEnd
+{
+    DoubleBuffer,
+    MpscRing,
+    ThreadLocal
+};
+
+/**
+ * @brief 待写缓冲达到上限(生产速度远超消费速度)时的处理策略
+ * - Block          : 生产者等待后台线程腾出空间，超过 block_timeout 仍没有空间则丢弃
+ * - DropNewest     : 丢弃新来的事件（默认，与原来的行为一致）
+ * - DropOldest     : 丢弃最旧的一整块待写缓冲，给新事件腾位置
+ * - DropBelowLevel : 只丢弃低于 keep_level 的事件，keep_level 及以上的事件无视上限照样入队；
+ *                    MpscRing 前端的环形队列容量固定，高级别事件最多等 block_timeout，仍没有槽位则丢弃
+ * - SpillToFile    : 把放不下的事件直接同步写入本地溢出文件
+ */
+enum class OverflowPolicy
+{
+    Block,
+    DropNewest,
+    DropOldest,
+    DropBelowLevel,
+    SpillToFile
+};
+
+struct OverflowOptions
+{
+    OverflowPolicy policy = OverflowPolicy::DropNewest;
+    size_t max_pending_buffers = 25;                       // buffers_to_write_ 的上限
+    std::chrono::milliseconds block_timeout {100};         // Block 策略(以及 MpscRing 下 DropBelowLevel 的高级别事件)的最长等待时间
+    LogLevel keep_level = LogLevel::ERROR;                 // DropBelowLevel 策略保留的最低级别
+    std::string spill_filename = "async_overflow.log";     // SpillToFile 策略的溢出文件
+};
+
+/**
+ * @brief 事件缓冲池：写满交出去、写完回收的缓冲都在池里周转，稳定运行(包括突发)时不再为缓冲分配内存
+ * @details 突发期间同时在用的缓冲最多约 max_pending_buffers + 4 块(当前、备用、后台线程的两块预留)，
+ *          capacity 不小于这个数时突发过后缓冲全部回到池里，下一次突发不再分配；每块缓冲约 12KB
+ */
+struct BufferPoolOptions
+{
+    size_t capacity = 32;                                  // 池中最多保留的空闲缓冲数(向上取到 2 的幂)
+    size_t prewarm = 8;                                    // 构造时预先分配的缓冲数
+};
+
+struct AsyncLoggerOptions
+{
+    int flush_interval = 3;                                // 强制刷新间隔（秒）
+    AsyncFrontEnd front_end = AsyncFrontEnd::DoubleBuffer;
+    OverflowOptions overflow {};
+    BufferPoolOptions buffer_pool {};
+    size_t consumer_threads = 1;                           // 大于 1 时并行消费：后台线程只分发，另起这么多格式化线程并行做延迟格式化，每个 appender 再由各自的写线程按序写入
+    Sptr<Logger> metrics_logger = nullptr;                 // 非空时后台线程定期把 getMetrics() 写成一条 INFO 日志
+    std::chrono::seconds metrics_interval {60};            // 输出间隔；后台线程至少每 flush_interval 醒一次，间隔不会比它更短
+};
+
+/**
+ * @brief 各溢出策略的计数快照(单位：事件数)，供监控读取
+ */
+struct OverflowStats
+{
+    uint64_t dropped_newest = 0;          // DropNewest 丢弃（MpscRing 下的 DropOldest 也记在这里）
+    uint64_t dropped_oldest = 0;          // DropOldest 丢弃
+    uint64_t dropped_below_level = 0;     // DropBelowLevel 丢弃
+    uint64_t dropped_block_timeout = 0;   // Block 等待超时后丢弃（MpscRing 下 DropBelowLevel 的高级别事件等待超时也记在这里）
+    uint64_t spilled = 0;                 // SpillToFile 写入溢出文件（没有丢失）
+};
+
+/**
+ * @brief AsyncLogger 的运行指标快照，用于监控丢日志和背压
+ * @details 事件守恒：enqueued ≈ written + filtered + dropped.dropped_oldest + 还在队列里的事件，
+ *          DropNewest/DropBelowLevel/Block 超时/溢写的事件没有进入队列，不计入 enqueued
+ */
+struct AsyncLoggerMetrics
+{
+    uint64_t enqueued = 0;              // 进入队列的事件数；ThreadLocal 前端在暂存缓冲交给后台时才计入
+    uint64_t written = 0;               // 已交给 appender 的事件数
+    uint64_t filtered = 0;              // 后台线程写入前因低于 logger 级别而丢弃的事件数
+    OverflowStats dropped {};           // 按溢出策略丢弃(或溢写)的事件数
+    size_t pending_buffers = 0;         // 等待后台线程写入的缓冲块数(DoubleBuffer / ThreadLocal)
+    size_t ring_depth = 0;              // 环形队列里等待消费的事件数(MpscRing，近似值)
+    uint64_t buffer_swaps = 0;          // 后台线程接管待写缓冲的次数
+    size_t in_flight_batches = 0;       // 并行消费时已分发、还没被所有 appender 写完的批数
+    size_t format_threads = 0;          // 正在运行的格式化线程数，并行消费时等于 consumer_threads，否则为 0
+    size_t buffers_allocated = 0;       // 缓冲池为空时新分配的缓冲块数(含预热)，稳定运行后不再增长
+    Histogram::Snapshot batch_size;     // 每批交给 appender 的事件数
+    std::vector<AppenderMetrics> appenders;
+
+    [[nodiscard]] auto totalDropped() const -> uint64_t
+    {
+        return dropped.dropped_newest + dropped.dropped_oldest + dropped.dropped_below_level + dropped.dropped_block_timeout;
+    }
+};
+
+// 把指标格式化成一行文本，metrics_logger 输出的就是它
+inline auto FormatMetrics(const AsyncLoggerMetrics& metrics) -> std::string
+{
+    auto text = std::format("enqueued={} written={} filtered={} dropped={} (newest={} oldest={} below_level={} block_timeout={}) "
+                            "spilled={} pending_buffers={} ring_depth={} in_flight={}",
+                            metrics.enqueued, metrics.written, metrics.filtered, metrics.totalDropped(),
+                            metrics.dropped.dropped_newest, metrics.dropped.dropped_oldest,
+                            metrics.dropped.dropped_below_level, metrics.dropped.dropped_block_timeout,
+                            metrics.dropped.spilled, metrics.pending_buffers, metrics.ring_depth, metrics.in_flight_batches);
+    text += std::format(" format_threads={} swaps={} buffers_allocated={} batch(avg={:.1f} max={})",
+                        metrics.format_threads, metrics.buffer_swaps, metrics.buffers_allocated,
+                        metrics.batch_size.mean(), metrics.batch_size.max);
+    for(const auto& appender : metrics.appenders)
+    {
+        text += std::format(" [{}] writes={} p50={}ns p99={}ns max={}ns rotations={} rotation_max={}ns rotation_fallbacks={}",
+                            appender.name, appender.write_latency_ns.count,
+                            appender.write_latency_ns.percentile(0.5), appender.write_latency_ns.percentile(0.99),
+                            appender.write_latency_ns.max, appender.rotation_ns.count, appender.rotation_ns.max,
+                            appender.rotation_fallbacks);
+    }
+    return text;
+}
+
 class AsyncLogger : public Logger {
 public:
     // 也可以写成 using EventBuffer    = EventFixedBuffer<>; 因为模板设置了默认值
     using EventBuffer    = EventFixedBuffer<c_k_event_count>;
     // 同一时刻只准一个进程写入Buffer
     using EventBufferPtr = std::unique_ptr<EventBuffer>;
+    using EventRing      = MpscRingQueue<LogEvent>;
 
 public:
     // 构造函数：初始化缓冲区和日志文件，启动日志线程
-    explicit AsyncLogger(int flush_interval = 3) // 3秒刷新一次
-        : flush_interval_ {flush_interval}
+    explicit AsyncLogger(int flush_interval = 3, AsyncFrontEnd front_end = AsyncFrontEnd::DoubleBuffer) // 3秒刷新一次
+        : AsyncLogger(AsyncLoggerOptions{.flush_interval = flush_interval, .front_end = front_end}) {}
+
+    explicit AsyncLogger(AsyncLoggerOptions options)
+        : flush_interval_ {options.flush_interval}
+        , front_end_ {options.front_end}
+        , overflow_ {std::move(options.overflow)}
+        , metrics_logger_ {std::move(options.metrics_logger)}
+        , metrics_interval_ {options.metrics_interval}
+        , consumer_threads_ {std::max<size_t>(options.consumer_threads, 1)}
         , running_(false)
-        , current_buffer_(std::make_unique<EventFixedBuffer<>>()) // 初始化双缓冲
-        , next_buffer_(std::make_unique<EventFixedBuffer<>>())
+        , ring_(front_end_ == AsyncFrontEnd::MpscRing ? std::make_unique<EventRing>() : nullptr)
+        , pool_(options.buffer_pool.capacity, options.buffer_pool.prewarm)
+        , current_buffer_(pool_.get()) // 初始化双缓冲
+        , next_buffer_(pool_.get())
     {
-        // 初始化备用缓冲列表，用于收集应用线程写满的缓冲
-        buffers_to_write_.reserve(16);
+        // 初始化备用缓冲列表，用于收集应用线程写满的缓冲；按上限预留，突发时不用扩容
+        buffers_to_write_.reserve(overflow_.max_pending_buffers + 1);
     }
 
     AsyncLogger(const AsyncLogger&)            = delete;
@@ -39,28 +182,39 @@ public:
         {
             stop();
         }
+        // 线程退出时不能再把暂存缓冲交给一个已经析构的 logger
+        detachStaging_();
     }
 
     // 核心接口：供应用线程调用，只接收 LogEvent
     auto append(LogEvent event) -> void
     {
+        if(front_end_ == AsyncFrontEnd::MpscRing)
+        {
+            return appendRing_(std::move(event));
+        }
+        if(front_end_ == AsyncFrontEnd::ThreadLocal)
+        {
+            return appendStaging_(std::move(event));
+        }
+
         bool should_notify = false; // 标记是否需要通知
 
         {
-            auto _ = std::lock_guard<std::mutex> {mutex_};
-            // 尝试写入当前缓冲区（检查事件数量）
-            if (current_buffer_->available() > 0)
+            auto lock = std::unique_lock<std::mutex> {mutex_};
+            // 防止内存爆掉，按溢出策略处理当前日志
+            // DropBelowLevel 在超限期间即使当前缓冲还有空位也丢弃低级别事件，把空位留给高级别事件
+            auto over_limit = buffers_to_write_.size() >= overflow_.max_pending_buffers;
+            if(over_limit
+               and (current_buffer_->available() == 0 or overflow_.policy == OverflowPolicy::DropBelowLevel)
+               and not makeRoom_(lock, event))
             {
-                current_buffer_->append(std::move(event));
+                return;
             }
-            else
+            // 尝试写入当前缓冲区（检查事件数量）
+            // Block 策略等待期间，后台线程可能已经换上了新的 current_buffer_
+            if (current_buffer_->available() == 0)
             {
-                // 防止内存爆掉，直接丢弃当前日志
-                if(buffers_to_write_.size() > 25)
-                {
-                    std::cerr << "Too much events to write to buffers (buffers_to_write's size > 25)" << std::endl;
-                    return;
-                }
                 //  缓冲区已满
                 buffers_to_write_.push_back(std::move(current_buffer_));
                 // 交换缓冲区逻辑
@@ -71,14 +225,14 @@ public:
                 }
                 else
                 {
-                    // 如果没有备胎，只能现造一个
-                    current_buffer_ = std::make_unique<EventBuffer>();
+                    // 如果没有备胎，从缓冲池里拿一个
+                    current_buffer_ = pool_.get();
                 }
-                current_buffer_->append(std::move(event)); // 写入新的 current_buffer_
-
                 // 标记需要通知
                 should_notify = true;
             }
+            current_buffer_->append(std::move(event));
+            enqueued_.fetch_add(1, std::memory_order_relaxed);
         } // 锁结束
 
         // 锁外通知，避免惊群效应
@@ -94,8 +248,24 @@ public:
     {
         // 设定门栓，计数为1
         running_ = true;
+        // 并行消费：先起 consumer_threads_ 个格式化线程(后台线程只负责分发)，appender 的写线程由分发时按需创建
+        if(consumer_threads_ > 1)
+        {
+            for(auto i = size_t{0}; i < consumer_threads_; ++i)
+            {
+                format_threads_.emplace_back(&AsyncLogger::formatThreadFunc_, this);
+            }
+            format_thread_count_.store(format_threads_.size(), std::memory_order_relaxed);
+        }
         // 启动子进程(员工), 让他去干活
-        thread_ = std::thread(&AsyncLogger::threadFunc_, this);
+        if(front_end_ == AsyncFrontEnd::MpscRing)
+        {
+            thread_ = std::thread(&AsyncLogger::ringThreadFunc_, this);
+        }
+        else
+        {
+            thread_ = std::thread(&AsyncLogger::threadFunc_, this);
+        }
         // 老板卡在这里！ 死等！ 只要员工没有说“我好了！”, 老板决不让start()函数返回
         latch_.wait();
     }
@@ -103,33 +273,907 @@ public:
     // 停止日志线程
     auto stop() -> void
     {
-        running_ = false;
+        // 先把所有存活线程的暂存缓冲收走，后台线程退出前会把它们写完
+        collectStaging_(false);
+        {
+            // 在锁内修改，避免后台线程检查完谓词、尚未进入等待时错过这次通知
+            auto _ = std::lock_guard<std::mutex> {mutex_};
+            running_ = false;
+        }
         cond_.notify_one(); //唤醒线程使其退出循环
+        not_full_.notify_all(); // Block 策略下等待的生产者不再等待
         if(thread_.joinable())
         {
             thread_.join();
         }
+        // 分发线程已经退出，再把格式化线程和各 appender 写线程上的存货写完
+        stopConsumers_();
+        auto _ = std::lock_guard<std::mutex> {spill_mutex_};
+        if(spill_stream_.is_open())
+        {
+            spill_stream_.flush();
+        }
     }
         
+    // ThreadLocal 前端：当前线程登记过暂存缓冲的 logger 数(含已析构、还没清理的)，诊断用
+    [[nodiscard]] static auto threadStagingCount() -> size_t { return t_staging_.slots_.size(); }
+
+    // 各溢出策略的计数快照
+    [[nodiscard]] auto getOverflowStats() const -> OverflowStats
+    {
+        return OverflowStats{
+            .dropped_newest        = dropped_newest_.load(std::memory_order_relaxed),
+            .dropped_oldest        = dropped_oldest_.load(std::memory_order_relaxed),
+            .dropped_below_level   = dropped_below_level_.load(std::memory_order_relaxed),
+            .dropped_block_timeout = dropped_block_timeout_.load(std::memory_order_relaxed),
+            .spilled               = spilled_.load(std::memory_order_relaxed),
+        };
+    }
+
+    /**
+     * @brief 运行指标快照，随时可以调用
+     * @details 计数器都是 relaxed 读；待写缓冲块数要短暂拿一次 mutex_，appender 列表要拿一次 metrics_mutex_
+     */
+    [[nodiscard]] auto getMetrics() const -> AsyncLoggerMetrics
+    {
+        auto metrics = AsyncLoggerMetrics{
+            .enqueued     = enqueued_.load(std::memory_order_relaxed),
+            .written      = written_.load(std::memory_order_relaxed),
+            .filtered     = filtered_.load(std::memory_order_relaxed),
+            .dropped      = getOverflowStats(),
+            .pending_buffers = 0,
+            .ring_depth   = 0,
+            .buffer_swaps = buffer_swaps_.load(std::memory_order_relaxed),
+            .in_flight_batches = 0,
+            .format_threads = format_thread_count_.load(std::memory_order_relaxed),
+            .buffers_allocated = pool_.allocatedCount(),
+            .batch_size   = batch_sizes_.snapshot(),
+            .appenders    = {},
+        };
+        if(ring_)
+        {
+            metrics.enqueued += ring_->pushedCount();
+            metrics.ring_depth = ring_->approxSize();
+        }
+        {
+            auto _ = std::lock_guard<std::mutex> {mutex_};
+            metrics.pending_buffers = buffers_to_write_.size();
+        }
+        {
+            auto _ = std::lock_guard<std::mutex> {pool_mutex_};
+            metrics.in_flight_batches = in_flight_;
+        }
+        auto _ = std::lock_guard<std::mutex> {metrics_mutex_};
+        auto reader = SnapshotReader_{};
+        for(const auto& appender : getAppenderSnapshot_())
+        {
+            auto entry = AppenderMetrics{
+                .name = std::string{appender->getName()},
+                .write_latency_ns = {},
+                .rotation_ns = appender->getRotationStats(),
+                .rotation_fallbacks = appender->getRotationFallbacks(),
+            };
+            if(auto it = std::ranges::find(write_latency_, appender.get(), &AppenderLatency::appender_); it != write_latency_.end())
+            {
+                entry.write_latency_ns = it->latency_->snapshot();
+            }
+            metrics.appenders.push_back(std::move(entry));
+        }
+        return metrics;
+    }
+
 private:
+    // 某个 appender 的写入耗时；直方图不能移动，放在堆上
+    struct AppenderLatency
+    {
+        const AppenderFacade* appender_ = nullptr;
+        Uptr<Histogram> latency_;
+    };
+
+    // 并行消费：分发出去的一批事件，所有 appender 写完(最后一个引用释放)时归还在途名额
+    struct ParallelBatch
+    {
+        EventBufferPtr buffer_;
+        AsyncLogger* owner_ = nullptr;
+
+        ~ParallelBatch()
+        {
+            owner_->pool_.put(std::move(buffer_));
+            owner_->releaseInFlight_();
+        }
+    };
+
+    /**
+     * @brief 一个 appender 的写入通道：专属写线程按票号严格递增的顺序写入
+     * @details 分发线程按缓冲被接管的顺序给每个通道连续发票号，格式化线程可以乱序完成，
+     *          写线程只写 next_write_ 这一张票，因此同一生产者的事件在每个 appender 上都保持原来的顺序
+     */
+    struct AppenderLane
+    {
+        Sptr<AppenderFacade> appender_;
+        std::mutex mutex_;
+        std::condition_variable cond_;
+        std::map<uint64_t, Sptr<const ParallelBatch>> ready_;   // 票号 -> 已格式化好的批
+        uint64_t next_write_ = 0;               // 写线程下一张要写的票
+        uint64_t next_ticket_ = 0;              // 下一张要发的票，只有分发线程访问
+        uint64_t end_ticket_ = UINT64_MAX;      // 关闭后不再发票，写到这张票时写线程退出
+        std::thread thread_;
+    };
+
+    // 交给格式化线程的一项工作：一批事件，以及它要写入的通道和各自的票号
+    struct FormatJob
+    {
+        Sptr<ParallelBatch> batch_;
+        std::vector<std::pair<Sptr<AppenderLane>, uint64_t>> targets_;
+    };
+
+    /**
+     * @brief 某个生产者线程在某个 AsyncLogger 上的暂存缓冲
+     * @details mutex_ 只有在后台线程回收老化缓冲、stop() 或线程退出时才会有竞争，
+     *          平时由所属线程独占，加锁只是一次无竞争的原子操作；按缓存行对齐，相邻线程的暂存缓冲不会伪共享
+     */
+    struct alignas(c_k_cache_line) StagingSlot
+    {
+        std::mutex mutex_;
+        EventBufferPtr buffer_;
+        TimePoint first_append_;        // 当前缓冲第一条事件的写入时间，用于判断老化
+        AsyncLogger* owner_ = nullptr;  // 所属 logger，logger 析构后置空
+        bool retired_ = false;          // 所属线程已退出，等待后台线程从登记表中移除
+    };
+
+    /**
+     * @brief 线程局部的暂存缓冲列表，线程退出时把未写满的缓冲交出去
+     * @details logger 析构后它的登记项(owner_ 已置空)由本线程下一次登记新 logger 时顺带清掉，
+     *          长寿命线程反复使用短寿命 logger 时列表不会一直增长
+     */
+    struct ThreadStagingList
+    {
+        std::vector<std::pair<uint64_t, Sptr<StagingSlot>>> slots_;   // logger id -> slot
+
+        ~ThreadStagingList()
+        {
+            for(auto& [id, slot] : slots_)
+            {
+                auto _ = std::lock_guard<std::mutex> {slot->mutex_};
+                if(slot->owner_ != nullptr and slot->buffer_ and slot->buffer_->count() > 0)
+                {
+                    slot->owner_->handOff_(std::move(slot->buffer_));
+                }
+                slot->retired_ = true;
+            }
+        }
+    };
+
+    // 找到(或登记)当前线程在本 logger 上的暂存缓冲
+    auto localStaging_() -> StagingSlot&
+    {
+        auto& slots = t_staging_.slots_;
+        for(auto& [id, slot] : slots)
+        {
+            if(id == id_)
+            {
+                return *slot;
+            }
+        }
+        // 没找到说明要登记新的 logger：先清掉已经析构的 logger 留下的登记项
+        std::erase_if(slots, [](const auto& entry){
+            auto _ = std::lock_guard<std::mutex> {entry.second->mutex_};
+            return entry.second->owner_ == nullptr;
+        });
+        auto slot = std::make_shared<StagingSlot>();
+        slot->owner_ = this;
+        {
+            auto _ = std::lock_guard<std::mutex> {staging_mutex_};
+            stagings_.push_back(slot);
+        }
+        slots.emplace_back(id_, slot);
+        return *slots.back().second;
+    }
+
+    // ThreadLocal 前端：只碰本线程的暂存缓冲，写满后才拿共享锁交出去
+    auto appendStaging_(LogEvent event) -> void
+    {
+        auto& slot = localStaging_();
+        auto full = EventBufferPtr{};
+        {
+            auto _ = std::lock_guard<std::mutex> {slot.mutex_};
+            if(not slot.buffer_)
+            {
+                slot.buffer_ = pool_.get();
+            }
+            if(slot.buffer_->count() == 0)
+            {
+                slot.first_append_ = Clock::now();
+            }
+            slot.buffer_->append(std::move(event));
+            if(slot.buffer_->available() == 0)
+            {
+                full = std::move(slot.buffer_);
+            }
+        }
+        if(full)
+        {
+            handOff_(std::move(full));
+        }
+    }
+
+    // 把一整块缓冲交给后台线程
+    auto handOff_(EventBufferPtr buffer) -> void
+    {
+        {
+            auto lock = std::unique_lock<std::mutex> {mutex_};
+            // 防止内存爆掉，按溢出策略处理这一块
+            if(buffers_to_write_.size() >= overflow_.max_pending_buffers and not makeRoom_(lock, *buffer))
+            {
+                pool_.put(std::move(buffer));
+                return;
+            }
+            enqueued_.fetch_add(buffer->count(), std::memory_order_relaxed);
+            buffers_to_write_.push_back(std::move(buffer));
+        }
+        cond_.notify_one();
+    }
+
+    /**
+     * @brief 待写缓冲已达上限时，按溢出策略处理一个新事件（调用时持有 mutex_）
+     * @return true: 可以继续写入；false: 事件已被丢弃或溢写，调用者直接返回
+     */
+    auto makeRoom_(std::unique_lock<std::mutex>& lock, const LogEvent& event) -> bool
+    {
+        switch(overflow_.policy)
+        {
+            case OverflowPolicy::DropNewest:
+                dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+
+            case OverflowPolicy::DropOldest: {
+                if(buffers_to_write_.empty())
+                {
+                    return true;
+                }
+                auto oldest = std::move(buffers_to_write_.front());
+                buffers_to_write_.erase(buffers_to_write_.begin());
+                dropped_oldest_.fetch_add(oldest->count(), std::memory_order_relaxed);
+                // 丢掉的缓冲直接拿来当备胎，已经有备胎时还给缓冲池
+                oldest->reset();
+                if(not next_buffer_)
+                {
+                    next_buffer_ = std::move(oldest);
+                }
+                else
+                {
+                    pool_.put(std::move(oldest));
+                }
+                return true;
+            }
+
+            case OverflowPolicy::DropBelowLevel:
+                if(event.getLevel() >= overflow_.keep_level)
+                {
+                    return true;
+                }
+                dropped_below_level_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+
+            case OverflowPolicy::Block:
+                if(waitNotFull_(lock))
+                {
+                    return true;
+                }
+                dropped_block_timeout_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+
+            case OverflowPolicy::SpillToFile:
+                lock.unlock();
+                spill_(event);
+                spilled_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+        }
+        return false;
+    }
+
+    // 同上，处理一整块暂存缓冲（ThreadLocal 前端）
+    auto makeRoom_(std::unique_lock<std::mutex>& lock, EventBuffer& buffer) -> bool
+    {
+        switch(overflow_.policy)
+        {
+            case OverflowPolicy::DropNewest:
+                dropped_newest_.fetch_add(buffer.count(), std::memory_order_relaxed);
+                return false;
+
+            case OverflowPolicy::DropOldest:
+                if(not buffers_to_write_.empty())
+                {
+                    dropped_oldest_.fetch_add(buffers_to_write_.front()->count(), std::memory_order_relaxed);
+                    pool_.put(std::move(buffers_to_write_.front()));
+                    buffers_to_write_.erase(buffers_to_write_.begin());
+                }
+                return true;
+
+            case OverflowPolicy::DropBelowLevel: {
+                auto removed = buffer.retainIf([this](const LogEvent& event){ return event.getLevel() >= overflow_.keep_level; });
+                dropped_below_level_.fetch_add(removed, std::memory_order_relaxed);
+                return buffer.count() > 0;
+            }
+
+            case OverflowPolicy::Block:
+                if(waitNotFull_(lock))
+                {
+                    return true;
+                }
+                dropped_block_timeout_.fetch_add(buffer.count(), std::memory_order_relaxed);
+                return false;
+
+            case OverflowPolicy::SpillToFile:
+                lock.unlock();
+                std::ranges::for_each(buffer.getEventSpan(), [this](const LogEvent& event){ spill_(event); });
+                spilled_.fetch_add(buffer.count(), std::memory_order_relaxed);
+                return false;
+        }
+        return false;
+    }
+
+    // Block 策略：等待后台线程取走待写缓冲，超时返回 false
+    auto waitNotFull_(std::unique_lock<std::mutex>& lock) -> bool
+    {
+        return not_full_.wait_for(lock, overflow_.block_timeout, [this]{
+            return not running_ or buffers_to_write_.size() < overflow_.max_pending_buffers;
+        });
+    }
+
+    // SpillToFile 策略：直接同步写入溢出文件
+    auto spill_(const LogEvent& event) -> void
+    {
+        auto _ = std::lock_guard<std::mutex> {spill_mutex_};
+        if(not spill_stream_.is_open())
+        {
+            spill_stream_.open(overflow_.spill_filename, std::ios::out | std::ios::app | std::ios::binary);
+        }
+        if(event.isDeferred())
+        {
+            spill_formatter_.format(spill_stream_, event.rendered());
+            return;
+        }
+        spill_formatter_.format(spill_stream_, event);
+    }
+
+    /**
+     * @brief 收集各线程的暂存缓冲到 buffers_to_write_
+     * @param aged_only true: 后台线程定期调用，只收已老化的缓冲，且不阻塞正在写入的生产者
+     *                  false: stop() 调用，收走全部非空缓冲
+     */
+    auto collectStaging_(bool aged_only) -> void
+    {
+        if(front_end_ != AsyncFrontEnd::ThreadLocal)
+        {
+            return;
+        }
+        auto collected = std::vector<EventBufferPtr>{};
+        auto now = Clock::now();
+        {
+            auto _ = std::lock_guard<std::mutex> {staging_mutex_};
+            for(auto& slot : stagings_)
+            {
+                auto lock = std::unique_lock<std::mutex> {slot->mutex_, std::defer_lock};
+                if(aged_only)
+                {
+                    if(not lock.try_lock())
+                    {
+                        continue;
+                    }
+                }
+                else
+                {
+                    lock.lock();
+                }
+                if(not slot->buffer_ or slot->buffer_->count() == 0)
+                {
+                    continue;
+                }
+                if(aged_only and now - slot->first_append_ < std::chrono::seconds(flush_interval_))
+                {
+                    continue;
+                }
+                collected.push_back(std::move(slot->buffer_));
+            }
+            // 移除所属线程已经退出的登记项；退出中的线程可能正持有 slot 锁、在 Block 策略下等后台线程腾空间，
+            // 这里阻塞等它会互相等到超时，所以拿不到锁就留到下一轮
+            std::erase_if(stagings_, [](const Sptr<StagingSlot>& slot){
+                auto lock = std::unique_lock<std::mutex> {slot->mutex_, std::try_to_lock};
+                return lock.owns_lock() and slot->retired_;
+            });
+        }
+        if(not collected.empty())
+        {
+            auto _ = std::lock_guard<std::mutex> {mutex_};
+            for(auto& buf : collected)
+            {
+                enqueued_.fetch_add(buf->count(), std::memory_order_relaxed);
+                buffers_to_write_.push_back(std::move(buf));
+            }
+        }
+    }
+
+    // logger 析构前调用：让仍然存活的线程不再引用本 logger，stop() 之后才写入的缓冲随之释放
+    auto detachStaging_() -> void
+    {
+        auto _ = std::lock_guard<std::mutex> {staging_mutex_};
+        for(auto& slot : stagings_)
+        {
+            auto slot_lock = std::lock_guard<std::mutex> {slot->mutex_};
+            slot->owner_ = nullptr;
+            slot->buffer_.reset();
+        }
+        stagings_.clear();
+    }
+
+    /**
+     * @brief 剔除低于日志级别的事件，返回要交给 appender 的事件；并行消费时由格式化线程调用
+     * @param materialize 是否就地完成延迟格式化；所有目标 appender 都 wantsDeferred() 时不必渲染
+     */
+    auto prepareBatch_(EventBuffer& buffer, bool materialize) -> std::span<const LogEvent>
+    {
+        auto level = getLogLevel();
+        filtered_.fetch_add(buffer.retainIf([level](const LogEvent& event){ return event.getLevel() >= level; }),
+                            std::memory_order_relaxed);
+        if(materialize)
+        {
+            buffer.materialize();
+        }
+        auto events = buffer.getEventSpan();
+        if(not events.empty())
+        {
+            batch_sizes_.record(events.size());
+            written_.fetch_add(events.size(), std::memory_order_relaxed);
+        }
+        return events;
+    }
+
+    /**
+     * @brief 单消费者：把一块缓冲整批写入 appenders，逐个 appender 走批量接口
+     * @details - 每个 appender 的整批写入单独计时，计时和计数都按批进行，不落到单条事件上
+     *          - 先交给 wantsDeferred() 的 appender(拿到原始参数)，再就地渲染交给其余的；
+     *            全部 appender 都要原始参数时整批不调用 std::format
+     */
+    auto writeBuffer_(EventBuffer& buffer) -> void
+    {
+        auto events = prepareBatch_(buffer, false);
+        if(events.empty())
+        {
+            return;
+        }
+        auto reader = SnapshotReader_{};
+        const auto& appenders = getAppenderSnapshot_();
+        for(const auto& appender : appenders)
+        {
+            if(appender->wantsDeferred())
+            {
+                auto timer = ScopedLatency{writeLatency_(*appender)};
+                appender->log(events);
+            }
+        }
+        auto rendered = false;
+        for(const auto& appender : appenders)
+        {
+            if(appender->wantsDeferred())
+            {
+                continue;
+            }
+            if(not rendered)
+            {
+                buffer.materialize();
+                rendered = true;
+            }
+            auto timer = ScopedLatency{writeLatency_(*appender)};
+            appender->log(events);
+        }
+    }
+
+    // 消费一块缓冲：单消费者直接写；并行消费时整块交出去，buffer 置空，调用者负责补一块新的
+    auto consume_(EventBufferPtr& buffer) -> void
+    {
+        if(consumer_threads_ == 1)
+        {
+            writeBuffer_(*buffer);
+            return;
+        }
+        if(buffer->count() > 0)
+        {
+            dispatch_(std::move(buffer));
+        }
+    }
+
+    /**
+     * @brief 并行消费的分发(在原来的后台线程上)：按当前 appender 快照给每个通道发一张票，整块交给格式化线程
+     * @details 在途批数达到 max_pending_buffers 时在这里等待，后台线程不再接管新缓冲，
+     *          背压由此传回生产者一侧，照常走溢出策略
+     */
+    auto dispatch_(EventBufferPtr buffer) -> void
+    {
+        acquireInFlight_();
+        reapRetiredLanes_();
+        syncLanes_();
+        auto job = FormatJob{.batch_ = std::make_shared<ParallelBatch>(std::move(buffer), this), .targets_ = {}};
+        job.targets_.reserve(lanes_.size());
+        for(const auto& lane : lanes_)
+        {
+            job.targets_.emplace_back(lane, lane->next_ticket_++);
+        }
+        {
+            auto _ = std::lock_guard<std::mutex> {pool_mutex_};
+            jobs_.push_back(std::move(job));
+        }
+        pool_cond_.notify_one();
+    }
+
+    // 让写入通道与 appender 快照一致：新 appender 建通道并起写线程，被移除的 appender 关闭通道(写完已发的票再退出)
+    auto syncLanes_() -> void
+    {
+        // 先读代数再读快照：两次之间配置又变了的话，记下的代数偏旧，下一批再同步一次
+        auto generation = getAppenderGeneration_();
+        if(generation == lanes_generation_)
+        {
+            return;
+        }
+        lanes_generation_ = generation;
+        auto reader = SnapshotReader_{};
+        const auto& appenders = getAppenderSnapshot_();
+        auto lanes = std::vector<Sptr<AppenderLane>>{};
+        for(const auto& appender : appenders)
+        {
+            auto it = std::ranges::find_if(lanes_, [&appender](const Sptr<AppenderLane>& lane){
+                return lane->appender_ == appender;
+            });
+            if(it != lanes_.end())
+            {
+                lanes.push_back(*it);
+                continue;
+            }
+            auto lane = std::make_shared<AppenderLane>();
+            lane->appender_ = appender;
+            lane->thread_ = std::thread(&AsyncLogger::laneThreadFunc_, this, std::ref(*lane));
+            lanes.push_back(std::move(lane));
+        }
+        for(auto& lane : lanes_)
+        {
+            if(std::ranges::find(lanes, lane) == lanes.end())
+            {
+                closeLane_(*lane);
+                retired_lanes_.push_back(std::move(lane));
+            }
+        }
+        lanes_ = std::move(lanes);
+    }
+
+    // 已关闭的通道写完最后一张票后写线程就会退出，在这里回收，运行中删掉的 appender 不会留下空闲线程
+    auto reapRetiredLanes_() -> void
+    {
+        std::erase_if(retired_lanes_, [](const Sptr<AppenderLane>& lane){
+            {
+                auto _ = std::lock_guard<std::mutex> {lane->mutex_};
+                if(lane->next_write_ != lane->end_ticket_)
+                {
+                    return false;
+                }
+            }
+            lane->thread_.join();
+            return true;
+        });
+    }
+
+    static auto closeLane_(AppenderLane& lane) -> void
+    {
+        {
+            auto _ = std::lock_guard<std::mutex> {lane.mutex_};
+            lane.end_ticket_ = lane.next_ticket_;
+        }
+        lane.cond_.notify_one();
+    }
+
+    auto acquireInFlight_() -> void
+    {
+        auto lock = std::unique_lock<std::mutex> {pool_mutex_};
+        in_flight_cond_.wait(lock, [this]{ return in_flight_ < std::max<size_t>(overflow_.max_pending_buffers, 1); });
+        ++in_flight_;
+    }
+
+    auto releaseInFlight_() -> void
+    {
+        {
+            auto _ = std::lock_guard<std::mutex> {pool_mutex_};
+            --in_flight_;
+        }
+        in_flight_cond_.notify_one();
+    }
+
+    /**
+     * @brief 并行消费的格式化线程：延迟格式化和级别过滤，然后把批挂到各通道的对应票号上
+     * @details 各通道共用同一批事件，只要有一个目标 appender 要渲染好的文本就整批渲染，
+     *          这时 wantsDeferred() 的 appender 收到的也是文本；全部都要原始参数时不渲染
+     */
+    auto formatThreadFunc_() -> void
+    {
+        while(true)
+        {
+            auto job = FormatJob{};
+            {
+                auto lock = std::unique_lock<std::mutex> {pool_mutex_};
+                pool_cond_.wait(lock, [this]{ return pool_stopping_ or not jobs_.empty(); });
+                if(jobs_.empty())
+                {
+                    return;
+                }
+                job = std::move(jobs_.front());
+                jobs_.pop_front();
+            }
+            auto materialize = std::ranges::any_of(job.targets_, [](const auto& target){
+                return not target.first->appender_->wantsDeferred();
+            });
+            prepareBatch_(*job.batch_->buffer_, materialize);
+            for(auto& [lane, ticket] : job.targets_)
+            {
+                {
+                    auto _ = std::lock_guard<std::mutex> {lane->mutex_};
+                    lane->ready_.emplace(ticket, job.batch_);
+                }
+                lane->cond_.notify_one();
+            }
+        }
+    }
+
+    // appender 的写线程：一次只写 next_write_ 这张票，慢 appender 只拖慢自己的通道
+    auto laneThreadFunc_(AppenderLane& lane) -> void
+    {
+        auto& latency = writeLatency_(*lane.appender_);
+        while(true)
+        {
+            auto batch = Sptr<const ParallelBatch>{};
+            {
+                auto lock = std::unique_lock<std::mutex> {lane.mutex_};
+                lane.cond_.wait(lock, [&lane]{
+                    return lane.next_write_ == lane.end_ticket_ or lane.ready_.contains(lane.next_write_);
+                });
+                if(lane.next_write_ == lane.end_ticket_)
+                {
+                    return;
+                }
+                batch = std::move(lane.ready_.extract(lane.next_write_).mapped());
+                ++lane.next_write_;
+            }
+            auto events = batch->buffer_->getEventSpan();
+            if(not events.empty())
+            {
+                auto timer = ScopedLatency{latency};
+                lane.appender_->log(events);
+            }
+        }
+    }
+
+    // stop() 调用：格式化线程做完剩下的工作后退出，再关闭所有通道，等写线程写完
+    auto stopConsumers_() -> void
+    {
+        {
+            auto _ = std::lock_guard<std::mutex> {pool_mutex_};
+            pool_stopping_ = true;
+        }
+        pool_cond_.notify_all();
+        for(auto& th : format_threads_)
+        {
+            th.join();
+        }
+        format_threads_.clear();
+        format_thread_count_.store(0, std::memory_order_relaxed);
+        for(auto& lane : lanes_)
+        {
+            closeLane_(*lane);
+        }
+        retired_lanes_.insert(retired_lanes_.end(), lanes_.begin(), lanes_.end());
+        for(auto& lane : retired_lanes_)
+        {
+            lane->thread_.join();
+        }
+        lanes_.clear();
+        retired_lanes_.clear();
+        lanes_generation_ = 0;
+        pool_stopping_ = false;
+    }
+
+    // 找到(或登记) appender 的写入耗时直方图，只有后台线程登记
+    auto writeLatency_(const AppenderFacade& appender) -> Histogram&
+    {
+        auto _ = std::lock_guard<std::mutex> {metrics_mutex_};
+        if(auto it = std::ranges::find(write_latency_, &appender, &AppenderLatency::appender_); it != write_latency_.end())
+        {
+            return *it->latency_;
+        }
+        return *write_latency_.emplace_back(&appender, std::make_unique<Histogram>()).latency_;
+    }
+
+    // 到了 metrics_interval_ 就把指标写成一条日志
+    auto maybeDumpMetrics_() -> void
+    {
+        if(not metrics_logger_ or Clock::now() - last_metrics_dump_ < metrics_interval_)
+        {
+            return;
+        }
+        last_metrics_dump_ = Clock::now();
+        auto event = MakeLogEvent(*metrics_logger_, LogLevel::INFO, std::source_location::current());
+        event.append(FormatMetrics(getMetrics()));
+        metrics_logger_->log(event);
+    }
+
+    // 把一组缓冲里的事件写入 appenders；并行消费时交出去的缓冲从列表里去掉
+    auto writeBuffers_(std::vector<EventBufferPtr>& buffers) -> void
+    {
+        for(auto& buf : buffers)
+        {
+            consume_(buf);
+        }
+        std::erase(buffers, nullptr);
+    }
+
+    // MpscRing 前端：无锁写入，只在后台线程睡眠且积攒够一批时才加锁唤醒
+    auto appendRing_(LogEvent event) -> void
+    {
+        if(not ring_->tryPush(std::move(event)) and not ringOverflow_(event))
+        {
+            return;
+        }
+        if(ring_->approxSize() >= c_k_event_count)
+        {
+            wakeConsumer_();
+        }
+    }
+
+    // 只有抢到 exchange 的那个生产者负责通知，其余生产者直接返回
+    auto wakeConsumer_() -> void
+    {
+        if(consumer_sleeping_.exchange(false))
+        {
+            {
+                auto _ = std::lock_guard<std::mutex> {mutex_};
+            }
+            cond_.notify_one();
+        }
+    }
+
+    /**
+     * @brief 环形队列已满时按溢出策略处理（无锁）
+     * @details 生产者无法从环形队列里弹出最旧的事件，DropOldest 在这里退化为 DropNewest
+     * @return true: 事件最终写入了环形队列
+     */
+    auto ringOverflow_(LogEvent& event) -> bool
+    {
+        // 队列满了，后台线程无论如何都该醒来干活
+        wakeConsumer_();
+        switch(overflow_.policy)
+        {
+            case OverflowPolicy::DropNewest:
+            case OverflowPolicy::DropOldest:
+                dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+
+            case OverflowPolicy::DropBelowLevel:
+                if(event.getLevel() < overflow_.keep_level)
+                {
+                    dropped_below_level_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+                }
+                // 高级别事件重试到后台线程腾出槽位，但和 Block 一样最多等 block_timeout：
+                // 消费者卡住(appender 阻塞)时不能让生产者无限自旋；后台线程没在运行时直接丢弃
+                {
+                    auto deadline = Clock::now() + overflow_.block_timeout;
+                    while(not ring_->tryPush(std::move(event)))
+                    {
+                        if(not running_)
+                        {
+                            dropped_newest_.fetch_add(1, std::memory_order_relaxed);
+                            return false;
+                        }
+                        if(Clock::now() >= deadline)
+                        {
+                            dropped_block_timeout_.fetch_add(1, std::memory_order_relaxed);
+                            return false;
+                        }
+                        std::this_thread::yield();
+                    }
+                }
+                return true;
+
+            case OverflowPolicy::Block: {
+                auto deadline = Clock::now() + overflow_.block_timeout;
+                while(not ring_->tryPush(std::move(event)))
+                {
+                    if(Clock::now() >= deadline)
+                    {
+                        dropped_block_timeout_.fetch_add(1, std::memory_order_relaxed);
+                        return false;
+                    }
+                    std::this_thread::yield();
+                }
+                return true;
+            }
+
+            case OverflowPolicy::SpillToFile:
+                spill_(event);
+                spilled_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+        }
+        return false;
+    }
+
+    // 把环形队列中的事件按批取出(每批最多 c_k_event_count 个)，写入 appenders
+    auto drainRing_(EventBufferPtr& batch) -> void
+    {
+        auto take = [&batch](LogEvent&& event){ batch->append(std::move(event)); };
+        while(ring_->popBatch(take, batch->available()) > 0)
+        {
+            consume_(batch);
+            if(batch)
+            {
+                batch->reset();
+            }
+            else
+            {
+                batch = pool_.get();
+            }
+        }
+        ring_->publishCursor();
+    }
+
+    // MpscRing 前端的后台线程
+    auto ringThreadFunc_() -> void
+    {
+        latch_.count_down();
+
+        // 每批事件先从环形队列挪到这里，再统一交给 appenders
+        auto batch = pool_.get();
+
+        while(running_)
+        {
+            drainRing_(batch);
+
+            {
+                auto lock = std::unique_lock<std::mutex>(mutex_);
+                consumer_sleeping_.store(true);
+                // 等待: 直到超时 (flush_interval_)、被生产者唤醒、stop()，或者刚才处理期间又积攒了一批
+                // 即使偶尔错过唤醒，最多也只会延迟一个 flush_interval_
+                cond_.wait_for(lock, std::chrono::seconds(flush_interval_), [this]{
+                    return not running_
+                        or not consumer_sleeping_.load(std::memory_order_acquire)
+                        or ring_->approxSize() >= c_k_event_count;
+                });
+                consumer_sleeping_.store(false, std::memory_order_relaxed);
+            }
+            maybeDumpMetrics_();
+        }
+
+        // 退出前把剩余的事件全部写完
+        drainRing_(batch);
+    }
+
     // 后台日志线程执行的函数(消费者) ----------> 子进程(员工)
     auto threadFunc_() -> void
     {
         // 员工喊我好了！，计数器从1变成0，主进程的wait() 瞬间苏醒并返回
         latch_.count_down();
 
-        // 预分配用于交换的缓冲区，避免在日志线程中频繁分配内存
-        auto new_buffer1 = std::make_unique<EventBuffer>();
-        auto new_buffer2 = std::make_unique<EventBuffer>();
+        // 预留用于交换的缓冲区，从缓冲池里拿，避免在日志线程中频繁分配内存
+        auto new_buffer1 = pool_.get();
+        auto new_buffer2 = pool_.get();
 
-        // 用于处理待写入的缓冲区
+        // 用于处理待写入的缓冲区，和 buffers_to_write_ 互换，容量也一样按上限预留
         auto buffers_to_process = std::vector<EventBufferPtr>{};
 
-        buffers_to_process.reserve(16); // 存放16个缓冲区
+        buffers_to_process.reserve(overflow_.max_pending_buffers + 1);
 
         // 员工死循环开始循环写日志
         while(running_)
         {
+            // ThreadLocal 前端：把生产者迟迟写不满的暂存缓冲收过来
+            collectStaging_(true);
+            // 空闲时也会每 flush_interval_ 走到这里
+            maybeDumpMetrics_();
             {  
                 // 等待条件变量唤醒或者超时
                 auto lock = std::unique_lock<std::mutex>(mutex_);
@@ -141,7 +1185,7 @@ private:
                 }
 
                 // [优化] 如果是超时唤醒，且完全没有新数据，直接下一轮，省去 Swap 开销
-                if(buffers_to_write_.empty() and current_buffer_->length() == 0)
+                if(buffers_to_write_.empty() and current_buffer_->count() == 0)
                 {
                     continue;
                 }
@@ -155,6 +1199,7 @@ private:
 
                 // 3. 交换待写入列表：将应用线程的数据移交给日志线程
                 buffers_to_process.swap(buffers_to_write_);
+                buffer_swaps_.fetch_add(1, std::memory_order_relaxed);
                 // 此时，应用线程可以继续向 buffers_to_write_ 写入，互不影响
 
                 // 4. 将空的 new_buffer2 替换为新的 next_buffer_
@@ -163,69 +1208,126 @@ private:
                     next_buffer_ = std::move(new_buffer2);
                 }
             }   // 互斥锁释放
+            // buffers_to_write_ 已经清空，唤醒因 Block 策略而等待的生产者
+            not_full_.notify_all();
 
             // --- 日志线程开始 I/O 操作 (无锁) ---
-            if(buffers_to_process.size() > 25)
-            {
-                // 如果待处理缓冲区过多，说明生产速度远超消费速度，可能出现日志堆积
-                // 这里简单丢弃部分日志以防内存占用过高
-                auto now = std::chrono::time_point_cast<Seconds>(SystemClock::now());
-                auto zoned_time = ZoneTime<Seconds>{
-                    std::chrono::current_zone(), now
-                };
-                auto time_point_str = std::format("{:%Y-%m-%d-%H-%M-%S}", zoned_time.get_local_time());
-                UtilT::println("Dropper log messages at {}, {} larger than buffer", time_point_str, buffers_to_process.size()-2);
-
-                // 直接丢掉多余的日志
-                buffers_to_process.erase(buffers_to_process.begin()+2,buffers_to_process.end());
-            }
+            // 待写缓冲的上限由生产者一侧按溢出策略保证，这里不再丢弃
             // 5. 将所有缓冲区内容写入文件
-            for(const auto& buf : buffers_to_process)
-            {
-                auto data = buf->getEventSpan();
-                // this 捕获的是这个AsncLogger的类，使其能调用自己的log函数
-                std::ranges::for_each(data, [this](const LogEvent& event){ this->log(event);});
-            }
+            writeBuffers_(buffers_to_process);
 
-            // 6. 清理并回收缓冲区
-            if (buffers_to_process.size() > 2)
+            // 6. 写完的缓冲全部还给缓冲池(由它清空)，突发时多出来的缓冲也留着给下一次突发用
+            for(auto& buf : buffers_to_process)
             {
-                // // 如果待处理缓冲区过多，回收多余内存，但至少保留两个空的供交换
-                buffers_to_process.resize(2);
+                pool_.put(std::move(buf));
             }
+            buffers_to_process.clear();
 
-            // 7. 将两个已处理的空缓冲区放回预分配指针，供下次交换使用
+            // 7. 从缓冲池补齐两个预留缓冲，供下次交换使用
             if(new_buffer1 == nullptr)
             {
-                new_buffer1 = std::move(buffers_to_process.back());
-                buffers_to_process.pop_back();
+                new_buffer1 = pool_.get();
             }
 
             if(new_buffer2 == nullptr)
             {
-                new_buffer2 = std::move(buffers_to_process.back());
-                buffers_to_process.pop_back();
+                new_buffer2 = pool_.get();
             }
-
-            // 清空待处理列表
-            buffers_to_process.clear();
             
         }
+
+        // 退出前把剩余的缓冲全部写完（包括 stop() 收来的暂存缓冲）
+        {
+            auto _ = std::lock_guard<std::mutex>(mutex_);
+            buffers_to_process.swap(buffers_to_write_);
+        }
+        writeBuffers_(buffers_to_process);
+        if(current_buffer_->count() > 0)
+        {
+            consume_(current_buffer_);
+            if(current_buffer_)
+            {
+                current_buffer_->reset();
+            }
+            else
+            {
+                current_buffer_ = pool_.get();
+            }
+        }
     }
 
 private:
+    /*
+     * 成员按访问方分组，每组从新的缓存行开始(c_k_cache_line)，避免生产者和后台线程互相把对方的缓存行抢走：
+     * - 配置：构造后只读，可以和任何人共享
+     * - 生产者热点：DoubleBuffer / ThreadLocal 生产者持 mutex_ 读写的状态，锁和它保护的数据放在一起，拿到锁时一并搬进缓存
+     * - consumer_sleeping_：MpscRing 生产者无锁读、后台线程写，单独一行
+     * - 溢出计数：只在丢弃时由生产者更新
+     * - 后台线程：只有后台线程写的计数、统计和线程对象
+     */
+
     // 配置
     const int flush_interval_; // 强制刷新间隔（秒）
+    const AsyncFrontEnd front_end_;
+    const OverflowOptions overflow_;
+    const Sptr<Logger> metrics_logger_;
+    const std::chrono::seconds metrics_interval_;
+    const size_t consumer_threads_;
+    const uint64_t id_ = s_next_id_.fetch_add(1); // 线程局部暂存列表用它区分不同的 logger
+    std::atomic<bool> running_;                   // 只在 start()/stop() 时改变
+    std::unique_ptr<EventRing> ring_;             // MpscRing 前端；环形队列自己把读写游标分在不同缓存行
+    EventBufferPool<EventBuffer> pool_;           // 缓冲池要先于使用它的缓冲构造，它的取/放游标同样各占一行
 
-    // 线程和同步
-    std::thread thread_;
-    std::atomic<bool> running_;
-    std::mutex mutex_;
-    std::condition_variable cond_;
-    std::latch latch_{1};
-
-    // 双缓冲机制的核心
+    // 生产者热点(双缓冲机制的核心)
+    alignas(c_k_cache_line) mutable std::mutex mutex_;
     EventBufferPtr current_buffer_;                // 当前应用线程正在写入的缓冲区
     EventBufferPtr next_buffer_;                   // 备用缓冲区（用于减少应用线程等待时间）
     std::vector<EventBufferPtr> buffers_to_write_; // 已写满，等待后台线程写入的缓冲区列表
+    std::atomic<uint64_t> enqueued_ {0};           // 持 mutex_ 时更新；MpscRing 前端另用环形队列的写游标
+    std::condition_variable cond_;
+    std::condition_variable not_full_;  // Block 策略：后台线程取走待写缓冲后通知生产者
+
+    // MpscRing 前端
+    alignas(c_k_cache_line) std::atomic<bool> consumer_sleeping_ {false};  // 后台线程是否在等待条件变量
+
+    // 溢出策略计数（事件数）
+    alignas(c_k_cache_line) std::atomic<uint64_t> dropped_newest_ {0};
+    std::atomic<uint64_t> dropped_oldest_ {0};
+    std::atomic<uint64_t> dropped_below_level_ {0};
+    std::atomic<uint64_t> dropped_block_timeout_ {0};
+    std::atomic<uint64_t> spilled_ {0};
+    std::mutex spill_mutex_;
+    std::ofstream spill_stream_;
+    LogFormatter spill_formatter_;
+
+    // 后台线程和运行指标
+    alignas(c_k_cache_line) std::thread thread_;
+    std::latch latch_{1};
+    std::atomic<uint64_t> written_ {0};
+    std::atomic<uint64_t> filtered_ {0};
+    std::atomic<uint64_t> buffer_swaps_ {0};
+    Histogram batch_sizes_;
+    mutable std::mutex metrics_mutex_;              // 保护 write_latency_ 的登记
+    std::vector<AppenderLatency> write_latency_;
+    TimePoint last_metrics_dump_ = Clock::now();
+
+    // 并行消费(consumer_threads_ > 1)
+    alignas(c_k_cache_line) std::vector<std::thread> format_threads_;
+    std::atomic<size_t> format_thread_count_ = 0;   // format_threads_.size()，给 getMetrics() 在别的线程读
+    mutable std::mutex pool_mutex_;                 // 保护 jobs_、in_flight_、pool_stopping_
+    std::condition_variable pool_cond_;
+    std::condition_variable in_flight_cond_;
+    std::deque<FormatJob> jobs_;
+    size_t in_flight_ = 0;
+    bool pool_stopping_ = false;
+    std::vector<Sptr<AppenderLane>> lanes_;         // 与第 lanes_generation_ 代快照一一对应，只有分发线程访问
+    std::vector<Sptr<AppenderLane>> retired_lanes_; // appender 已被移除、写线程还没回收的通道
+    uint64_t lanes_generation_ = 0;                 // 0 表示还没同步过(Logger 构造时就发布了第 1 代)
+
+    // ThreadLocal 前端(生产者只在首次写入时登记)
+    std::mutex staging_mutex_;                   // 保护 stagings_
+    std::vector<Sptr<StagingSlot>> stagings_;    // 所有线程在本 logger 上的暂存缓冲
+
+    inline static std::atomic<uint64_t> s_next_id_ = 0;
+    inline static thread_local ThreadStagingList t_staging_;
 };
\ No newline at end of file
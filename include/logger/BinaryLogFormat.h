@@ -0,0 +1,230 @@
+#pragma once
+
+#include "logger/LogBuffer.hpp"
+#include "logger/LogEvent.h"
+#include "logger/LogName.h"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 二进制日志的文件格式：BinaryFileAppender/NetworkAppender 写，BinaryLogReader 读
+ * @details - 文件头：c_file_magic(8 字节) + 版本号(u32) + 保留(u32)。追加写入已有文件时也会再写一个文件头；
+ *            读取时按每个文件头的版本号解码它后面的块，版本 1 的事件没有字段
+ *          - 文件头之后是若干块：c_block_magic(u32) + 负载长度(u32) + 负载的 CRC32(u32) + 负载，每块单独校验
+ *          - 每块自带字典：块内第一次用到的名称、格式串、源码位置先写字典条目，id 只在本块内有效。
+ *            一个块损坏只丢这一块的日志，后面的块照样能完整解码
+ *          - 负载是一串条目，每个条目以 1 字节 EntryTag 开头：
+ *            - String : id、长度、字节。日志器名、线程名、文件名、函数名、格式串，每块只写一次
+ *            - Site   : id、文件名 id、函数名 id、行号。源码位置，每块只写一次
+ *            - Event  : 级别(u8)、时间戳增量、线程号、协程号、耗时、日志器名 id、线程名 id、Site id、格式串 id，
+ *                       格式串 id 非 0 时接着是参数个数(u8)、各参数的 ArgType(u8)、参数字节长度、参数字节，
+ *                       为 0 时接着是已经格式化好的消息：长度、文本；
+ *                       版本 2 起最后是结构化字段：个数，每个字段的键(字符串 id)、ArgType(u8)、值长度、值字节，
+ *                       Other 类型的值是字符串文本
+ *          - 除了文件头、块头和参数字节，整数都是 LEB128 变长编码；id 从 1 开始，0 表示没有
+ *          - 时间戳是相对块内上一条事件的微秒增量(块内第一条相对 0)，zigzag 编码
+ *          - 定长整数和参数字节都按小端存放，参数字节就是参数在内存里的原样拷贝
+ */
+namespace BinaryLog {
+
+    inline constexpr char c_file_magic[8] = {'C', 'O', 'T', 'T', 'O', 'N', 'B', 'L'};
+    inline constexpr uint32_t c_version = 2;
+    inline constexpr uint32_t c_min_version = 1;    // 读取端还能解码的最老版本
+    inline constexpr size_t c_file_header_size = 16;
+
+    inline constexpr uint32_t c_block_magic = 0x4B4C4243;   // "CBLK"
+    inline constexpr size_t c_block_header_size = 12;
+
+    enum class EntryTag : uint8_t
+    {
+        String = 1,
+        Site   = 2,
+        Event  = 3,
+    };
+
+    static_assert(std::endian::native == std::endian::little, "二进制日志按小端存放参数字节");
+
+    // 参数在文件里占的字节数，Other 类型不会写进文件，返回 0
+    constexpr auto ArgSize(ArgType type) -> size_t
+    {
+        switch(type)
+        {
+            case ArgType::Bool:    return sizeof(bool);
+            case ArgType::Char:    return sizeof(char);
+            case ArgType::Int8:    case ArgType::UInt8:  return 1;
+            case ArgType::Int16:   case ArgType::UInt16: return 2;
+            case ArgType::Int32:   case ArgType::UInt32: return 4;
+            case ArgType::Int64:   case ArgType::UInt64: return 8;
+            case ArgType::Float:   return sizeof(float);
+            case ArgType::Double:  return sizeof(double);
+            case ArgType::Pointer: return sizeof(const void*);
+            case ArgType::Null:    return sizeof(std::nullptr_t);
+            case ArgType::Other:   return 0;
+        }
+        return 0;
+    }
+
+    inline auto PutFixed32(LogBuffer& buf, uint32_t value) -> void
+    {
+        char bytes[sizeof(value)];
+        std::memcpy(bytes, &value, sizeof(value));
+        buf.append(bytes, sizeof(bytes));
+    }
+
+    inline auto PutVarint(LogBuffer& buf, uint64_t value) -> void
+    {
+        while(value >= 0x80)
+        {
+            buf.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        buf.push_back(static_cast<char>(value));
+    }
+
+    constexpr auto ZigZag(int64_t value) -> uint64_t
+    {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    constexpr auto UnZigZag(uint64_t value) -> int64_t
+    {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    /** @brief 在一段字节上顺序读取，越界或编码非法后 ok() 为 false，之后读到的都是 0/空 */
+    class Cursor
+    {
+    public:
+        Cursor() = default;
+        explicit Cursor(std::string_view data) : data_{data} {}
+
+        [[nodiscard]] auto ok() const -> bool { return ok_; }
+        [[nodiscard]] auto done() const -> bool { return not ok_ or pos_ >= data_.size(); }
+
+        // 读到了非法内容，之后的读取全部作废
+        auto fail() -> void { ok_ = false; }
+
+        auto getByte() -> uint8_t
+        {
+            if(not require_(1))
+            {
+                return 0;
+            }
+            return static_cast<uint8_t>(data_[pos_++]);
+        }
+
+        auto getFixed32() -> uint32_t
+        {
+            auto value = uint32_t{0};
+            if(require_(sizeof(value)))
+            {
+                std::memcpy(&value, data_.data() + pos_, sizeof(value));
+                pos_ += sizeof(value);
+            }
+            return value;
+        }
+
+        auto getVarint() -> uint64_t
+        {
+            auto value = uint64_t{0};
+            for(auto shift = 0; shift < 64; shift += 7)
+            {
+                auto byte = getByte();
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if((byte & 0x80) == 0)
+                {
+                    return value;
+                }
+            }
+            ok_ = false;
+            return 0;
+        }
+
+        auto getBytes(size_t size) -> std::string_view
+        {
+            if(not require_(size))
+            {
+                return {};
+            }
+            auto bytes = data_.substr(pos_, size);
+            pos_ += size;
+            return bytes;
+        }
+
+    private:
+        auto require_(size_t size) -> bool
+        {
+            ok_ = ok_ and size <= data_.size() - pos_;
+            return ok_;
+        }
+
+        std::string_view data_;
+        size_t pos_ = 0;
+        bool ok_ = true;
+    };
+
+    // 写文件头：文件开头、追加写入已有文件时、网络连接建立后各写一次
+    auto PutFileHeader(LogBuffer& buf) -> void;
+
+    /**
+     * @brief 把事件编码进一个块：维护块内字典和时间戳增量，封块时加块头和 CRC
+     * @details 只负责编码，不管写到哪里：BinaryFileAppender 写文件，NetworkAppender 发到 socket
+     */
+    class BlockEncoder
+    {
+    public:
+        BlockEncoder();
+
+        // 把一条事件(以及它第一次用到的字典条目)编码进当前块，返回块负载增加的字节数
+        auto encode(const LogEvent& event) -> size_t;
+
+        [[nodiscard]] auto size() const -> size_t { return block_.size(); }
+        [[nodiscard]] auto empty() const -> bool { return block_.empty(); }
+        [[nodiscard]] auto payload() const -> std::string_view { return block_.view(); }
+
+        // 把当前块的块头(魔数、负载长度、CRC)追加到 out，负载由调用者随后写出
+        auto putBlockHeader(LogBuffer& out) const -> void;
+
+        // 块头和负载一起追加到 out，然后开始新块
+        auto sealInto(LogBuffer& out) -> void;
+
+        // 丢弃当前块负载并清空字典，开始新块
+        auto reset() -> void;
+
+    private:
+        // 源码位置的字典键：文件名、函数名都是静态字符串，比较地址即可
+        struct SiteKey{
+            const char* file_ = nullptr;
+            const char* function_ = nullptr;
+            uint32_t line_ = 0;
+
+            auto operator==(const SiteKey&) const -> bool = default;
+        };
+
+        struct SiteKeyHash{
+            auto operator()(const SiteKey& key) const noexcept -> size_t;
+        };
+
+        auto nameId_(NameId name) -> uint32_t;
+        auto staticStringId_(std::string_view text) -> uint32_t;
+        auto siteId_(const LogEvent& event) -> uint32_t;
+        auto putString_(uint32_t id, std::string_view text) -> void;
+
+        LogBuffer block_;                   // 当前块的负载
+        int64_t last_timestamp_us_ = 0;     // 块内上一条事件的时间戳，封块后归零
+
+        // 字典：当前块里已经写过的字符串和源码位置，封块时清空
+        std::vector<uint32_t> name_ids_;                            // NameId -> 字符串 id，0 表示还没写过
+        std::unordered_map<const char*, uint32_t> string_ids_;      // 静态字符串(格式串、文件名、函数名)地址 -> 字符串 id
+        std::unordered_map<SiteKey, uint32_t, SiteKeyHash> site_ids_;
+        uint32_t next_string_id_ = 1;
+        uint32_t next_site_id_ = 1;
+    };
+
+} // namespace BinaryLog
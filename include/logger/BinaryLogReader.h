@@ -0,0 +1,63 @@
+#pragma once
+
+#include "logger/BinaryLogFormat.h"
+#include "logger/LogEvent.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+/**
+ * @brief 读取 BinaryFileAppender 写出的文件，逐条还原成 LogEvent，之后交给任意 LogFormatter 输出
+ * @details - 整个文件一次读入内存
+ *          - CRC 不对或结构损坏的块整块跳过并计数，然后向后寻找下一个块头继续读，每块自带字典，后面的块不受影响
+ *          - 还原出的事件引用的文件名/函数名/行号(LogEvent::SourceSite)和字段键由 reader 持有，reader 销毁后不能再格式化这些事件
+ *          - 不认识的级别字节还原成 LogLevel::UNKNOW
+ *          - 文件里可以混有不同版本的文件头(旧文件上追加写入)，每段按自己的版本解码
+ * @code
+ *     auto reader = BinaryLogReader{"app.bin"};
+ *     auto event = LogEvent{};
+ *     while(reader.next(event)) { formatter.format(std::cout, event); }
+ * @endcode
+ */
+class BinaryLogReader{
+public:
+    // 文件打不开时抛 std::system_error，文件头不对时抛 std::runtime_error
+    explicit BinaryLogReader(const std::string& filename);
+
+    // 读出下一条事件，文件读完返回 false
+    auto next(LogEvent& event) -> bool;
+
+    [[nodiscard]] auto getCorruptBlocks() const -> size_t { return corrupt_blocks_; }
+
+    // 按格式串和原始参数字节还原消息文本，解码失败的占位符原样输出
+    static auto RenderArgs(std::string_view fmt, std::span<const ArgType> types, std::string_view bytes) -> std::string;
+
+private:
+    auto readFileHeader_() -> bool;
+
+    // 定位并校验下一个块，文件结束时返回 false
+    auto nextBlock_() -> bool;
+
+    // 读一个字典条目或事件，读到事件时返回 true
+    auto readEntry_(LogEvent& event) -> bool;
+
+    auto lookupString_(uint64_t id) const -> std::string_view;
+
+    std::string data_;
+    size_t pos_ = 0;
+    BinaryLog::Cursor block_;
+    uint32_t version_ = BinaryLog::c_version;   // 最近一个文件头的版本号，决定后面的块怎么解码
+    int64_t last_timestamp_us_ = 0;
+    size_t corrupt_blocks_ = 0;
+
+    // 当前块的字典：id -> 内容。存储只增不减，换块时只清空映射，已经还原出的事件仍然有效
+    std::deque<std::string> string_storage_;
+    std::deque<LogEvent::SourceSite> site_storage_;
+    std::unordered_map<uint64_t, const std::string*> strings_;
+    std::unordered_map<uint64_t, const LogEvent::SourceSite*> sites_;
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "common/alias.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+
+/**
+ * @brief 单个调用点的限流规格，用指定初始化写：RateLimit{.per_second = 10, .burst = 20}
+ * @details - one_in     : 1-in-N 采样，每 N 次调用放过第 1 次；1 表示不采样
+ *          - per_second : 令牌桶，每秒补充这么多个令牌，最多攒 burst 个；0 表示不限速
+ *          - 两者都设置时先采样，采中的再过令牌桶
+ *          - 被挡掉的调用只计数，每隔 summary_interval 由该调用点补一条 "suppressed N similar messages"
+ */
+struct RateLimit{
+    uint32_t one_in = 1;
+    uint32_t per_second = 0;
+    uint32_t burst = 1;
+    std::chrono::milliseconds summary_interval {1'000};
+};
+
+/**
+ * @brief 一个调用点的限流状态，日志宏在每个调用点放一个静态实例(所以天然按源码位置区分)
+ * @details - 放行路径上没有原子读改写：采样计数和令牌桶(GCRA，只有一个"理论到达时间")都是 relaxed 读 + 写。
+ *            多个线程同时打同一个调用点时可能丢掉几次更新，结果是多放行几条，对日志限流可以接受；
+ *            被挡掉的条数用 fetch_add，汇总的数字是准的
+ *          - 时间取 CLOCK_MONOTONIC_COARSE(vdso 里读一次内存，精度是一个时钟节拍)，
+ *            只在设置了令牌桶、或者放行时有被挡掉的调用等着汇总时才读
+ *          - 汇总跟着之后某次放行的调用一起输出，从第一次有计数要汇总时开始计时，每个 summary_interval 最多一条；
+ *            洪水期间采样和令牌桶都会定期放行，汇总也就定期出现。调用点之后再也不被调用的话，最后一段的计数不会输出
+ *          - 独占缓存行，不同调用点之间没有伪共享
+ */
+class alignas(c_k_cache_line) CallSiteLimiter{
+public:
+    struct Decision{
+        bool allowed_ = true;           // 这次调用的日志是否输出
+        uint64_t suppressed_ = 0;       // 非 0 时先输出一条汇总：上次汇总以来被挡掉的条数，只在放行时出现
+    };
+
+    constexpr explicit CallSiteLimiter(RateLimit limit)
+        : one_in_{std::max(limit.one_in, uint32_t{1})}
+        , interval_ns_{limit.per_second == 0 ? 0 : c_k_ns_per_second / limit.per_second}
+        , tolerance_ns_{interval_ns_ * (std::max(limit.burst, uint32_t{1}) - 1)}
+        , summary_interval_ns_{std::chrono::duration_cast<std::chrono::nanoseconds>(limit.summary_interval).count()}
+    {}
+
+    auto check() -> Decision { return check_(&NowNs); }
+
+    // 指定当前时间(单调时钟纳秒)，测试用
+    auto check(int64_t now_ns) -> Decision { return check_([now_ns]{ return now_ns; }); }
+
+    // 限流使用的单调时钟
+    static auto NowNs() -> int64_t
+    {
+        timespec ts{};
+        ::clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+        return static_cast<int64_t>(ts.tv_sec) * c_k_ns_per_second + ts.tv_nsec;
+    }
+
+private:
+    static constexpr int64_t c_k_ns_per_second = 1'000'000'000;
+
+    template <typename Now>
+    auto check_(Now&& now_func) -> Decision
+    {
+        auto allowed = sample_();
+        auto now = int64_t{0};
+        if(allowed and interval_ns_ != 0)
+        {
+            now = now_func();
+            allowed = takeToken_(now);
+        }
+        if(not allowed)
+        {
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return Decision{false, 0};
+        }
+        if(suppressed_.load(std::memory_order_relaxed) == 0) [[likely]]
+        {
+            return Decision{true, 0};
+        }
+        return Decision{true, takeSummary_(interval_ns_ != 0 ? now : now_func())};
+    }
+
+    // 倒数到 0 的那次调用采中，然后重新从 one_in_ - 1 开始倒数
+    auto sample_() -> bool
+    {
+        if(one_in_ == 1)
+        {
+            return true;
+        }
+        auto remaining = countdown_.load(std::memory_order_relaxed);
+        countdown_.store(remaining == 0 ? one_in_ - 1 : remaining - 1, std::memory_order_relaxed);
+        return remaining == 0;
+    }
+
+    // GCRA：theoretical_ 是按限速排下来的下一个令牌的时间，比 now 超前不超过 tolerance_ns_ 就放行并后移一格
+    auto takeToken_(int64_t now) -> bool
+    {
+        auto theoretical = theoretical_.load(std::memory_order_relaxed);
+        auto base = std::max(theoretical, now);
+        if(base - now > tolerance_ns_)
+        {
+            return false;
+        }
+        theoretical_.store(base + interval_ns_, std::memory_order_relaxed);
+        return true;
+    }
+
+    // 距上次汇总够久时，抢到汇总权的线程把计数清零取走；第一次有计数要汇总时只开始计时
+    auto takeSummary_(int64_t now) -> uint64_t
+    {
+        auto last = last_summary_ns_.load(std::memory_order_relaxed);
+        if(last == 0)
+        {
+            last_summary_ns_.compare_exchange_strong(last, now, std::memory_order_relaxed);
+            return 0;
+        }
+        if(now - last < summary_interval_ns_ or
+           not last_summary_ns_.compare_exchange_strong(last, now, std::memory_order_relaxed))
+        {
+            return 0;
+        }
+        return suppressed_.exchange(0, std::memory_order_relaxed);
+    }
+
+    // 配置，构造后不变
+    uint32_t one_in_;
+    int64_t interval_ns_;
+    int64_t tolerance_ns_;
+    int64_t summary_interval_ns_;
+
+    std::atomic<uint32_t> countdown_ = 0;
+    std::atomic<int64_t> theoretical_ = 0;
+    std::atomic<uint64_t> suppressed_ = 0;
+    std::atomic<int64_t> last_summary_ns_ = 0;     // 0 表示还没开始计时
+};
@@ -0,0 +1,147 @@
+#pragma once
+#include "common/alias.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+
+/**
+ * @brief 有界无锁缓冲池：AsyncLogger 的事件缓冲用完后放回这里，下次直接取，不再反复 new/delete
+ * @details 内部是一个多生产者/多消费者的有界环形队列，存放空闲缓冲的指针，做法同 MpscRingQueue：
+ *          每个槽位带序号 seq_，取和放都用 CAS 抢占游标，不会出现 ABA 问题
+ *          - seq == pos      : 槽位空，可以被 pos 号 put 写入
+ *          - seq == pos + 1  : 槽位里有缓冲，可以被 pos 号 get 取走
+ *          - get 取走后 seq = pos + capacity，留给下一圈的 put
+ *          - 池空时 get 现造一个，池满时 put 直接释放，所以池的大小只影响分配次数，不影响正确性
+ */
+template <typename Buffer>
+class EventBufferPool
+{
+    struct Slot
+    {
+        std::atomic<size_t> seq_;
+        Buffer* buffer_ = nullptr;
+    };
+
+public:
+    using BufferPtr = std::unique_ptr<Buffer>;
+
+    // capacity 向上取到 2 的幂；prewarm 个缓冲在构造时就分配好放进池里
+    EventBufferPool(size_t capacity, size_t prewarm)
+        : capacity_{std::bit_ceil(std::max<size_t>(capacity, 2))}
+        , slots_{std::make_unique<Slot[]>(capacity_)}
+    {
+        for(auto i = size_t{0}; i < capacity_; ++i)
+        {
+            slots_[i].seq_.store(i, std::memory_order_relaxed);
+        }
+        for(auto i = size_t{0}; i < std::min(prewarm, capacity_); ++i)
+        {
+            put(allocate_());
+        }
+    }
+
+    EventBufferPool(const EventBufferPool&)            = delete;
+    EventBufferPool(EventBufferPool&&)                 = delete;
+    EventBufferPool& operator=(const EventBufferPool&) = delete;
+    EventBufferPool& operator=(EventBufferPool&&)      = delete;
+
+    ~EventBufferPool()
+    {
+        // 取出来的 unique_ptr 随即析构，释放缓冲
+        while(tryGet_()) {}
+    }
+
+    // 取一个空缓冲，池空时现造一个
+    auto get() -> BufferPtr
+    {
+        if(auto buffer = tryGet_())
+        {
+            return buffer;
+        }
+        return allocate_();
+    }
+
+    // 归还缓冲：先清空，池满时直接释放
+    auto put(BufferPtr buffer) -> void
+    {
+        if(not buffer)
+        {
+            return;
+        }
+        buffer->reset();
+        auto pos = tail_.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            auto& slot = slots_[pos & (capacity_ - 1)];
+            auto seq = slot.seq_.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if(diff == 0)
+            {
+                if(tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot.buffer_ = buffer.release();
+                    slot.seq_.store(pos + 1, std::memory_order_release);
+                    return;
+                }
+            }
+            else if(diff < 0)
+            {
+                // 池已满
+                return;
+            }
+            else
+            {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 累计新分配的缓冲数(含预热)，稳定运行后应该不再增长
+    [[nodiscard]] auto allocatedCount() const -> size_t { return allocated_.load(std::memory_order_relaxed); }
+
+    [[nodiscard]] auto capacity() const -> size_t { return capacity_; }
+
+private:
+    auto allocate_() -> BufferPtr
+    {
+        allocated_.fetch_add(1, std::memory_order_relaxed);
+        return std::make_unique<Buffer>();
+    }
+
+    auto tryGet_() -> BufferPtr
+    {
+        auto pos = head_.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            auto& slot = slots_[pos & (capacity_ - 1)];
+            auto seq = slot.seq_.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if(diff == 0)
+            {
+                if(head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    auto buffer = BufferPtr{slot.buffer_};
+                    slot.seq_.store(pos + capacity_, std::memory_order_release);
+                    return buffer;
+                }
+            }
+            else if(diff < 0)
+            {
+                // 池空
+                return nullptr;
+            }
+            else
+            {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    const size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(c_k_cache_line) std::atomic<size_t> tail_{0};     // put 的游标
+    alignas(c_k_cache_line) std::atomic<size_t> head_{0};     // get 的游标
+    std::atomic<size_t> allocated_{0};
+};
@@ -2,6 +2,7 @@
 #include <array>
 #include <span>
 #include "LogEvent.h"
+#include "common/alias.h"
 
 // 定义缓冲区大小：储存 64 个 LogEvent
 constexpr size_t c_k_event_count = 64;
@@ -15,7 +16,7 @@ public:
     // 尝试将 LogEvent 写入缓冲区
     auto append(LogEvent event) -> bool
     {
-        if(count_ < c_k_event_count)
+        if(count_ < N)
         {
             data_[count_] = std::move(event);    // 复制 LogEvent 对象
             count_++;
@@ -31,10 +32,56 @@ public:
     // 获取事件数组的起始指针
     [[nodiscard]] std::span<const LogEvent> getEventSpan() const {return std::span<const LogEvent>(data_.data(), count_);}
     
-    // 清空缓冲区
-    void reset() {count_ = 0;}
+    // 就地格式化所有延迟格式化的事件(后台线程在交给 appender 前调用)
+    void materialize()
+    {
+        for(auto i = size_t{0}; i < count_; ++i)
+        {
+            data_[i].materialize();
+        }
+    }
+
+    // 清空缓冲区，顺带归还长消息占用的溢出块
+    void reset()
+    {
+        for(auto i = size_t{0}; i < count_; ++i)
+        {
+            data_[i].clearContent();
+        }
+        count_ = 0;
+    }
+
+    /**
+     * @brief 只保留满足 pred 的事件（保持原有顺序）
+     * @return 被移除的事件数量
+     */
+    template <typename Pred>
+    auto retainIf(Pred&& pred) -> size_t
+    {
+        auto kept = size_t{0};
+        for(auto i = size_t{0}; i < count_; ++i)
+        {
+            if(pred(static_cast<const LogEvent&>(data_[i])))
+            {
+                if(kept != i)
+                {
+                    data_[kept] = std::move(data_[i]);
+                }
+                ++kept;
+            }
+        }
+        auto removed = count_ - kept;
+        for(auto i = kept; i < count_; ++i)
+        {
+            data_[i].clearContent();
+        }
+        count_ = kept;
+        return removed;
+    }
     
 private:
-    EventArray data_;
-    size_t count_ = 0;  // 当前存储的事件数量，代替了原来的字节偏移
+    // count_ 生产者每次 append 都要写，单独占一个缓存行放在数组前面；
+    // 事件数组从缓存行边界开始，LogEvent 是缓存行的整数倍(192 字节)时每个事件都正好占满几行，消费者顺序扫描不跨行拆读
+    alignas(c_k_cache_line) size_t count_ = 0;  // 当前存储的事件数量，代替了原来的字节偏移
+    alignas(c_k_cache_line) EventArray data_;
 };
\ No newline at end of file
@@ -0,0 +1,160 @@
+#pragma once
+
+#include "logger/TextKernels.h"
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @brief 格式化输出用的连续可增长字节缓冲
+ * @details 各个 FormatItem 直接追加到这里，写入长度就是 size() 的差值，不再需要 ostream::tellp()；
+ *          appender 拿到整段字节后一次写出。clear() 保留容量，反复使用时不再分配。
+ *          追加都是内联的：一次容量比较加 TextKernels 的拷贝/整数转换，只有扩容时才调用函数
+ */
+class LogBuffer
+{
+public:
+    static constexpr size_t c_k_initial_capacity = 512;
+
+    LogBuffer() { reserve(c_k_initial_capacity); }
+
+    LogBuffer(const LogBuffer& other) { append(other.view()); }
+
+    LogBuffer(LogBuffer&& other) noexcept
+        : data_{std::move(other.data_)}
+        , size_{std::exchange(other.size_, 0)}
+        , capacity_{std::exchange(other.capacity_, 0)}
+    {}
+
+    auto operator=(const LogBuffer& other) -> LogBuffer&
+    {
+        if(this != &other)
+        {
+            clear();
+            append(other.view());
+        }
+        return *this;
+    }
+
+    auto operator=(LogBuffer&& other) noexcept -> LogBuffer&
+    {
+        data_ = std::move(other.data_);
+        size_ = std::exchange(other.size_, 0);
+        capacity_ = std::exchange(other.capacity_, 0);
+        return *this;
+    }
+
+    ~LogBuffer() = default;
+
+    auto append(std::string_view text) -> void { append(text.data(), text.size()); }
+
+    auto append(const char* text, size_t size) -> void
+    {
+        TextKernels::CopyBytes(prepare_(size), text, size);
+        size_ += size;
+    }
+
+    auto push_back(char c) -> void
+    {
+        *prepare_(1) = c;
+        ++size_;
+    }
+
+    // 整数直接转成十进制写入，不经过 locale，也不经过临时数组
+    template <std::integral T>
+    auto appendInt(T value) -> void
+    {
+        using U = std::make_unsigned_t<T>;
+        auto magnitude = static_cast<uint64_t>(static_cast<U>(value));
+        auto negative = false;
+        if constexpr (std::is_signed_v<T>)
+        {
+            negative = value < 0;
+            magnitude = negative ? uint64_t{0} - static_cast<uint64_t>(static_cast<int64_t>(value)) : magnitude;
+        }
+        auto digits = TextKernels::DecimalDigits(magnitude);
+        auto* out = prepare_(digits + negative);
+        *out = '-';
+        TextKernels::WriteDecimal(out + negative, magnitude, digits);
+        size_ += digits + negative;
+    }
+
+    /**
+     * @brief 定宽十进制，不足补 0(如毫秒 7 -> "007")，超出宽度时只保留低位，宽度最多 10 位
+     * @details 每次查表输出两位，比 to_chars + 手动补零少一半除法
+     */
+    auto appendFixed(uint32_t value, size_t width) -> void
+    {
+        constexpr char c_digit_pairs[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+        width = std::min(width, size_t{10});
+        auto* digits = prepare_(width);
+        auto pos = width;
+        while(pos >= 2)
+        {
+            auto pair = (value % 100) * 2;
+            value /= 100;
+            digits[--pos] = c_digit_pairs[pair + 1];
+            digits[--pos] = c_digit_pairs[pair];
+        }
+        if(pos == 1)
+        {
+            digits[0] = static_cast<char>('0' + value % 10);
+        }
+        size_ += width;
+    }
+
+    [[nodiscard]] auto data() const -> const char* { return data_.get(); }
+    [[nodiscard]] auto size() const -> size_t { return size_; }
+    [[nodiscard]] auto empty() const -> bool { return size_ == 0; }
+    [[nodiscard]] auto view() const -> std::string_view { return {data_.get(), size_}; }
+
+    auto clear() -> void { size_ = 0; }
+
+    auto reserve(size_t capacity) -> void
+    {
+        if(capacity > capacity_)
+        {
+            grow_(capacity);
+        }
+    }
+
+    // 供 std::format_to(std::back_inserter(buffer), ...) 使用
+    using value_type = char;
+
+private:
+    // 保证末尾至少还有 size 字节可写，返回写入位置
+    auto prepare_(size_t size) -> char*
+    {
+        if(size > capacity_ - size_) [[unlikely]]
+        {
+            grow_(std::max(size_ + size, capacity_ * 2));
+        }
+        return data_.get() + size_;
+    }
+
+    // 换到一块容量为 capacity 的新内存，已有内容拷过去
+    auto grow_(size_t capacity) -> void
+    {
+        auto data = std::make_unique_for_overwrite<char[]>(capacity);
+        if(size_ != 0)
+        {
+            std::memcpy(data.get(), data_.get(), size_);
+        }
+        data_ = std::move(data);
+        capacity_ = capacity;
+    }
+
+    std::unique_ptr<char[]> data_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+};
@@ -1,42 +1,108 @@
 #pragma once
 #include "LogLevel.h"
+#include "LogName.h"
 #include <source_location>
+#include <array>
 #include <cstdint>
-#include <sstream>
 #include <memory>
+#include <algorithm>
 #include <format>
+#include <span>
+#include <chrono>
 #include <ctime>
+#include <cstring>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
 
 
+/**
+ * @brief 延迟参数的类型标记，二进制日志按它原样写出参数字节，离线解码时再格式化
+ * @details 枚举、long double 以及特化了 IsDeferrable 的自定义类型记为 Other，只能在本进程内格式化
+ */
+enum class ArgType : uint8_t
+{
+    Bool, Char, Int8, UInt8, Int16, UInt16, Int32, UInt32, Int64, UInt64, Float, Double, Pointer, Null, Other,
+};
 
+template <typename T>
+consteval auto ArgTypeOf() -> ArgType
+{
+    if constexpr (std::is_same_v<T, bool>) return ArgType::Bool;
+    else if constexpr (std::is_same_v<T, char>) return ArgType::Char;
+    else if constexpr (std::is_same_v<T, std::nullptr_t>) return ArgType::Null;
+    else if constexpr (std::is_same_v<T, void*> or std::is_same_v<T, const void*>) return ArgType::Pointer;
+    else if constexpr (std::is_same_v<T, float>) return ArgType::Float;
+    else if constexpr (std::is_same_v<T, double>) return ArgType::Double;
+    else if constexpr (std::is_integral_v<T> and (sizeof(T) == 1 or sizeof(T) == 2 or sizeof(T) == 4 or sizeof(T) == 8))
+    {
+        constexpr auto c_index = sizeof(T) == 1 ? 0 : sizeof(T) == 2 ? 1 : sizeof(T) == 4 ? 2 : 3;
+        constexpr ArgType c_signed[] = {ArgType::Int8, ArgType::Int16, ArgType::Int32, ArgType::Int64};
+        constexpr ArgType c_unsigned[] = {ArgType::UInt8, ArgType::UInt16, ArgType::UInt32, ArgType::UInt64};
+        return std::is_signed_v<T> ? c_signed[c_index] : c_unsigned[c_index];
+    }
+    else return ArgType::Other;
+}
+
+/**
+ * @brief 参数能否延迟格式化：值必须可以按字节拷贝，且不引用调用方的内存
+ * @details 字符串、string_view、const char* 等在后台线程格式化时可能已经失效，所以默认不延迟；
+ *          自定义的纯值类型(有 std::formatter)可以特化本模板来打开延迟格式化
+ */
+template <typename T>
+struct IsDeferrable : std::bool_constant<std::is_arithmetic_v<T>
+                                      or std::is_enum_v<T>
+                                      or std::is_same_v<T, void*>
+                                      or std::is_same_v<T, const void*>
+                                      or std::is_same_v<T, std::nullptr_t>> {};
+
+/**
+ * @brief 日志事件
+ * @details 布局紧凑且不做堆分配：
+ *          - 日志器名称、线程名称只保存驻留表句柄(NameId)
+ *          - 消息优先写入内联缓冲，放不下时才从 MessageArena 取溢出块
+ *          - 结构化字段(with())紧跟在消息后面，和消息共用同一块存储
+ *          - 可平凡搬移：移动只是拷贝字段并把溢出块的所有权转给新对象，
+ *            所以把事件移入 EventFixedBuffer 只是一次小拷贝
+ */
 class LogEvent{
 public:
     using Sptr = std::shared_ptr<LogEvent>;
 
+    // 内联消息缓冲大小，使 sizeof(LogEvent) 正好是 3 个缓存行
+    static constexpr size_t c_k_inline_msg_size = 128;
+    static constexpr int64_t c_k_us_per_second = 1'000'000;
+
     LogEvent() = default;
     LogEvent(const LogEvent&) = delete;
-    LogEvent(LogEvent &&) noexcept = default;
+    LogEvent& operator=(const LogEvent& ) = delete;
 
     // LogEvent&&：这是 右值引用。意思是这个构造函数的参数是一个“临时对象”或者“即将销毁的对象”。
-    LogEvent& operator=(const LogEvent& ) = default;
-    LogEvent& operator=(LogEvent&&) = default;
+    LogEvent(LogEvent&& other) noexcept;
+    LogEvent& operator=(LogEvent&& other) noexcept;
 
     /**
      * @brief 构造函数
-     * @param logger_name 日志器名称
+     * @param logger_name 日志器名称句柄
      * @param level 日志级别
      * @param elapse 程序启动依赖的耗时(毫秒)
      * @param thread_id 线程id
-     * @param thread_name 线程名称
-     * @param time 日志事件(UTC秒)
+     * @param thread_name 线程名称句柄
+     * @param time 日志事件(UTC秒)，需要秒以下精度时再调用 setTimePoint()
      * @param co_id 协程id
      * @param source_loc 源码位置信息
      */
-    LogEvent(std::string logger_name, LogLevel level, uint32_t elapse, uint32_t thread_id, std::string thread_name, time_t timestamp, uint32_t co_id, std::source_location source_loc = std::source_location::current());
+    LogEvent(NameId logger_name, LogLevel level, uint32_t elapse, uint32_t thread_id, NameId thread_name, time_t timestamp, uint32_t co_id, std::source_location source_loc = std::source_location::current());
 
-    ~LogEvent() = default;
+    // 同上，名称先登记到驻留表(命中线程局部缓存时不加锁)
+    LogEvent(std::string_view logger_name, LogLevel level, uint32_t elapse, uint32_t thread_id, std::string_view thread_name, time_t timestamp, uint32_t co_id, std::source_location source_loc = std::source_location::current());
 
-    std::string_view getLoggerName() const & {return logger_name_;}
+    ~LogEvent() { releaseOverflow_(); }
+
+    std::string_view getLoggerName() const {return LogNameRegistry::Lookup(logger_name_);}
+
+    NameId getLoggerNameId() const {return logger_name_;}
 
     LogLevel getLevel() const {return level_;}
 
@@ -44,36 +110,317 @@ public:
 
     uint32_t getThreadId() const {return thread_id_;}
 
-    std::string_view getThreadName() const & {return thread_name_;}
+    std::string_view getThreadName() const {return LogNameRegistry::Lookup(thread_name_);}
+
+    NameId getThreadNameId() const {return thread_name_;}
+
+    // 日志时间(UTC秒)
+    std::time_t getTime() const {return static_cast<std::time_t>(timestamp_us_ / c_k_us_per_second);}
+
+    // 秒以下的部分(微秒，0~999999)
+    uint32_t getMicrosecond() const {return static_cast<uint32_t>(timestamp_us_ % c_k_us_per_second);}
+
+    // 带微秒精度的日志时间，构造时只给了秒的话可以再用它补上
+    void setTimePoint(std::chrono::system_clock::time_point time_point) {
+        timestamp_us_ = std::chrono::duration_cast<std::chrono::microseconds>(time_point.time_since_epoch()).count();
+    }
 
-    std::time_t getTime() const {return timestamp_;}
-    
     uint32_t getFiberId() const {return co_id_;}
 
-    std::string getContent() const {return custom_msg_.str();}
+    // 延迟格式化的事件在 materialize() 之前没有文本，返回空
+    std::string_view getContent() const & {return isDeferred() ? std::string_view{} : std::string_view{overflow_ != nullptr ? overflow_ : inline_msg_, msg_len_};}
+
+    std::string_view getFilename() const {return has_site_ ? location_.site_->file_ : location_.source_loc_.file_name();}
 
-    std::stringstream& getSS() {return custom_msg_;}
+    std::string_view getFunctionName() const {return has_site_ ? location_.site_->function_ : location_.source_loc_.function_name();}
 
-    std::string getFilename() const {return source_loc_.file_name();}
+    auto getLine() const -> uint32_t {return has_site_ ? location_.site_->line_ : location_.source_loc_.line();}
 
-    std::string getFunctionName() const {return source_loc_.function_name();}
-    
-    auto getLine() const -> uint32_t {return source_loc_.line();}
+    /** @brief 不经 std::source_location 表示的源码位置，BinaryLogReader 还原事件时使用 */
+    struct SourceSite
+    {
+        const char* file_ = "";
+        const char* function_ = "";
+        uint32_t line_ = 0;
+    };
+
+    // 源码位置改为 site 里的文件名、函数名和行号；site 必须比事件活得久
+    void setSourceSite(const SourceSite* site) {location_.site_ = site; has_site_ = true;}
 
     template <typename... Args>
     void print(std::format_string<Args...> fmt, Args&&... args){
-        custom_msg_ << std::format(fmt, std::forward<Args>(args)...);
+        if(fields_len_ != 0) [[unlikely]]
+        {
+            // 消息后面已经有字段，格式化好后整段插到字段前面
+            vprint_(fmt.get(), std::make_format_args(args...));
+            return;
+        }
+        materialize();
+        // 先尝试直接格式化进剩余空间，大多数消息到这里就结束了
+        auto room = capacity_() - msg_len_;
+        // std::format 系列只读取参数、从不移走它们，所以下面可以安全地转发两次
+        auto result = std::format_to_n(tail_(), static_cast<std::ptrdiff_t>(room), fmt, std::forward<Args>(args)...);
+        auto needed = static_cast<size_t>(result.size);
+        if(needed <= room)
+        {
+            msg_len_ += static_cast<uint32_t>(needed);
+            return;
+        }
+        // 放不下：换到足够大的溢出块后再格式化一次
+        reserve_(msg_len_ + needed);
+        std::format_to_n(tail_(), static_cast<std::ptrdiff_t>(needed), fmt, std::forward<Args>(args)...);
+        msg_len_ += static_cast<uint32_t>(needed);
+    }
+
+    /**
+     * @brief 延迟格式化：只记录格式串和参数的字节拷贝，真正的 std::format 留给后台线程
+     * @details 格式串必须是字面量(静态存储期)。参数中有不能延迟的类型、参数放不进内联缓冲、
+     *          或者事件里已经有内容时，退化为 print() 立即格式化
+     */
+    template <typename... Args>
+    void printDeferred(std::format_string<Args...> fmt, Args&&... args){
+        using Pack = DeferredPack_<std::remove_cvref_t<Args>...>;
+        if constexpr (Pack::c_deferrable)
+        {
+            if(msg_len_ == 0 and fields_len_ == 0 and overflow_ == nullptr and not isDeferred())
+            {
+                auto fmt_view = fmt.get();
+                std::memcpy(inline_msg_, &fmt_view, sizeof(fmt_view));
+                Pack::Store(inline_msg_ + sizeof(fmt_view), args...);
+                msg_len_ = static_cast<uint32_t>(sizeof(fmt_view) + Pack::c_size);
+                deferred_ = &Pack::c_layout;
+                return;
+            }
+        }
+        print(fmt, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief 附加一个结构化字段，比如 event.with("user_id", id).with("path", path)
+     * @details - 键必须是字符串字面量：只保存指针，不拷贝
+     *          - 数值、bool、char、指针按原始字节保存，调用点不做任何字符串转换；枚举按底层整数保存
+     *          - 字符串(std::string、string_view、const char*)拷贝进事件；其余有 std::formatter 的类型格式化成字符串
+     *          - 字段跟在消息后面：先 printDeferred 再 with，顺序反过来时 printDeferred 会退化为立即格式化
+     *          - 单个事件的字段总共不超过 c_k_max_fields_bytes 字节，放不下的字段丢弃
+     */
+    template <size_t N, typename T>
+    auto with(const char (&key)[N], const T& value) -> LogEvent&
+    {
+        addField_(std::string_view{key, N - 1}, value);
+        return *this;
+    }
+
+    /**
+     * @brief 已经按类型拆好的字段，BinaryLogReader 还原事件时使用
+     * @param key 必须比事件活得久(字面量或驻留的字符串)
+     * @param type 数值的类型；ArgType::Other 表示 value 是字符串
+     */
+    void addRawField(std::string_view key, ArgType type, std::span<const char> value);
+
+    /** @brief 一个结构化字段：type 是数值的类型，ArgType::Other 表示字符串，value 是原始字节或字符串文本 */
+    struct Field
+    {
+        std::string_view key_;
+        ArgType type_;
+        std::span<const char> value_;
+
+        [[nodiscard]] auto text() const -> std::string_view { return {value_.data(), value_.size()}; }
+
+        // 按保存时的类型取出数值，T 必须与 type_ 对应
+        template <typename T>
+        [[nodiscard]] auto as() const -> T
+        {
+            auto result = T{};
+            std::memcpy(&result, value_.data(), std::min(sizeof(T), value_.size()));
+            return result;
+        }
+    };
+
+    [[nodiscard]] auto hasFields() const -> bool {return fields_len_ != 0;}
+
+    // 按添加顺序访问每个字段
+    template <typename Func>
+    void forEachField(Func&& func) const
+    {
+        const auto* pos = storage_() + msg_len_;
+        const auto* end = pos + fields_len_;
+        while(pos < end)
+        {
+            auto header = FieldHeader_{};
+            std::memcpy(&header, pos, sizeof(header));
+            pos += sizeof(header);
+            func(Field{std::string_view{header.key_, header.key_len_}, header.type_,
+                       std::span<const char>{pos, header.value_len_}});
+            pos += header.value_len_;
+        }
     }
 
+    // 是否还有未格式化的延迟参数
+    bool isDeferred() const {return deferred_ != nullptr;}
+
+    /** @brief 延迟事件的原始参数：格式串、各参数的类型、按顺序紧密排列的参数字节 */
+    struct DeferredArgs
+    {
+        std::string_view format_;
+        std::span<const ArgType> types_;
+        std::span<const char> bytes_;
+    };
+
+    // 只在 isDeferred() 时有意义，二进制 appender 用它直接写出参数而不格式化
+    auto getDeferredArgs() const -> DeferredArgs;
+
+    // 返回一个已格式化的副本，原事件不变；可以在只拿到 const 引用的消费端使用
+    auto rendered() const -> LogEvent;
+
+    // 就地格式化延迟参数，之后 getContent() 返回最终文本
+    void materialize() { if(isDeferred()) { *this = rendered(); } }
+
+    // 直接追加一段已经格式化好的文本
+    void append(std::string_view text);
+
+    // 清空消息和字段，归还溢出块
+    void clearContent() { releaseOverflow_(); msg_len_ = 0; fields_len_ = 0; deferred_ = nullptr; }
+
+    // 单个事件全部字段(含每个字段 12 字节的头)的上限
+    static constexpr size_t c_k_max_fields_bytes = UINT16_MAX;
+
 private:
-    std::string logger_name_;
-    LogLevel level_;
-    uint32_t elapse_;
-    uint32_t thread_id_;
-    std::string thread_name_;
-    std::time_t timestamp_;
-    uint32_t co_id_;
-    std::source_location source_loc_;
-    std::stringstream custom_msg_;
-
-};
\ No newline at end of file
+    // 每个字段的头，后面紧跟值的字节；整体按字节拷贝，不要求对齐
+    struct FieldHeader_
+    {
+        ArgType type_;
+        uint8_t key_len_;
+        uint16_t value_len_;
+        const char* key_;
+    };
+
+    template <typename T>
+    void addField_(std::string_view key, const T& value)
+    {
+        using V = std::remove_cvref_t<T>;
+        if constexpr (std::is_enum_v<V>)
+        {
+            addField_(key, std::to_underlying(value));
+        }
+        else if constexpr (ArgTypeOf<V>() != ArgType::Other)
+        {
+            putField_(key, ArgTypeOf<V>(), &value, sizeof(V));
+        }
+        else if constexpr (std::is_convertible_v<const T&, std::string_view>)
+        {
+            auto text = std::string_view{value};
+            putField_(key, ArgType::Other, text.data(), text.size());
+        }
+        else
+        {
+            auto text = std::format("{}", value);
+            putField_(key, ArgType::Other, text.data(), text.size());
+        }
+    }
+
+    // 在字段区末尾追加一个字段，放不下时丢弃
+    void putField_(std::string_view key, ArgType type, const void* value, size_t size);
+
+    // 把 from 的字段区原样接到本事件的字段区后面
+    void copyFields_(const LogEvent& from);
+
+    // 把延迟参数格式化进 out，payload 是消息存储开头保存的格式串 + 参数字节
+    using RenderFunc = void (*)(const char* payload, LogEvent& out);
+
+    // 每种参数组合一个静态实例：怎么格式化，以及各参数的类型
+    struct DeferredLayout_
+    {
+        RenderFunc render_;
+        const ArgType* types_;
+        uint32_t count_;
+    };
+
+    /**
+     * @brief 延迟参数的打包格式：各参数按顺序紧密排列，读写都用 memcpy，不要求对齐
+     */
+    template <typename... Ts>
+    struct DeferredPack_
+    {
+        static constexpr size_t c_size = (size_t{0} + ... + sizeof(Ts));
+        static constexpr bool c_deferrable = (IsDeferrable<Ts>::value and ...)
+                                         and sizeof(std::string_view) + c_size <= c_k_inline_msg_size;
+        // 第 I 个参数在参数区的偏移
+        static constexpr auto c_offsets = []{
+            auto offsets = std::array<size_t, sizeof...(Ts) + 1>{};
+            auto sizes = std::array<size_t, sizeof...(Ts) + 1>{sizeof(Ts)..., 0};
+            for(auto i = size_t{1}; i < offsets.size(); ++i)
+            {
+                offsets[i] = offsets[i - 1] + sizes[i - 1];
+            }
+            return offsets;
+        }();
+
+        template <typename... Args>
+        static auto Store(char* dst, const Args&... args) -> void
+        {
+            [&]<size_t... I>(std::index_sequence<I...>){
+                (std::memcpy(dst + c_offsets[I], &args, sizeof(Ts)), ...);
+            }(std::index_sequence_for<Ts...>{});
+        }
+
+        static auto Render(const char* payload, LogEvent& out) -> void
+        {
+            auto fmt = std::string_view{};
+            std::memcpy(&fmt, payload, sizeof(fmt));
+            const auto* src = payload + sizeof(fmt);
+            [&]<size_t... I>(std::index_sequence<I...>){
+                // 没有参数时 args 是空 tuple，下一行用不到它
+                [[maybe_unused]] auto args = std::tuple<Ts...>{Load_<Ts>(src + c_offsets[I])...};
+                out.vprint_(fmt, std::make_format_args(std::get<I>(args)...));
+            }(std::index_sequence_for<Ts...>{});
+        }
+
+        template <typename T>
+        static auto Load_(const char* src) -> T
+        {
+            auto value = T{};
+            std::memcpy(&value, src, sizeof(T));
+            return value;
+        }
+
+        static constexpr std::array<ArgType, sizeof...(Ts)> c_types = {ArgTypeOf<Ts>()...};
+        static constexpr DeferredLayout_ c_layout = {&Render, c_types.data(), static_cast<uint32_t>(sizeof...(Ts))};
+    };
+
+    // 运行期格式串版本的 print，供延迟格式化在后台线程使用
+    void vprint_(std::string_view fmt, std::format_args args);
+
+    auto capacity_() const -> size_t {return overflow_ != nullptr ? overflow_cap_ : c_k_inline_msg_size;}
+    auto storage_() const -> const char* {return overflow_ != nullptr ? overflow_ : inline_msg_;}
+    auto storage_() -> char* {return overflow_ != nullptr ? overflow_ : inline_msg_;}
+    auto tail_() -> char* {return storage_() + msg_len_;}
+    // 保证消息容量至少为 size 字节
+    void reserve_(size_t size);
+    void releaseOverflow_();
+
+    // 源码位置：程序里产生的事件是 std::source_location，还原出的事件指向外部的 SourceSite，由 has_site_ 区分
+    union Location_
+    {
+        std::source_location source_loc_ {};
+        const SourceSite* site_;
+    };
+
+    Location_ location_;
+    int64_t timestamp_us_ = 0;     // UTC 微秒
+    char* overflow_ = nullptr;      // 溢出块，为空时消息在 inline_msg_ 里
+    NameId logger_name_ = LogNameRegistry::c_empty_id;
+    NameId thread_name_ = LogNameRegistry::c_empty_id;
+    LogLevel level_ = LogLevel::UNKNOW;
+    bool has_site_ = false;         // 同样放在 level_ 后的填充里
+    uint16_t fields_len_ = 0;       // 消息后面字段区的字节数，放在 level_ 后的填充里，不增大事件
+    uint32_t elapse_ = 0;
+    uint32_t thread_id_ = 0;
+    uint32_t co_id_ = 0;
+    uint32_t msg_len_ = 0;
+    uint32_t overflow_cap_ = 0;
+    const DeferredLayout_* deferred_ = nullptr;   // 非空时消息存储里是延迟格式化的参数
+    char inline_msg_[c_k_inline_msg_size];      // 消息(或延迟参数)，后面接着字段
+
+};
+
+static_assert(sizeof(LogEvent) == 192, "LogEvent 应当正好占 3 个缓存行");
@@ -1,8 +1,9 @@
 #pragma once
 #include <ostream>
+#include <span>
+#include <string>
 #include <vector>
-#include <memory>
-#include "logger/PatternItemProxy.hpp"
+#include "logger/PatternItems.hpp"
 
 class LogEvent;
 /**
@@ -10,7 +11,8 @@ class LogEvent;
  * - %m 消息
  * - %p 日志级别
  * - %c 日志器名称
- * - %d 日期时间，后面可跟一对括号指定时间格式，比如%%d{%%Y-%%m-%%d %%H:%%M:%%S}，这里的格式字符与 C 语言 strftime 一致
+ * - %d 日期时间，后面可跟一对括号指定时间格式，比如%%d{%%Y-%%m-%%d %%H:%%M:%%S}，这里的格式字符与 C 语言 strftime 一致，
+ *      另外可以用 %%L 输出毫秒(3位)、%%f 输出微秒(6位)，比如%%d{%%H:%%M:%%S.%%L}
  * - %r 该日志器创建后的累计运行毫秒数
  * - %f 文件名
  * - %l 行号
@@ -21,26 +23,50 @@ class LogEvent;
  * - %% 百分号
  * - %T 制表符
  * - %n 换行
+ * - %E JSON 转义后的消息
+ * - %j 结构化字段(LogEvent::with)，按 JSON 成员输出：,"key":value
+ * - %K 结构化字段，按 logfmt 输出：" key=value"
  *
  * 默认格式：%%d{%%Y-%%m-%%d %%H:%%M:%%S}%%T%%t%%T%%N%%T%%F%%T[%%p]%%T[%%c]%%T%%f:%%l%%T%%m%%n
  *
  * 默认格式描述：年-月-日 时:分:秒 [累计运行毫秒数] \t 线程id \t 线程名称 \t 协程id \t [日志级别] \t [日志器名称] \t 文件名:行号 \t 日志消息 换行符
  */
 
+// 默认格式，StaticLogFormatter<c_k_default_pattern> 可以在编译期使用同一个格式
+inline constexpr char c_k_default_pattern[] = "%d{%Y-%m-%d %H:%M:%S} [%rms] %t%T%N%T%F%T[%p]%T[%c]%T[%f:%l]%T[%v]%T%m%n";
+
+// 每行一个 JSON 对象，字段和时间、级别等平铺在同一层，下游直接按 JSON 解析
+inline constexpr char c_k_json_pattern[] =
+    R"({"time":"%d{%Y-%m-%dT%H:%M:%S.%f}","level":"%p","logger":"%c","thread":"%N","tid":%t,"msg":"%E"%j}%n)";
+
+// logfmt：level=INFO logger=root msg="..." key=value ...
+inline constexpr char c_k_logfmt_pattern[] = "time=%d{%Y-%m-%dT%H:%M:%S.%f} level=%p logger=%c tid=%t msg=\"%E\"%K%n";
+
 class LogFormatter{
 public:
-    explicit LogFormatter(std::string pattern = "%d{%Y-%m-%d %H:%M:%S} [%rms] %t%T%N%T%F%T[%p]%T[%c]%T[%f:%l]%T[%v]%T%m%n") :pattern_(move(pattern)){startParse_();}
+    explicit LogFormatter(std::string pattern = c_k_default_pattern) :pattern_(move(pattern)){startParse_();}
 
     [[nodiscard]] auto format(const LogEvent& event) const -> std::string;
 
+    /**
+     * @brief 把一条日志追加到 buf 末尾
+     * @return 追加的字节数
+     */
+    auto format(LogBuffer& buf, const LogEvent& event) const -> size_t;
+
+    // 先格式化到线程局部的 LogBuffer，再对 os 做一次 write
     auto format(std::ostream& os, const LogEvent& event) const -> size_t;
 
+    // 解析后的模式项，按顺序执行
+    [[nodiscard]] auto getItems() const -> std::span<const PatternItem> {return pattern_items_;}
+
 private:
     void startParse_();
 
     std::string pattern_;
     
-    std::vector<Sptr<PatternItemFacade>> pattern_items_;
+    // 编译后的模式：一段连续的 variant 数组，format 时顺序 visit
+    std::vector<PatternItem> pattern_items_;
 
     bool error_ = false;
 };
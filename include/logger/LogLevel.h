@@ -1,8 +1,11 @@
 #pragma once
 
+#include <cstdint>
 #include <string_view>
+#include <type_traits>
 
-enum class LogLevel
+// 单字节：LogEvent 里紧挨着它的两个字节放字段区长度，二进制日志里也按一个字节存
+enum class LogLevel : int8_t
 {
     /// 系统错误
     SYSFATAL = 9,
@@ -28,10 +31,25 @@ auto LevelToString(LogLevel level) -> std::string_view;
 
 auto StringToLogLevel(std::string_view str) -> LogLevel;
 
-auto operator<=(LogLevel lhs, LogLevel rhs) -> bool;
-auto operator>=(LogLevel lhs, LogLevel rhs) -> bool;
-auto operator<(LogLevel lhs, LogLevel rhs) -> bool;
-auto operator>(LogLevel lhs, LogLevel rhs) -> bool;
-auto operator==(LogLevel lhs, LogLevel rhs) -> bool;
+// 比较运算都是 constexpr：日志宏在编译期用它们丢弃低于 COTTON_MIN_LOG_LEVEL 的调用，运行期也能内联成一条比较指令
+constexpr auto operator<=(LogLevel lhs, LogLevel rhs) -> bool{
+    return static_cast<std::underlying_type_t<LogLevel>>(lhs) <= static_cast<std::underlying_type_t<LogLevel>>(rhs);
+}
+
+constexpr auto operator>(LogLevel lhs, LogLevel rhs) -> bool{
+    return not(lhs<=rhs);
+}
+
+constexpr auto operator==(LogLevel one, LogLevel two) -> bool{
+    return static_cast<std::underlying_type_t<LogLevel>>(one) == static_cast<std::underlying_type_t<LogLevel>>(two);
+}
+
+constexpr auto operator>=(LogLevel lhs, LogLevel rhs) -> bool{
+    return lhs > rhs or lhs == rhs;
+}
+
+constexpr auto operator<(LogLevel lhs, LogLevel rhs) -> bool{
+    return not(lhs >= rhs);
+}
 
 
@@ -1,33 +1,100 @@
+#pragma once
+
 #include "common/alias.h"
 #include "common/singleton.hpp"
 #include "common/util.hpp"
 
-#include <functional>
+#include <atomic>
+#include <cstddef>
+#include <deque>
 #include <mutex>
+#include <string>
 #include <string_view>
-#include <unordered_map>
+#include <vector>
 
 #define GET_ROOT_LOGGER() LoggerMgr::GetInstance().getRoot()
 
+// 名称是字符串字面量时哈希可以在编译期算好(见 LoggerName)
 #define GET_LOGGER_BY_NAME(name) LoggerMgr::GetInstance().getLogger(name)
 
-using LoggerMgr = Cot::Singleton<LoggerManager>;
-
 class Logger;
 
+/**
+ * @brief 查找日志器用的名称，连同名称的 FNV-1a 哈希一起传递
+ * @details 字符数组走 constexpr 构造：字面量在常量表达式里(如 constexpr 变量)构造时哈希在编译期算好，
+ *          优化编译时一般也会折叠；运行期的 char 缓冲(char buf[64])同样可以传，名称取到第一个 '\0' 为止。
+ *          std::string / std::string_view 在运行期计算
+ */
+class LoggerName{
+public:
+    template <size_t N>
+    constexpr LoggerName(const char (&name)[N]) : name_{name, Length_(name)}, hash_{UtilT::cHashString(name_)} {}
+
+    LoggerName(std::string_view name) : name_{name}, hash_{UtilT::cHashString(name)} {}
+
+    LoggerName(const std::string& name) : LoggerName(std::string_view{name}) {}
+
+    [[nodiscard]] constexpr auto view() const -> std::string_view { return name_; }
+    [[nodiscard]] constexpr auto hash() const -> UtilT::Hash_t { return hash_; }
+
+private:
+    // 没有 '\0' 的缓冲取整个数组
+    template <size_t N>
+    static constexpr auto Length_(const char (&name)[N]) -> size_t
+    {
+        auto pos = std::string_view{name, N}.find('\0');
+        return pos == std::string_view::npos ? N : pos;
+    }
+
+    std::string_view name_;
+    UtilT::Hash_t hash_;
+};
+
+/**
+ * @brief 日志器注册表
+ * @details - 名称按点分层级："a.b.c" 的父日志器是 "a.b"，"a" 的父日志器是 root，缺少的上级在创建时一并创建。
+ *            子日志器继承上级的级别和 appender(见 Logger::setParent)
+ *          - 查找无锁、不分配内存：开放寻址表里存条目指针，整张表以 RCU 方式发布，
+ *            读者一次 acquire 读拿到表，按 string_view 线性探测比较
+ *          - 只有创建新日志器时加锁：先插入当前表；装载率超过一半时建一张两倍大的新表整体发布。
+ *            条目和旧表都不释放(日志器本来就和注册表同寿命，旧表合计不超过当前表大小)，正在读旧表的线程不会悬空，
+ *            在旧表里没找到的读者会进入加锁路径重新查找
+ */
 class LoggerManager{
 public:
     LoggerManager();
     void init_();
     
-    auto getLogger(std::string_view logger_name) -> Sptr<Logger>;
+    auto getLogger(LoggerName logger_name) -> Sptr<Logger>;
     auto getRoot() -> Sptr<Logger> {return root_;}
 
 private:
+    struct Entry{
+        UtilT::Hash_t hash_;
+        std::string name_;
+        Sptr<Logger> logger_;
+    };
+
+    struct Table{
+        explicit Table(size_t capacity) : mask_{capacity - 1}, slots_(capacity) {}
+        size_t mask_;
+        std::vector<std::atomic<const Entry*>> slots_;
+    };
+
+    static constexpr size_t c_initial_capacity = 64;
+
+    static auto Find_(const Table& table, std::string_view name, UtilT::Hash_t hash) -> const Entry*;
+    static auto Insert_(Table& table, const Entry& entry) -> void;
+
+    // 查找或创建(连同缺少的上级)，调用时持有 mtx_
+    auto getOrCreate_(std::string_view name, UtilT::Hash_t hash) -> const Entry&;
+
     mutable std::mutex mtx_;
     Sptr<Logger> root_;
-    // std::unordered_map< std::string, Sptr<Logger>, UtilT::Hasher, std::equal_to<> > loggers_;
-    std::unordered_map<std::string, Sptr<Logger>> loggers_;
+    // 当前表；entries_、tables_ 只在 mtx_ 下追加
+    std::atomic<Table*> table_ = nullptr;
+    std::deque<Entry> entries_;
+    std::vector<Uptr<Table>> tables_;
 };
 
-
+using LoggerMgr = Cot::Singleton<LoggerManager>;
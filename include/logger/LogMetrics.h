@@ -0,0 +1,109 @@
+#pragma once
+
+#include "common/alias.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief 按 2 的幂分桶的直方图，记录延迟(纳秒)、批大小这类非负整数
+ * @details - 第 i 个桶统计 bit_width(value) == i 的值，即 [2^(i-1), 2^i)，0 号桶只有 0
+ *          - record() 只是几次 relaxed 原子操作，可以多个线程同时调用；snapshot() 不加锁，各字段之间可能差几次 record
+ */
+class Histogram{
+public:
+    static constexpr size_t c_buckets = 65;
+
+    struct Snapshot{
+        std::array<uint64_t, c_buckets> buckets {};
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        uint64_t max = 0;
+
+        [[nodiscard]] auto mean() const -> double
+        {
+            return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+        }
+
+        // 第 q 分位(0~1)所在桶的上界，不超过 max；分桶只能给出 2 倍以内的近似值
+        [[nodiscard]] auto percentile(double q) const -> uint64_t
+        {
+            auto target = static_cast<uint64_t>(q * static_cast<double>(count));
+            auto seen = uint64_t{0};
+            for(auto i = size_t{0}; i < c_buckets; ++i)
+            {
+                seen += buckets[i];
+                if(seen > target)
+                {
+                    auto upper = i == 0 ? uint64_t{0} : (i >= 64 ? UINT64_MAX : (uint64_t{1} << i) - 1);
+                    return std::min(upper, max);
+                }
+            }
+            return max;
+        }
+    };
+
+    auto record(uint64_t value) -> void
+    {
+        buckets_[static_cast<size_t>(std::bit_width(value))].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        auto max = max_.load(std::memory_order_relaxed);
+        while(value > max and not max_.compare_exchange_weak(max, value, std::memory_order_relaxed)) {}
+    }
+
+    [[nodiscard]] auto snapshot() const -> Snapshot
+    {
+        auto result = Snapshot{};
+        for(auto i = size_t{0}; i < c_buckets; ++i)
+        {
+            result.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+        }
+        result.count = count_.load(std::memory_order_relaxed);
+        result.sum = sum_.load(std::memory_order_relaxed);
+        result.max = max_.load(std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, c_buckets> buckets_ {};
+    std::atomic<uint64_t> count_ {0};
+    std::atomic<uint64_t> sum_ {0};
+    std::atomic<uint64_t> max_ {0};
+};
+
+/** @brief 作用域结束时把经过的纳秒数记进直方图 */
+class ScopedLatency{
+public:
+    explicit ScopedLatency(Histogram& histogram) : histogram_{histogram}, begin_{Clock::now()} {}
+    ScopedLatency(const ScopedLatency&)            = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+    ~ScopedLatency()
+    {
+        auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - begin_).count();
+        histogram_.record(static_cast<uint64_t>(elapsed));
+    }
+
+private:
+    Histogram& histogram_;
+    TimePoint begin_;
+};
+
+/**
+ * @brief 单个 appender 的指标快照
+ * @details write_latency_ns 只统计 AsyncLogger 后台线程交给它的整批写入；
+ *          rotation_ns 的 count 就是滚动次数，值是每次滚动占用写日志线程的时间，不滚动的 appender 为空；
+ *          rotation_fallbacks 是其中后台没准备好 .next、写日志的线程自己同步打开的次数
+ */
+struct AppenderMetrics{
+    std::string name;
+    Histogram::Snapshot write_latency_ns;
+    Histogram::Snapshot rotation_ns;
+    uint64_t rotation_fallbacks = 0;
+};
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+
+// 名称句柄：事件里只保存这 4 个字节，真正的字符串只在驻留表里存一份
+using NameId = uint32_t;
+
+/**
+ * @brief 日志器名称、线程名称的驻留表
+ * @details 名称第一次出现时登记(加锁)，之后通过线程局部缓存直接拿到句柄；
+ *          句柄到字符串的查询是无锁的，登记过的字符串在程序结束前不会移动或释放。
+ *          句柄表按块增长，每块 c_k_chunk_names 个句柄，用满一块再分配下一块，已发布的块不会移动；
+ *          块数有上限，登记满 c_k_max_names 个名称后新名称统一返回 c_empty_id(格式化出来是空字符串)，
+ *          并计入 OverflowCount()，监控可以据此发现名称泄漏(比如把请求 id 拼进了日志器名或线程名)
+ */
+class LogNameRegistry{
+public:
+    // 每块句柄数
+    static constexpr NameId c_k_chunk_names = 4096;
+    // 最多可以登记的名称数量
+    static constexpr NameId c_k_max_names = c_k_chunk_names * 1024;
+    // 0 号句柄固定是空字符串，默认构造的 LogEvent 就指向它
+    static constexpr NameId c_empty_id = 0;
+
+    LogNameRegistry() = delete;
+
+    // 登记名称并返回句柄，已经登记过的名称直接返回原句柄；登记满了返回 c_empty_id
+    static auto Intern(std::string_view name) -> NameId;
+
+    // 句柄转字符串(无锁)
+    static auto Lookup(NameId id) -> std::string_view;
+
+    // 因为登记满了而返回 c_empty_id 的次数
+    static auto OverflowCount() -> uint64_t;
+};
@@ -1,56 +1,139 @@
 #pragma once
 #include "logger/LogEvent.h"
+#include "logger/ThreadContext.h"
 #include "common/alias.h"
 #include <iostream>
 #include <string_view>
 #include <source_location>
+#include <span>
 #include <chrono>
 #include <atomic>
+#include <mutex>
+#include <optional>
 #include <thread>
+#include <string>
+#include <vector>
 
 /**
  * @brief 日志器，用于输出日志，log用于输出日事件。Logger包含日志级别，日志器名称，创建时间，以及一个LogAppender数组。
     日志事件由 log方法输出， log方法首先判断日志级别是否达到本 Logger 的级别要求，
     如果满足则将日志事件传递给所有LogAppender进行输出，否则丢弃该条日志
+ * @details 日志器可以挂到父日志器下(见 setParent，LoggerManager 按点分名称自动建立)：
+ *          - 没有设置过级别时沿用父日志器的级别
+ *          - 生效的 appender = 自己添加的 + 父日志器生效的
+ *          生效值在配置改动时算好并向下同步，log() 只读自己的，不沿父链查找
  */
 
 class AppenderFacade;
 class LogEvent;
-enum class LogLevel;
+enum class LogLevel : int8_t;
 
 class Logger : public std::enable_shared_from_this<Logger>{
 public:
 
     // 带参构造
-    explicit Logger(std::string name) : name_(std::move(name)) {}
+    explicit Logger(std::string name) : name_(std::move(name)), name_id_(LogNameRegistry::Intern(name_)) {publish_({});}
 
     // 无参构造，自动生成名字   
-    Logger() : name_(std::to_string(auto_logger_id_.fetch_add(1))) {}        // fetch_add 是 atomic 的标准写法，等价于后置 ++
+    Logger() : Logger(std::to_string(auto_logger_id_.fetch_add(1))) {}        // fetch_add 是 atomic 的标准写法，等价于后置 ++
 
+    Logger(const Logger&)            = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    ~Logger();
+
+    // 延迟格式化的事件原样交给 wantsDeferred() 的 appender，其余 appender 用到时才渲染一份
     void log(const LogEvent& event) const;
+
+    // 批量输出：整批都达到日志级别时整批交给每个 appender(要文本的 appender 拿到整批渲染好的副本)，否则逐条输出
+    void log(std::span<const LogEvent> events) const;
     // void log(const LogEvent& event, std::error_code &ec) const;
 
-    void addAppender(Sptr<Appender> appender);
+    void addAppender(Sptr<AppenderFacade> appender);
 
-    void delAppender(Sptr<Appender> appender);
+    void delAppender(Sptr<AppenderFacade> appender);
 
+    // 只清空自己添加的，从父日志器继承来的不受影响
     void clearAppender();
 
+    // 挂到 parent 下(传 nullptr 则脱离)，自己和所有子日志器的生效级别、appender 随之刷新。会形成环时抛 std::invalid_argument
+    void setParent(Sptr<Logger> parent);
+
+    Sptr<Logger> getParent() const;
+
+    // 当前 appender 快照的元素个数
+    size_t getAppenderCount() const {auto reader = SnapshotReader_{}; return getAppenderSnapshot_().size();}
+
     std::string_view getLoggerName() const {return name_;}
 
-    void setLogLevel(LogLevel level) {level_ = level;}
+    // 名称在驻留表中的句柄，构造事件时直接使用，不必再查表
+    NameId getLoggerNameId() const {return name_id_;}
+
+    // 级别可以在运行期随时调整，会同步到沿用本级别的子日志器；读写都是 relaxed：级别只是一个开关，不用来同步其他数据
+    void setLogLevel(LogLevel level);
+
+    // 取消自己的级别设置，重新沿用父日志器的(没有父日志器时为 ALL)
+    void resetLogLevel();
+
+    LogLevel getLogLevel() const {return level_.load(std::memory_order_relaxed);}
+
+    // 日志宏在求值参数、构造事件之前先调用它：一次 relaxed 原子读 + 一次比较
+    bool isLevelEnable(LogLevel level) const {return level >= level_.load(std::memory_order_relaxed);}
+
+protected:
+    using AppenderList = std::vector<Sptr<AppenderFacade>>;
 
-    LogLevel getLogLevel() const {return level_;}
+    /**
+     * @brief 读 appender 快照期间在栈上放一个，登记本线程正在读
+     * @details - 换下来的快照要等登记早于替换的读者都离开后才释放，读者自己不做引用计数
+     *          - 可以嵌套(appender 里再打日志)，只有最外层登记和注销
+     */
+    class SnapshotReader_{
+    public:
+        SnapshotReader_();
+        ~SnapshotReader_();
+        SnapshotReader_(const SnapshotReader_&) = delete;
+        auto operator=(const SnapshotReader_&) -> SnapshotReader_& = delete;
+    };
 
-    bool isLevelEnable(LogLevel level) const {return level >= level_;}
+    // 当前生效的 appender 快照(无锁)，只在持有 SnapshotReader_ 期间有效，AsyncLogger 后台线程用它逐个 appender 写入并计时
+    const AppenderList& getAppenderSnapshot_() const {return *appenders_.load(std::memory_order_seq_cst);}
+
+    // 快照代数，每发布一份新快照加 1；AsyncLogger 用它判断 appender 配置有没有变
+    auto getAppenderGeneration_() const -> uint64_t {return appenders_generation_.load(std::memory_order_acquire);}
+
+private:
+
+    // 发布一份新快照，调用时持有 s_config_mutex_(构造时除外)
+    void publish_(AppenderList list);
+
+    // 按自己的设置和父日志器的生效值重新计算级别和 appender，再递归刷新子日志器，调用时持有 s_config_mutex_
+    void refresh_();
 
-private:    
     // 日志名称
     std::string name_;
-    // 日志级别
-    LogLevel level_;
-    // Appender集合
-    std::vector<Sptr<Appender>> appenders_;
+    NameId name_id_;
+    // 生效的日志级别，自己没设置过(own_level_ 为空)时沿用父日志器的
+    std::atomic<LogLevel> level_ = LogLevel::ALL;
+    std::optional<LogLevel> own_level_;
+    // 自己添加的 appender
+    AppenderList own_appenders_;
+    /**
+     * @brief 生效的 Appender集合，RCU 方式发布的不可变快照
+     * @details - log() 登记一次读者纪元后读裸指针，不复制 shared_ptr、不加锁
+     *          - 配置改动在 s_config_mutex_ 下重新计算出一份新快照整体替换，不动正在被读的那份
+     *          - 换下来的快照按纪元回收(见 Logger.cpp)：替换时没有读者在读就当场释放，
+     *            被删掉的 appender 随之析构；还有读者时留到之后某次配置改动再释放
+     *          - current_snapshot_ 持有当前这份，Logger 析构时释放
+     */
+    std::atomic<const AppenderList*> appenders_ = nullptr;
+    Uptr<const AppenderList> current_snapshot_;
+    std::atomic<uint64_t> appenders_generation_ = 0;
+    // 层级关系：子日志器持有父日志器，父日志器只记录子日志器的裸指针，子日志器析构时从中移除
+    Sptr<Logger> parent_;
+    std::vector<Logger*> children_;
+    // 串行化所有日志器的配置改动(级别、appender、层级)。改动很少，而且要沿层级向下同步，一把全局锁最简单
+    inline static std::mutex s_config_mutex_;
     // 自动日志器ID, inline static 可以在类内初始化
     inline static std::atomic<uint32_t> auto_logger_id_ = 0;
 };
@@ -69,21 +152,33 @@ private:
 //         source_info});
 // }
 
-inline void log(const Logger& logger, LogLevel loglevel, std::source_location source_info = std::source_location::current()){
-    uint32_t tid = static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
-    auto now_t = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-    
-    // 注意：用小括号 () 显式调用构造函数，并且强制转换 string
+/**
+ * @brief 按调用线程和当前时间(微秒精度)构造一条空消息的事件，日志宏和 log() 共用
+ * @details 线程号、线程名称句柄、协程号都来自 ThreadContext，只是几次线程局部读取
+ */
+inline auto MakeLogEvent(const Logger& logger, LogLevel loglevel, std::source_location source_info) -> LogEvent{
+    auto now = std::chrono::system_clock::now();
+    auto now_t = std::chrono::system_clock::to_time_t(now);
+
+    // 注意：用小括号 () 显式调用构造函数，名称直接使用驻留表句柄
     LogEvent ev(
-        std::string(logger.getLoggerName()), 
+        logger.getLoggerNameId(), 
         loglevel,               
         0,                      
-        tid,                    
-        std::string("MainThread"),           
+        ThreadContext::GetTid(),
+        ThreadContext::GetNameId(),
         now_t,                  
-        0,                      
+        ThreadContext::GetFiberId(),
         source_info             
     );
-    logger.log(ev);
+    ev.setTimePoint(now);   // 补上微秒，供 %d{...%L/%f} 输出
+    return ev;
+}
 
-}
\ No newline at end of file
+inline void log(const Logger& logger, LogLevel loglevel, std::source_location source_info = std::source_location::current()){
+    // 先判断级别，被过滤掉的日志不必构造事件
+    if(not logger.isLevelEnable(loglevel)){
+        return;
+    }
+    logger.log(MakeLogEvent(logger, loglevel, source_info));
+}
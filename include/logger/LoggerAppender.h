@@ -1,9 +1,18 @@
 #pragma once
 
 #include "AppenderProxy.hpp"
+#include "BinaryLogFormat.h"
+#include "LogBuffer.hpp"
 #include "LogFormatter.h"
+#include "LogMetrics.h"
+#include "RotationWorker.h"
+#include <array>
 #include <cstddef>
-#include <fstream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "common/alias.h"
 
 class LogFormatter;
@@ -14,26 +23,33 @@ class LogEvent;
 class StdoutAppender{
 public:
     static void log(const LogFormatter& fmter, const LogEvent& event);
+    // 整批格式化后只写一次
+    static void log(const LogFormatter& fmter, std::span<const LogEvent> events);
 };
 
 /**
- * @brief 滚动文件日志输出器。日志器如果大于64mb或时间超过了24小时，了就会自动新建一个日志文件，继续写入日志
+ * @brief 滚动文件输出器的公共部分：文件名、写入偏移量，以及按大小/时间判断滚动、生成滚动后的文件名。
+ *        RollingFileAppender 和 MmapFileAppender 各自负责怎么写文件，滚动规则完全一致
  */
-class RollingFileAppender{
-private:
+class RollingFileBase{
+protected:
     static constexpr size_t c_default_max_file_size = 64_mb;
     static constexpr Seconds c_default_max_time_interval = Seconds(24*60*60);  // 24小时
 
-    // Flush 策略相关常量
-    static constexpr Seconds c_flush_seconds = Seconds(3);  // 每3秒flush一次
-    static constexpr uint64_t c_flush_max_appends = 1024; // 每1024次写入强制刷新
+    RollingFileBase(std::string filename, size_t max_bytes, Seconds roll_interval);
 
-    std::mutex mutex_;
+    auto shouldRoll_() const -> bool;
+    auto getNewLogFileName_() const -> std::string;
+
+    // 把当前文件重命名为 getNewLogFileName_() 的名字，调用前文件必须已经关闭
+    auto renameCurrent_() const -> void;
+
+    // 滚动次数和每次滚动占用写日志线程的时间，派生类用 using 公开
+    [[nodiscard]] auto getRotationStats() const -> Histogram::Snapshot { return rotation_ns_.snapshot(); }
 
     // 文件路径和名称
     std::string filename_;
     std::string basename_;  // 用于重命名时构建新文件名
-    std::ofstream filestream_;
 
     // 滚动机制配置
     const size_t max_bytes_;      // 单个日志文件的最大字节数，超过则滚动
@@ -43,30 +59,180 @@ private:
     TimePoint last_open_time_ = TimePoint::min();  // 上次打开文件的时间点
     bool reopen_error_ = false;              // 重新打开文件时是否出错
     size_t offset_ = 0;                     // 当前文件的写入的字节数
+    Histogram rotation_ns_;                 // 各 rollFile_ 用 ScopedLatency 记录
+};
+
+/**
+ * @brief 滚动文件日志输出器。日志器如果大于64mb或时间超过了24小时，了就会自动新建一个日志文件，继续写入日志
+ * @details 滚动时写日志的线程只换一个预先打开好的 fd，关闭、重命名、压缩和清理旧文件都交给 RotationWorker 在后台完成
+ */
+class RollingFileAppender : private RollingFileBase{
+private:
+    // Flush 策略相关常量
+    static constexpr Seconds c_flush_seconds = Seconds(3);  // 每3秒flush一次
+    static constexpr uint64_t c_flush_max_appends = 1024; // 每1024次写入强制刷新
+    static constexpr size_t c_write_chunk = 64_kb;         // 每个写缓冲块的大小
+    static constexpr size_t c_write_chunks = 4;            // 预分配的写缓冲块数，一次 writev 最多提交这么多块
+
+    std::mutex mutex_;
+
+    int fd_ = -1;           // O_APPEND 打开的日志文件
+
+    // 已格式化、还没写入文件的日志：写满一块换下一块，全部写满或到了 flush 时机时一次 writev 提交
+    std::array<LogBuffer, c_write_chunks> chunks_;
+    size_t chunk_index_ = 0;
 
     // Flush 相关状态
     TimePoint last_flush_time_ = TimePoint::min(); // 上次flush的时间
     uint64_t flush_count_ = 0;               // 自上次flush以来的写入次数
 
+    RotationWorker worker_;
+
     auto openFile_() -> void;
 
+    // 开始往 fd 写：记录打开时间，写入偏移量从文件当前大小开始
+    auto attach_(int fd) -> void;
+
+    // 把一条日志格式化进当前写缓冲块
+    auto append_(const LogFormatter& fmter, const LogEvent& event) -> void;
+
+    // 把所有写缓冲块用一次 writev 写入文件(处理部分写入和 EINTR)
+    auto writePending_() -> void;
+
     /**
-     * @brief  **滚动日志文件**：关闭当前文件，重命名它，并打开一个新的同名文件。
+     * @brief  **滚动日志文件**：写完剩下的日志后换成后台预先打开的文件(后台没准备好时当场打开)，旧文件交给后台关闭、重命名。
+     *         打开 .next 失败时退回同步滚动：关闭当前文件，重命名它，并打开一个新的同名文件。
      */
     auto rollFile_() -> void;
-    auto shouldRoll_() const -> bool;
-    auto getNewLogFileName_() const -> std::string;
 
 public:
+    using RollingFileBase::getRotationStats;
+    [[nodiscard]] auto getRotationFallbacks() const -> uint64_t { return worker_.syncFallbackCount(); }
+
     explicit RollingFileAppender(std::string filename,
                                  size_t max_file_size = c_default_max_file_size,
-                                 Seconds roll_interval = c_default_max_time_interval);
+                                 Seconds roll_interval = c_default_max_time_interval,
+                                 RotationPolicy rotation = {});
     RollingFileAppender(const RollingFileAppender&) = delete;
     RollingFileAppender(RollingFileAppender&&) = delete;
     auto operator=(const RollingFileAppender&) -> RollingFileAppender& = delete;
     auto operator=(RollingFileAppender&&) -> RollingFileAppender& = delete;
     ~RollingFileAppender();
     void log(const LogFormatter& fmter, const LogEvent& event);
+
+    // 批量接口：整批格式化进写缓冲块，按 flush 策略(或写缓冲块全满时)一次 writev 提交
+    void log(const LogFormatter& fmter, std::span<const LogEvent> events);
+};
+
+/**
+ * @brief 内存映射的滚动文件日志输出器，滚动规则与 RollingFileAppender 相同
+ * @details - 文件按 c_map_chunk 大小用 fallocate 预先扩展并映射，日志格式化后直接拷进映射区，写入不需要系统调用
+ *          - 写到映射区末尾时才 munmap + fallocate + mmap 下一段
+ *          - 滚动/关闭时把文件截断到实际写入的长度
+ *          - 进程崩溃时已拷进映射区的内容都在页缓存里，一条都不会丢；文件末尾会留下预分配的 '\0'，
+ *            重新打开时跳过这段 '\0' 接着写。整机掉电时和 RollingFileAppender 一样，取决于内核是否已经回写
+ *          - 运行期间文件长度是预分配后的长度，tail -f 之类的工具会看到末尾的 '\0'
+ */
+class MmapFileAppender : private RollingFileBase{
+private:
+    static constexpr size_t c_map_chunk = 16_mb;    // 每次预分配并映射的大小
+
+    std::mutex mutex_;
+
+    int fd_ = -1;
+    char* map_ = nullptr;           // 当前映射区
+    size_t map_offset_ = 0;         // 映射区在文件中的起点(页对齐)
+    size_t map_size_ = 0;
+    LogBuffer buffer_;              // 一条/一批日志先格式化到这里，再整段拷进映射区
+
+    auto openFile_() -> void;
+
+    // 关闭前截断到实际长度，rollFile_ 和析构共用
+    auto closeFile_() -> void;
+
+    auto rollFile_() -> void;
+
+    // 把 offset_ 所在页起的 c_map_chunk 字节预分配并映射，成功后才更新 map_/map_offset_/map_size_；失败时抛 std::system_error
+    auto mapChunk_() -> void;
+
+    // 崩溃后重新打开：跳过上次预分配但没写的 '\0'，返回真实的日志长度
+    auto findLogicalEnd_(size_t file_size) const -> size_t;
+
+    // 把 buffer_ 拷进映射区，需要时(包括上次映射失败、map_ 为空)映射下一段
+    auto copyToMap_() -> void;
+
+public:
+    using RollingFileBase::getRotationStats;
+
+    explicit MmapFileAppender(std::string filename,
+                              size_t max_file_size = c_default_max_file_size,
+                              Seconds roll_interval = c_default_max_time_interval);
+    MmapFileAppender(const MmapFileAppender&) = delete;
+    MmapFileAppender(MmapFileAppender&&) = delete;
+    auto operator=(const MmapFileAppender&) -> MmapFileAppender& = delete;
+    auto operator=(MmapFileAppender&&) -> MmapFileAppender& = delete;
+    ~MmapFileAppender();
+
+    void log(const LogFormatter& fmter, const LogEvent& event);
+
+    // 批量接口：整批格式化后一次拷进映射区
+    void log(const LogFormatter& fmter, std::span<const LogEvent> events);
+};
+
+/**
+ * @brief 二进制滚动文件日志输出器，滚动规则与 RollingFileAppender 相同，文件格式见 BinaryLogFormat.h
+ * @details - 每条日志只写级别、时间、线程号、源码位置 id 和原始参数，名称、格式串、源码位置在每个块里只写一次
+ *          - 延迟格式化(printDeferred)的事件完全不调用 std::format，参数字节原样写出；其余事件写已经格式化好的消息。
+ *            经 Logger/AsyncLogger 写入时也是如此(见 wantsDeferred)
+ *          - 传进来的 LogFormatter 不参与，离线用 tools/cotton_decode 按任意模式还原成文本
+ *          - 按块写出，每块带 CRC32，块写满或到了 flush 时机时封块
+ */
+class BinaryFileAppender : private RollingFileBase{
+private:
+    static constexpr size_t c_block_size = 64_kb;                 // 块负载达到这个大小就封块写出
+    static constexpr Seconds c_flush_seconds = Seconds(3);
+    static constexpr uint64_t c_flush_max_appends = 1024;
+
+    std::mutex mutex_;
+
+    int fd_ = -1;
+    BinaryLog::BlockEncoder encoder_;   // 当前块的负载和字典
+
+    TimePoint last_flush_time_ = TimePoint::min();
+    uint64_t flush_count_ = 0;
+
+    // 打开文件并写文件头
+    auto openFile_() -> void;
+
+    auto rollFile_() -> void;
+
+    // 把一条日志(以及它第一次用到的字典条目)编码进当前块
+    auto encode_(const LogEvent& event) -> void;
+
+    // 给当前块加上块头和 CRC，一次 writev 写出
+    auto sealBlock_() -> void;
+
+    // 按 flush 策略决定是否封块
+    auto maybeFlush_(uint64_t appends) -> void;
+
+public:
+    using RollingFileBase::getRotationStats;
+
+    explicit BinaryFileAppender(std::string filename,
+                                size_t max_file_size = c_default_max_file_size,
+                                Seconds roll_interval = c_default_max_time_interval);
+    BinaryFileAppender(const BinaryFileAppender&) = delete;
+    BinaryFileAppender(BinaryFileAppender&&) = delete;
+    auto operator=(const BinaryFileAppender&) -> BinaryFileAppender& = delete;
+    auto operator=(BinaryFileAppender&&) -> BinaryFileAppender& = delete;
+    ~BinaryFileAppender();
+
+    // 日志器把延迟格式化的事件原样交过来，参数字节直接编码
+    [[nodiscard]] static auto wantsDeferred() -> bool { return true; }
+
+    void log(const LogFormatter& fmter, const LogEvent& event);
+
+    void log(const LogFormatter& fmter, std::span<const LogEvent> events);
 };
 
 /**
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * @brief LogEvent 长消息的溢出内存池
+ * @details 内联缓冲放不下的消息从这里按大小档位取内存块，用完归还到对应档位的无锁空闲链表，
+ *          稳态下不再向系统申请内存。超过最大档位的消息直接走 operator new，释放时归还系统。
+ */
+class MessageArena{
+public:
+    MessageArena() = delete;
+
+    // 取一块至少 size 字节的内存
+    static auto Acquire(size_t size) -> char*;
+
+    // 归还 Acquire 得到的内存块
+    static auto Release(char* block) -> void;
+
+    // 内存块的实际可用字节数
+    static auto Capacity(const char* block) -> size_t;
+};
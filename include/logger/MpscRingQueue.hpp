@@ -0,0 +1,130 @@
+#pragma once
+#include "common/alias.h"
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+// 定义环形队列容量：储存 8192 个事件槽位（必须是2的幂）
+constexpr size_t c_k_ring_capacity = 8192;
+
+/**
+ * @brief 有界无锁多生产者/单消费者环形队列
+ * @details 每个槽位带一个序号 seq_，生产者用 CAS 抢占写位置，写完后发布序号；
+ *          消费者只有一个，读位置不需要原子 RMW，只需按序号判断槽位是否已发布。
+ *          - seq == pos      : 槽位空闲，可以被 pos 号生产者写入
+ *          - seq == pos + 1  : 槽位已写入，可以被消费者读出
+ *          - 消费完后 seq = pos + Capacity，留给下一圈的生产者
+ */
+template <typename T, size_t Capacity = c_k_ring_capacity>
+class MpscRingQueue
+{
+    static_assert(Capacity >= 2 and (Capacity & (Capacity - 1)) == 0, "Capacity 必须是2的幂");
+
+    // 生产者和消费者各自的游标放在不同的缓存行，避免伪共享；
+    // 槽位也按缓存行对齐，消费者读第 i 个槽位时不会和正在写第 i+1 个槽位的生产者共享缓存行
+    struct alignas(c_k_cache_line) Slot
+    {
+        std::atomic<size_t> seq_;
+        T data_;
+    };
+
+public:
+    MpscRingQueue() : slots_(std::make_unique<Slot[]>(Capacity))
+    {
+        for(auto i = size_t{0}; i < Capacity; ++i)
+        {
+            slots_[i].seq_.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRingQueue(const MpscRingQueue&)            = delete;
+    MpscRingQueue(MpscRingQueue&&)                 = delete;
+    MpscRingQueue& operator=(const MpscRingQueue&) = delete;
+    MpscRingQueue& operator=(MpscRingQueue&&)      = delete;
+
+    /**
+     * @brief 生产者接口：尝试写入一个元素
+     * @return 队列已满时返回false，此时 value 不会被移动
+     */
+    auto tryPush(T&& value) -> bool
+    {
+        auto pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            auto& slot = slots_[pos & c_mask];
+            auto seq = slot.seq_.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if(diff == 0)
+            {
+                // 槽位空闲，抢占这个写位置；失败时 pos 会被更新为最新值
+                if(enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot.data_ = std::move(value);
+                    slot.seq_.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(diff < 0)
+            {
+                // 消费者还没读走上一圈的数据，队列已满
+                return false;
+            }
+            else
+            {
+                // 被其他生产者抢先了，重新读取写位置
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief 消费者接口：批量取出最多 max_count 个元素，每个元素交给 func 处理
+     * @return 实际取出的数量
+     */
+    template <typename Func>
+    auto popBatch(Func&& func, size_t max_count) -> size_t
+    {
+        auto count = size_t{0};
+        while(count < max_count)
+        {
+            auto& slot = slots_[dequeue_pos_ & c_mask];
+            auto seq = slot.seq_.load(std::memory_order_acquire);
+            if(seq != dequeue_pos_ + 1)
+            {
+                // 槽位还没被发布（空，或者生产者还在写）
+                break;
+            }
+            func(std::move(slot.data_));
+            slot.seq_.store(dequeue_pos_ + Capacity, std::memory_order_release);
+            ++dequeue_pos_;
+            ++count;
+        }
+        return count;
+    }
+
+    // 近似的待消费数量，只用于唤醒判断，不保证精确
+    [[nodiscard]] auto approxSize() const -> size_t
+    {
+        auto head = dequeue_cursor_.load(std::memory_order_relaxed);
+        auto tail = enqueue_pos_.load(std::memory_order_relaxed);
+        return tail > head ? tail - head : 0;
+    }
+
+    // 成功入队的累计数量(写游标本身)，供指标使用
+    [[nodiscard]] auto pushedCount() const -> size_t { return enqueue_pos_.load(std::memory_order_relaxed); }
+
+    // 消费者每轮批量处理完后发布一次读游标，供 approxSize() 使用
+    auto publishCursor() -> void { dequeue_cursor_.store(dequeue_pos_, std::memory_order_relaxed); }
+
+    [[nodiscard]] static constexpr auto capacity() -> size_t { return Capacity; }
+
+private:
+    static constexpr size_t c_mask = Capacity - 1;
+
+    std::unique_ptr<Slot[]> slots_;
+    alignas(c_k_cache_line) std::atomic<size_t> enqueue_pos_{0};  // 生产者共享的写游标
+    alignas(c_k_cache_line) size_t dequeue_pos_ = 0;              // 只有消费者读写
+    std::atomic<size_t> dequeue_cursor_{0};                     // dequeue_pos_ 的公开副本
+};
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "BinaryLogFormat.h"
+#include "LogBuffer.hpp"
+#include "common/alias.h"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <string>
+
+class LogFormatter;
+class LogEvent;
+
+// 发给收集端的内容：按 LogFormatter 格式化好的文本行，或者 BinaryLogFormat.h 的二进制块
+enum class NetworkPayload : uint8_t
+{
+    Text,
+    Binary,
+};
+
+struct NetworkAppenderOptions{
+    // "tcp://127.0.0.1:5140"、"udp://127.0.0.1:5140"、"unix:///run/collector.sock"，
+    // 主机名在构造时解析一次
+    std::string address;
+    NetworkPayload payload = NetworkPayload::Text;
+    // 已提交、还没发出去的字节上限(含断线期间积压的)，超过后新的一批整批丢弃并计数
+    size_t max_in_flight_bytes = 4_mb;
+    // 一批最多攒这么多字节再提交；UDP 时就是单个数据报的上限，会被限制在 64KB 以内
+    size_t max_batch_bytes = 64_kb;
+    // 连接失败或断开后按指数退避重连，从 reconnect_min 开始每次翻倍，最长 reconnect_max
+    std::chrono::milliseconds reconnect_min {100};
+    std::chrono::milliseconds reconnect_max {10'000};
+    // 析构时最多等这么久把积压的日志发完，剩下的计入丢弃
+    std::chrono::milliseconds close_timeout {1'000};
+};
+
+struct NetworkAppenderStats{
+    uint64_t sent_events = 0;       // 已经完整交给内核的事件数
+    uint64_t sent_bytes = 0;
+    uint64_t send_calls = 0;        // send/sendmsg 次数，sent_events / send_calls 就是每次系统调用带走的事件数
+    uint64_t dropped_events = 0;    // 超过 in-flight 上限、UDP 发送失败或关闭时没发完而丢弃的事件
+    uint64_t connects = 0;          // 成功建立连接的次数，大于 1 说明发生过重连
+    size_t in_flight_bytes = 0;
+};
+
+/**
+ * @brief 网络日志输出器：把日志直接发给本机或远端的收集进程，不再先写文件再由 sidecar 读回去
+ * @details - 写日志的线程只把整批事件格式化(或编码)进一块缓冲，交给后台的 EventLoop 线程，不做任何网络 I/O
+ *          - 后台线程用非阻塞 socket：流式连接(TCP/Unix)把排队的多批缓冲用一次 sendmsg 聚集写出，
+ *            写不动(EAGAIN)时等 EPOLLOUT 再继续；UDP 每批一个数据报
+ *          - 连接失败或被对端关闭后按退避时间重连，断线期间的日志继续排队，直到 max_in_flight_bytes；
+ *            发了一半的那批在重连后从头重发，收集端按行/按块解析不会错位，但这一批可能重复
+ *          - Binary 时每个流式连接开头先发一个文件头，之后是若干块；UDP 每个数据报都是文件头 + 一个块。
+ *            收集端把收到的字节原样存成文件，就能用 BinaryLogReader/cotton_decode 解码
+ */
+class NetworkAppender{
+public:
+    explicit NetworkAppender(NetworkAppenderOptions options);
+    NetworkAppender(const NetworkAppender&) = delete;
+    NetworkAppender(NetworkAppender&&) = delete;
+    auto operator=(const NetworkAppender&) -> NetworkAppender& = delete;
+    auto operator=(NetworkAppender&&) -> NetworkAppender& = delete;
+    ~NetworkAppender();
+
+    // Binary 时延迟格式化的事件原样交过来，参数字节直接编码；Text 要的是渲染好的文本
+    [[nodiscard]] auto wantsDeferred() const -> bool { return options_.payload == NetworkPayload::Binary; }
+
+    void log(const LogFormatter& fmter, const LogEvent& event);
+
+    // 批量接口：整批格式化进缓冲，每满 max_batch_bytes 提交一次
+    void log(const LogFormatter& fmter, std::span<const LogEvent> events);
+
+    [[nodiscard]] auto getStats() const -> NetworkAppenderStats;
+
+    // 等到已提交的日志全部交给内核，超时返回 false
+    auto waitIdle(std::chrono::milliseconds timeout) const -> bool;
+
+private:
+    class Connection;
+
+    // 把一条事件追加进当前批，满了就先提交
+    auto append_(const LogFormatter& fmter, const LogEvent& event) -> void;
+
+    // 把当前批交给后台线程，换一块空缓冲继续攒
+    auto submit_() -> void;
+
+    NetworkAppenderOptions options_;
+    Uptr<Connection> connection_;
+
+    std::mutex mutex_;                  // 保护下面的格式化状态，多个线程可以同时 log
+    LogBuffer batch_;                   // 当前批
+    size_t batch_events_ = 0;
+    LogBuffer line_;                    // 文本模式下单条日志先格式化到这里，放得进当前批才追加
+    BinaryLog::BlockEncoder encoder_;
+    size_t block_limit_ = 0;            // 二进制时块负载达到这个大小就封块提交
+    bool datagram_ = false;
+};
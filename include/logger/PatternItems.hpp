@@ -0,0 +1,242 @@
+#pragma once
+
+#include "logger/LogBuffer.hpp"
+#include "logger/LogEvent.h"
+#include "logger/LogLevel.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+/* ======================================FormatterItem==============================*/
+// 每个 Item 都是一个没有虚函数的小值类型，LogFormatter 把它们放进 std::variant 顺序执行，
+// StaticLogFormatter 则在编译期直接展开调用，两条路径共用同一套 Item
+
+class FunctionNameFormatItem {
+public:
+    static auto format(LogBuffer& buf, const LogEvent& event) -> void
+    {
+        buf.append(event.getFunctionName());
+    }
+};
+
+/**
+ * @brief 消息format
+ */
+class MessageFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent& event) -> void
+    {
+        buf.append(event.getContent());
+    }
+};
+
+/** @brief 日志级别format */
+class LevelFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent& event) -> void {
+        buf.append(LevelToString(event.getLevel()));
+    }
+};
+
+/** @brief 耗时format */
+class ElapseFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent& event) -> void {
+        buf.appendInt(event.getElapse());
+    }
+};
+
+/** @brief 日志器名字format */
+class NameFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent& event) -> void {
+        buf.append(event.getLoggerName());
+    }
+};
+
+/** @brief 线程ID format */
+class ThreadIdFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent& event) -> void {
+        buf.appendInt(event.getThreadId());
+    }
+};
+
+/** @brief 协程ID format */
+class FiberIdFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent& event) -> void {
+        buf.appendInt(event.getFiberId());
+    }
+};
+
+/** @brief 线程名称 format */
+class ThreadNameFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent& event) -> void {
+        buf.append(event.getThreadName());
+    }
+};
+
+/** @brief 换行符 format */
+class NewLineFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent&) -> void {
+        buf.push_back('\n');
+    }
+};
+
+/** @brief 文件名 format */
+class FilenameFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent& event) -> void {
+        buf.append(event.getFilename());
+    }
+};
+
+/** @brief 行号 format */
+class LineFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent& event) -> void {
+        buf.appendInt(event.getLine());
+    }
+};
+
+/** @brief tab format */
+class TabFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent&) -> void {
+        buf.push_back('\t');
+    }
+};
+
+/** @brief JSON 转义后的消息，用在 JSON 模式的 "msg":"%E" 里 */
+class EscapedMessageFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent& event) -> void;
+};
+
+/**
+ * @brief 结构化字段按 JSON 成员输出，每个字段是 ,"key":value
+ * @details 紧跟在模式里已有的成员后面，比如 {"msg":"%E"%j}。数值、bool 不加引号，
+ *          字符串和 char 转义后加引号，指针输出成 "0x..."，nullptr 和非有限的浮点数输出 null
+ */
+class JsonFieldsFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent& event) -> void;
+};
+
+/** @brief 结构化字段按 logfmt 输出，每个字段是 " key=value"，值为空或含空格、引号、等号、控制字符时加引号 */
+class LogfmtFieldsFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent& event) -> void;
+};
+
+/** @brief % format */
+class PercentSignFormatItem{
+public:
+    static auto format(LogBuffer& buf, const LogEvent&) -> void {
+        buf.push_back('%');
+    }
+};
+
+/*===================================FormatItem with Status======================= */
+/**
+ * @brief 时间 format
+ * @details 子模式就是 strftime 的格式，另外支持秒以下的占位符：%L 毫秒(3位)、%f 微秒(6位)，最多 c_k_max_sub_second 个。
+ *          同一秒内的文本只渲染一次：每个线程按 Item 缓存当前秒的结果，秒数变化时才调用 localtime_r/strftime，
+ *          毫秒/微秒每行用查表的定宽整数转换拼上去
+ */
+class DateTimeFormatItem{
+public:
+    static constexpr size_t c_k_max_sub_second = 4;
+
+    explicit DateTimeFormatItem(std::string data_format);
+
+    auto format(LogBuffer& buf, const LogEvent& event) const -> void;
+
+    // 左值
+    auto getSubpattern() & -> const std::string&
+    {
+        return date_format_;
+    }
+
+    // 右值
+    auto getSubpattern() && -> std::string
+    {
+        return std::move(date_format_);
+    }
+
+private:
+    enum class SubSecond : uint8_t
+    {
+        Milli,  // %L
+        Micro,  // %f
+    };
+
+    std::string date_format_ =  "%Y-%m-%d %H:%M:%S";
+    std::vector<std::string> parts_;        // 被秒以下占位符隔开的各段 strftime 格式
+    std::vector<SubSecond> sub_seconds_;    // 第 i 个占位符位于 parts_[i] 与 parts_[i+1] 之间
+    uint64_t cache_id_ = 0;         // 在线程局部缓存中区分不同的 Item，拷贝出来的 Item 格式相同，共用同一个 id
+
+    inline static std::atomic<uint64_t> s_next_cache_id_ = 1;
+};
+
+class StringFormatItem{
+public:
+    explicit StringFormatItem(std::string str) : str_(std::move(str)){}
+
+    auto format(LogBuffer& buf, const LogEvent&) const -> void
+    {
+        buf.append(str_);
+    }
+private:
+    std::string str_;
+};
+
+/*===================================Item 注册表======================= */
+// 无参格式符与 Item 的对应关系，运行期解析和编译期解析共用这一张表
+#define COTTON_PATTERN_ITEM_LIST(XX) \
+    XX('m', MessageFormatItem)       /* m:消息 */       \
+    XX('p', LevelFormatItem)         /* p:日志级别 */   \
+    XX('c', NameFormatItem)          /* c:日志器名称 */ \
+    XX('r', ElapseFormatItem)        /* r:累计毫秒数 */ \
+    XX('f', FilenameFormatItem)      /* f:文件名 */     \
+    XX('l', LineFormatItem)          /* l:行号 */       \
+    XX('t', ThreadIdFormatItem)      /* t:线程号 */     \
+    XX('F', FiberIdFormatItem)       /* F:协程号 */     \
+    XX('N', ThreadNameFormatItem)    /* N:线程名称 */   \
+    XX('T', TabFormatItem)           /* T:制表符 */     \
+    XX('n', NewLineFormatItem)       /* n:换行符 */     \
+    XX('%', PercentSignFormatItem)   /* %:百分号 */     \
+    XX('v', FunctionNameFormatItem)  /* v:函数名 */     \
+    XX('E', EscapedMessageFormatItem)/* E:转义的消息 */ \
+    XX('j', JsonFieldsFormatItem)    /* j:字段 JSON */  \
+    XX('K', LogfmtFieldsFormatItem)  /* K:字段 logfmt */
+
+/** @brief 编译后的模式项：std::visit 按下标跳转，没有虚函数也没有 shared_ptr 间接访问 */
+using PatternItem = std::variant<
+#define XX(ch, ItemType) ItemType,
+    COTTON_PATTERN_ITEM_LIST(XX)
+#undef XX
+    DateTimeFormatItem,
+    StringFormatItem>;
+
+/** @brief 格式符 C 对应的无参 Item 类型，没有对应时 type 为 void */
+template <char C>
+struct PatternItemOf { using type = void; };
+
+#define XX(ch, ItemType) template <> struct PatternItemOf<ch> { using type = ItemType; };
+COTTON_PATTERN_ITEM_LIST(XX)
+#undef XX
+
+// 无参格式符(如 %m) 生成 Item，不认识的格式符返回 nullopt
+auto MakePatternItem(char c) -> std::optional<PatternItem>;
+
+// 带参数的格式符(如 %d{...}) 生成 Item，不认识的格式符返回 nullopt
+auto MakeStatusPatternItem(char c, std::string sub_pattern) -> std::optional<PatternItem>;
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+
+/** @brief 滚动出去的旧文件如何处理 */
+struct RotationPolicy{
+    bool compress_ = false;         // 用 gzip 压缩成 <滚动文件名>.gz，压缩完删除原文件
+    size_t max_files_ = 0;          // 最多保留多少个滚动出去的文件，0 表示不限
+    size_t max_total_bytes_ = 0;    // 滚动出去的文件总字节数上限(压缩后的大小)，0 表示不限
+};
+
+/**
+ * @brief 滚动文件的后台工作线程，把滚动中慢的部分从写日志的线程上拿走
+ * @details - 预先打开下一个文件 <filename>.next，滚动时写日志的线程只需要换一个 fd
+ *          - 换下来的 fd 交给后台：关闭、重命名成带时间戳的文件名，再把 .next 改名成 <filename>，然后预先打开下一个 .next
+ *          - 之后再压缩滚动出去的文件、按 RotationPolicy 删除最旧的文件
+ *          - 重命名总是先于压缩处理，压缩再慢也不会让下一次滚动拿不到 fd
+ *          - 线程以最低优先级(nice 19)运行，析构时处理完队列里剩下的任务再退出
+ *          - 滚动时后台还没准备好 .next(它可能很久才被调度到)，写日志的线程不等它，自己同步做完重命名和打开，
+ *            避免高优先级线程等 nice 19 线程的优先级反转；这种同步兜底的次数记在 syncFallbackCount()
+ *          - 构造时发现上次崩溃留下的非空 .next(滚动到一半：写日志的线程已经换到 .next，重命名还没做完)，
+ *            把它追加到 <filename> 末尾再删掉：.next 里的日志比 <filename> 新、比这次启动后写的旧，追加后仍按时间顺序
+ */
+class RotationWorker{
+public:
+    RotationWorker(std::string filename, RotationPolicy policy);
+    RotationWorker(const RotationWorker&) = delete;
+    RotationWorker(RotationWorker&&) = delete;
+    auto operator=(const RotationWorker&) -> RotationWorker& = delete;
+    auto operator=(RotationWorker&&) -> RotationWorker& = delete;
+    ~RotationWorker();
+
+    /**
+     * @brief 取走预先打开的下一个文件
+     * @details 还没准备好时不等后台线程，在调用方线程里做完待处理的重命名并同步打开 .next(只可能等后台正在做的
+     *          几个重命名/打开系统调用)；同步打开也失败时返回 -1，调用方自己同步滚动，后台会在下一次之前重试打开
+     */
+    auto takeNextFd() -> int;
+
+    // 把换下来的 fd 交给后台，rotated_name 是滚动时算好的带时间戳的文件名
+    auto submit(int old_fd, std::string rotated_name) -> void;
+
+    // takeNextFd 没拿到预先打开的 fd、改为在调用方线程同步打开的次数
+    [[nodiscard]] auto syncFallbackCount() const -> uint64_t { return sync_fallbacks_.load(std::memory_order_relaxed); }
+
+private:
+    struct Rotation{
+        int fd_ = -1;
+        std::string rotated_name_;
+    };
+
+    auto run_() -> void;
+
+    // 构造时在调用方线程执行，必须在 RollingFileAppender 打开 <filename> 之前完成
+    auto recoverNext_() -> void;
+
+    /**
+     * @brief 做完排队的重命名，.next 已被取走时再打开一个新的
+     * @details 调用方必须持有 rotate_mutex_：后台线程和 takeNextFd 的同步兜底都走这里，保证文件链上的操作按顺序执行
+     * @return 是否尝试了打开 .next
+     */
+    auto prepareNext_() -> bool;
+    auto rotate_(Rotation& rotation) -> void;
+    [[nodiscard]] auto openNext_() -> int;
+
+    // 以下只在后台线程执行
+    auto compress_(const std::string& path) -> void;
+    auto enforceRetention_() -> void;
+
+    // 滚动文件名已经存在时(同一秒内多次滚动)加上序号，避免覆盖
+    auto uniqueName_(const std::string& name) const -> std::string;
+
+    const std::string filename_;
+    const std::string next_filename_;   // <filename>.next
+    const RotationPolicy policy_;
+
+    std::mutex rotate_mutex_;               // 串行化重命名和打开 .next，只在这几个系统调用期间持有，压缩和清理不拿它
+    std::mutex mutex_;
+    std::condition_variable cond_;          // 通知后台线程有新任务
+    std::deque<Rotation> rotations_;        // 等待重命名的
+    std::deque<std::string> finished_;      // 已经重命名、等待压缩和清理的
+    int next_fd_ = -1;
+    bool next_taken_ = false;               // .next 已被取走、还没 submit：它仍叫 .next 且正被写入，不能再打开一次
+    bool retry_open_ = false;               // 上次打开失败，需要重试
+    bool stop_ = false;
+    std::atomic<uint64_t> sync_fallbacks_ {0};
+
+    std::thread thread_;
+};
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "logger/PatternItems.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+/** @brief 可以作为模板参数的字符串字面量 */
+template <size_t N>
+struct FixedString
+{
+    char data_[N] {};
+
+    consteval FixedString(const char (&str)[N]) { std::copy_n(str, N, data_); }
+
+    [[nodiscard]] constexpr auto view() const -> std::string_view { return {data_, N - 1}; }
+};
+
+namespace StaticPattern {
+
+    // 普通字符串的 kind_，其余 kind_ 就是格式符本身('d' 是带子模式的日期)
+    inline constexpr char c_literal = '\0';
+
+    // 所有无参格式符，和运行期的 MakePatternItem 用同一张表
+    inline constexpr char c_item_chars[] = {
+#define XX(ch, ItemType) ch,
+        COTTON_PATTERN_ITEM_LIST(XX)
+#undef XX
+        '\0'};
+
+    /** @brief 一个模式项：kind_ 加上它在模式串里对应的区间(普通字符串/日期子模式才有意义) */
+    struct Token
+    {
+        char kind_ = c_literal;
+        size_t begin_ = 0;
+        size_t size_ = 0;
+    };
+
+    /**
+     * @brief 编译期解析模式串，规则与 LogFormatter::startParse_ 一致，每得到一个 Token 调用一次 emit
+     * @details 连续的普通字符(包括不认识的 %x)合并成一个 Token；模式非法时抛异常，在 consteval 中即为编译错误
+     */
+    template <typename Emit>
+    constexpr auto Tokenize(std::string_view pattern, Emit&& emit) -> void
+    {
+        auto literal = Token{};
+        auto flush = [&literal, &emit]{
+            if(literal.size_ != 0)
+            {
+                emit(literal);
+            }
+            literal = Token{};
+        };
+        auto extend = [&literal](size_t begin, size_t size){
+            if(literal.size_ == 0)
+            {
+                literal.begin_ = begin;
+            }
+            literal.size_ += size;
+        };
+
+        for(auto i = size_t{0}; i < pattern.size();)
+        {
+            if(pattern[i] != '%')
+            {
+                extend(i, 1);
+                ++i;
+                continue;
+            }
+            if(i + 1 >= pattern.size())
+            {
+                throw "LogFormatter pattern: dangling '%'";
+            }
+            auto c = pattern[i + 1];
+            if(i + 2 < pattern.size() and pattern[i + 2] == '{')
+            {
+                auto close = pattern.find('}', i + 3);
+                if(close == std::string_view::npos)
+                {
+                    throw "LogFormatter pattern: missing '}'";
+                }
+                if(c != 'd')
+                {
+                    throw "LogFormatter pattern: only %d takes a sub pattern";
+                }
+                flush();
+                emit(Token{'d', i + 3, close - (i + 3)});
+                i = close + 1;
+                continue;
+            }
+            if(std::string_view{c_item_chars}.find(c) == std::string_view::npos)
+            {
+                // 不认识的格式符，按普通字符串处理
+                extend(i, 2);
+                i += 2;
+                continue;
+            }
+            flush();
+            emit(Token{c, 0, 0});
+            i += 2;
+        }
+        flush();
+    }
+
+    consteval auto CountTokens(std::string_view pattern) -> size_t
+    {
+        auto count = size_t{0};
+        Tokenize(pattern, [&count](const Token&){ ++count; });
+        return count;
+    }
+
+    template <size_t Count>
+    consteval auto MakeTokens(std::string_view pattern) -> std::array<Token, Count>
+    {
+        auto tokens = std::array<Token, Count>{};
+        auto n = size_t{0};
+        Tokenize(pattern, [&tokens, &n](const Token& token){ tokens[n++] = token; });
+        return tokens;
+    }
+
+} // namespace StaticPattern
+
+/**
+ * @brief 编译期格式器：模式串在编译期解析成 Token 序列，format 展开为一串直接调用，
+ *        没有 variant 分派也没有循环，适合格式固定的热路径
+ * @code
+ *     auto formatter = StaticLogFormatter<"%d{%H:%M:%S} [%p] %m%n">{};
+ *     formatter.format(std::cout, event);
+ * @endcode
+ */
+template <FixedString Pattern>
+class StaticLogFormatter
+{
+    static constexpr auto c_count  = StaticPattern::CountTokens(Pattern.view());
+    static constexpr auto c_tokens = StaticPattern::MakeTokens<c_count>(Pattern.view());
+
+    template <size_t I>
+    static auto formatToken_(LogBuffer& buf, const LogEvent& event) -> void
+    {
+        constexpr auto token = c_tokens[I];
+        if constexpr (token.kind_ == StaticPattern::c_literal)
+        {
+            buf.append(Pattern.view().substr(token.begin_, token.size_));
+        }
+        else if constexpr (token.kind_ == 'd')
+        {
+            // 日期 Item 带有拆好的格式和缓存 id，每个实例化只构造一次
+            static const auto s_date_item = DateTimeFormatItem{std::string{Pattern.view().substr(token.begin_, token.size_)}};
+            s_date_item.format(buf, event);
+        }
+        else
+        {
+            PatternItemOf<token.kind_>::type::format(buf, event);
+        }
+    }
+
+public:
+    [[nodiscard]] static constexpr auto pattern() -> std::string_view { return Pattern.view(); }
+
+    // 把一条日志追加到 buf 末尾，返回追加的字节数
+    auto format(LogBuffer& buf, const LogEvent& event) const -> size_t
+    {
+        auto start = buf.size();
+        // 逗号折叠保证按模式顺序输出
+        [&]<size_t... I>(std::index_sequence<I...>){
+            (formatToken_<I>(buf, event), ...);
+        }(std::make_index_sequence<c_count>{});
+        return buf.size() - start;
+    }
+
+    auto format(std::ostream& os, const LogEvent& event) const -> size_t
+    {
+        thread_local LogBuffer t_buffer;
+        t_buffer.clear();
+        auto total_size = format(t_buffer, event);
+        os.write(t_buffer.data(), static_cast<std::streamsize>(total_size));
+        return total_size;
+    }
+
+    [[nodiscard]] auto format(const LogEvent& event) const -> std::string
+    {
+        auto buf = LogBuffer{};
+        format(buf, event);
+        return std::string{buf.view()};
+    }
+};
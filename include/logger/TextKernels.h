@@ -0,0 +1,113 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+/**
+ * @brief 格式化输出里最热的几个字节循环：找需要转义的字节、短串拷贝、整数转十进制
+ * @details - FindJsonEscape 按本机指令集在运行时选实现(AVX2 每次看 32 字节、SSE2 16 字节、其余逐字节查表)，
+ *            第一次调用时选定，之后只是一次间接调用
+ *          - CopyBytes 对 32 字节以内的拷贝用首尾两次重叠的定长拷贝，编译成一两条向量 load/store，
+ *            不调用 memcpy；更长的交给 memcpy(glibc 自己按 CPU 选 AVX2/ERMS 版本)
+ *          - WriteDecimal 先用前导零个数查表得到位数，再从后往前每次写两位，直接写进目标缓冲
+ */
+namespace TextKernels {
+
+    enum class Isa : uint8_t
+    {
+        Scalar,
+        Sse2,
+        Avx2,
+    };
+
+    // 本机支持的最好一档
+    auto BestIsa() -> Isa;
+
+    auto IsaName(Isa isa) -> std::string_view;
+
+    // 第一个需要 JSON 转义的字节(控制字符、'"'、'\\')的下标，没有时返回 text.size()
+    auto FindJsonEscape(std::string_view text) -> size_t;
+
+    // 指定实现，测试和 benchmark 对比用；本机不支持的指令集退回逐字节实现
+    auto FindJsonEscape(std::string_view text, Isa isa) -> size_t;
+
+    // 拷贝 size 字节，dst 与 src 不重叠
+    inline auto CopyBytes(char* dst, const char* src, size_t size) -> void
+    {
+        // 首尾两段定长拷贝在中间重叠，覆盖 [n, 2n] 之间的任意长度，没有循环也不越界
+        auto copy_pair = [dst, src, size]<size_t N>() {
+            char head[N];
+            char tail[N];
+            std::memcpy(head, src, N);
+            std::memcpy(tail, src + size - N, N);
+            std::memcpy(dst, head, N);
+            std::memcpy(dst + size - N, tail, N);
+        };
+        if(size > 32)
+        {
+            std::memcpy(dst, src, size);
+        }
+        else if(size >= 16)
+        {
+            copy_pair.template operator()<16>();
+        }
+        else if(size >= 8)
+        {
+            copy_pair.template operator()<8>();
+        }
+        else if(size >= 4)
+        {
+            copy_pair.template operator()<4>();
+        }
+        else if(size != 0)
+        {
+            // 1~3 字节：首、中、尾三个字节
+            dst[0] = src[0];
+            dst[size / 2] = src[size / 2];
+            dst[size - 1] = src[size - 1];
+        }
+    }
+
+    // 十进制位数，0 算 1 位
+    constexpr auto DecimalDigits(uint64_t value) -> size_t
+    {
+        constexpr uint64_t c_powers[] = {
+            0, 10, 100, 1'000, 10'000, 100'000, 1'000'000, 10'000'000, 100'000'000, 1'000'000'000,
+            10'000'000'000, 100'000'000'000, 1'000'000'000'000, 10'000'000'000'000, 100'000'000'000'000,
+            1'000'000'000'000'000, 10'000'000'000'000'000, 100'000'000'000'000'000, 1'000'000'000'000'000'000,
+            10'000'000'000'000'000'000U,
+        };
+        // bit_width * 1233 / 4096 是 log10(2^bit_width) 的近似，最多小 1，再和 10 的幂比一次
+        auto guess = static_cast<size_t>(std::bit_width(value | 1) * 1233 >> 12);
+        return guess + (value >= c_powers[guess]);
+    }
+
+    // 把 value 写成恰好 digits 位十进制(digits 必须等于 DecimalDigits(value))，不写结尾的 '\0'
+    inline auto WriteDecimal(char* out, uint64_t value, size_t digits) -> void
+    {
+        constexpr char c_digit_pairs[] =
+            "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+            "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+        auto pos = digits;
+        while(value >= 100)
+        {
+            auto pair = (value % 100) * 2;
+            value /= 100;
+            pos -= 2;
+            std::memcpy(out + pos, c_digit_pairs + pair, 2);
+        }
+        if(value >= 10)
+        {
+            std::memcpy(out + pos - 2, c_digit_pairs + value * 2, 2);
+        }
+        else
+        {
+            out[pos - 1] = static_cast<char>('0' + value);
+        }
+    }
+
+} // namespace TextKernels
@@ -0,0 +1,80 @@
+#pragma once
+#include "logger/LogName.h"
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * @brief 当前线程的身份信息：内核线程号、线程名称句柄、协程号，供构造 LogEvent 时直接读取
+ * @details - 线程第一次用到时取一次 gettid() 和内核里的线程名(pthread_getname_np)并登记到名称驻留表，
+ *            之后每次读取都只是几次线程局部变量的读取，不加锁、不分配
+ *          - fork() 出的子进程里重新取一次线程号，名称和协程号沿用父进程里的
+ *          - SetName() 同时改内核线程名(超过 15 字节截断)，top/gdb 里看到的和日志里的一致
+ *          - 协程号两种接入方式：调度器在切换协程时调用 SetFiberId()(线程局部写)；
+ *            或者注册一个全局钩子，由它从协程库自己的线程局部状态里取，钩子优先
+ * @code
+ *     ThreadContext::SetName("io-worker-3");
+ *     scheduler.onSwitch([](Fiber& f){ ThreadContext::SetFiberId(f.id()); });
+ * @endcode
+ */
+class ThreadContext{
+public:
+    using FiberIdHook = uint32_t (*)();
+
+    ThreadContext() = delete;
+
+    // 当前线程的内核线程号
+    static auto GetTid() -> uint32_t { return local_().tid_; }
+
+    // 当前线程名称的驻留表句柄
+    static auto GetNameId() -> NameId { return local_().name_; }
+
+    static auto GetName() -> std::string_view { return LogNameRegistry::Lookup(GetNameId()); }
+
+    // 设置当前线程的名称，同时设置内核线程名
+    static auto SetName(std::string_view name) -> void;
+
+    // 当前协程号，不在协程里时为 0
+    static auto GetFiberId() -> uint32_t
+    {
+        if(auto hook = s_fiber_hook_.load(std::memory_order_relaxed))
+        {
+            return hook();
+        }
+        return t_local_.fiber_id_;
+    }
+
+    static auto SetFiberId(uint32_t fiber_id) -> void { t_local_.fiber_id_ = fiber_id; }
+
+    // 注册全局协程号钩子，传 nullptr 取消
+    static auto SetFiberIdHook(FiberIdHook hook) -> void { s_fiber_hook_.store(hook, std::memory_order_relaxed); }
+
+private:
+    struct Local{
+        uint32_t tid_ = 0;          // 0 表示还没初始化
+        NameId name_ = LogNameRegistry::c_empty_id;
+        uint32_t fiber_id_ = 0;
+    };
+
+    static auto local_() -> const Local&
+    {
+        if(t_local_.tid_ == 0) [[unlikely]]
+        {
+            init_();
+        }
+        return t_local_;
+    }
+
+    // 取线程号和内核线程名；第一次调用时登记 fork 子进程回调
+    static auto init_() -> void;
+
+    // pthread_atfork 的子进程回调：子进程里只剩调用 fork() 的线程，它缓存的线程号已经不对了
+    static auto onForkChild_() -> void;
+
+    static thread_local Local t_local_;
+    inline static std::atomic<FiberIdHook> s_fiber_hook_ = nullptr;
+};
+
+// Local 的默认成员初始化要等类定义完整后才能用，线程局部变量放到类外定义
+inline thread_local ThreadContext::Local ThreadContext::t_local_;
@@ -0,0 +1,59 @@
+#include "net/Channel.h"
+#include "net/EventLoop.h"
+
+#include <cassert>
+
+Channel::Channel(EventLoop& loop, int fd) : loop_{loop}, fd_{fd} {}
+
+Channel::~Channel()
+{
+    // 析构前必须已经 remove()，否则 EventLoop 里会留下悬空指针
+    assert(not added_);
+}
+
+auto Channel::update_() -> void
+{
+    loop_.updateChannel(*this);
+}
+
+auto Channel::remove() -> void
+{
+    events_ = c_none_event;
+    loop_.removeChannel(*this);
+}
+
+auto Channel::handleEvent(Timestamp receive_time) -> void
+{
+    // 对端挂断且没有数据可读
+    if((revents_ & EPOLLHUP) and not (revents_ & EPOLLIN))
+    {
+        if(close_callback_)
+        {
+            close_callback_();
+        }
+        return;
+    }
+    if(revents_ & EPOLLERR)
+    {
+        if(error_callback_)
+        {
+            error_callback_();
+        }
+        return;
+    }
+    if(revents_ & (EPOLLIN | EPOLLPRI | EPOLLRDHUP))
+    {
+        if(read_callback_)
+        {
+            read_callback_(receive_time);
+        }
+    }
+    // 读回调里可能已经把自己注销了
+    if((revents_ & EPOLLOUT) and added_)
+    {
+        if(write_callback_)
+        {
+            write_callback_();
+        }
+    }
+}
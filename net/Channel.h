@@ -1,4 +1,5 @@
 #pragma once
+#include <concepts>
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -7,7 +8,7 @@
 
 class EventLoop;
 
-namespace{
+namespace ChannelDetail{
     // 定义各种成员函数的探测概念
     template<typename T>
     concept HasHandleRead = requires(T t, Timestamp ts){
@@ -19,5 +20,105 @@ namespace{
         {t.handleWrite_()} -> std::same_as<void>;
     };
 
-    
-}
\ No newline at end of file
+    template<typename T>
+    concept HasHandleClose = requires(T t){
+        {t.handleClose_()} -> std::same_as<void>;
+    };
+
+    template<typename T>
+    concept HasHandleError = requires(T t){
+        {t.handleError_()} -> std::same_as<void>;
+    };
+}
+
+/**
+ * @brief 一个 fd 在 EventLoop 里的登记项：关心哪些事件、就绪后回调谁
+ * @details - 不拥有 fd，fd 的打开和关闭由使用者负责；关闭 fd 之前先 remove()
+ *          - 只能在所属 EventLoop 的线程里操作
+ *          - 回调可以逐个 set，也可以用 bindTo(owner) 按 owner 提供的 handleRead_/handleWrite_/
+ *            handleClose_/handleError_ 成员一次绑定
+ */
+class Channel{
+public:
+    using EventCallback = std::function<void()>;
+    using ReadEventCallback = std::function<void(Timestamp)>;
+
+    Channel(EventLoop& loop, int fd);
+    Channel(const Channel&) = delete;
+    Channel(Channel&&) = delete;
+    auto operator=(const Channel&) -> Channel& = delete;
+    auto operator=(Channel&&) -> Channel& = delete;
+    ~Channel();
+
+    // epoll_wait 返回后由 EventLoop 调用，按 revents 分发
+    auto handleEvent(Timestamp receive_time) -> void;
+
+    auto setReadCallback(ReadEventCallback cb) -> void { read_callback_ = std::move(cb); }
+    auto setWriteCallback(EventCallback cb) -> void { write_callback_ = std::move(cb); }
+    auto setCloseCallback(EventCallback cb) -> void { close_callback_ = std::move(cb); }
+    auto setErrorCallback(EventCallback cb) -> void { error_callback_ = std::move(cb); }
+
+    // 按 owner 的成员函数绑定回调，owner 必须比 Channel 活得久
+    template<typename T>
+    requires ChannelDetail::HasHandleRead<T> or ChannelDetail::HasHandleWrite<T>
+    auto bindTo(T& owner) -> void
+    {
+        if constexpr (ChannelDetail::HasHandleRead<T>)
+        {
+            read_callback_ = [&owner](Timestamp ts){ owner.handleRead_(ts); };
+        }
+        if constexpr (ChannelDetail::HasHandleWrite<T>)
+        {
+            write_callback_ = [&owner]{ owner.handleWrite_(); };
+        }
+        if constexpr (ChannelDetail::HasHandleClose<T>)
+        {
+            close_callback_ = [&owner]{ owner.handleClose_(); };
+        }
+        if constexpr (ChannelDetail::HasHandleError<T>)
+        {
+            error_callback_ = [&owner]{ owner.handleError_(); };
+        }
+    }
+
+    [[nodiscard]] auto fd() const -> int { return fd_; }
+    [[nodiscard]] auto events() const -> uint32_t { return events_; }
+    auto setRevents(uint32_t revents) -> void { revents_ = revents; }
+
+    [[nodiscard]] auto isNoneEvent() const -> bool { return events_ == c_none_event; }
+    [[nodiscard]] auto isReading() const -> bool { return (events_ & c_read_event) != 0; }
+    [[nodiscard]] auto isWriting() const -> bool { return (events_ & c_write_event) != 0; }
+
+    auto enableReading() -> void { events_ |= c_read_event; update_(); }
+    auto disableReading() -> void { events_ &= ~c_read_event; update_(); }
+    auto enableWriting() -> void { events_ |= c_write_event; update_(); }
+    auto disableWriting() -> void { events_ &= ~c_write_event; update_(); }
+    auto disableAll() -> void { events_ = c_none_event; update_(); }
+
+    // 从 EventLoop 里注销，之后不会再收到回调
+    auto remove() -> void;
+
+    [[nodiscard]] auto ownerLoop() -> EventLoop& { return loop_; }
+
+    // EventLoop 用来记录这个 Channel 是否已经加进 epoll
+    [[nodiscard]] auto isAdded() const -> bool { return added_; }
+    auto setAdded(bool added) -> void { added_ = added; }
+
+private:
+    static constexpr uint32_t c_none_event = 0;
+    static constexpr uint32_t c_read_event = EPOLLIN | EPOLLPRI;
+    static constexpr uint32_t c_write_event = EPOLLOUT;
+
+    auto update_() -> void;
+
+    EventLoop& loop_;
+    const int fd_;
+    uint32_t events_ = c_none_event;    // 关心的事件
+    uint32_t revents_ = 0;              // epoll 返回的就绪事件
+    bool added_ = false;
+
+    ReadEventCallback read_callback_;
+    EventCallback write_callback_;
+    EventCallback close_callback_;
+    EventCallback error_callback_;
+};
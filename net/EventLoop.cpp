@@ -0,0 +1,191 @@
+#include "net/EventLoop.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <sys/eventfd.h>
+#include <system_error>
+#include <unistd.h>
+
+EventLoop::EventLoop()
+    : epoll_fd_{::epoll_create1(EPOLL_CLOEXEC)}
+    , wakeup_fd_{::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)}
+    , wakeup_channel_{*this, wakeup_fd_}
+    , events_(c_init_events)
+{
+    if(epoll_fd_ < 0 or wakeup_fd_ < 0)
+    {
+        auto ec = std::error_code(errno, std::system_category());
+        if(epoll_fd_ >= 0)
+        {
+            ::close(epoll_fd_);
+        }
+        if(wakeup_fd_ >= 0)
+        {
+            ::close(wakeup_fd_);
+        }
+        throw std::system_error{ec, "创建 EventLoop 失败"};
+    }
+    wakeup_channel_.setReadCallback([this](Timestamp ts){ handleWakeup_(ts); });
+    wakeup_channel_.enableReading();
+}
+
+EventLoop::~EventLoop()
+{
+    wakeup_channel_.remove();
+    ::close(wakeup_fd_);
+    ::close(epoll_fd_);
+}
+
+auto EventLoop::loop() -> void
+{
+    thread_id_.store(std::this_thread::get_id());
+    while(not quit_.load())
+    {
+        auto count = ::epoll_wait(epoll_fd_, events_.data(), static_cast<int>(events_.size()),
+                                  waitTimeoutMs_(Clock::now()));
+        auto now = Clock::now();
+        if(count < 0 and errno != EINTR)
+        {
+            throw std::system_error{std::error_code(errno, std::system_category()), "epoll_wait 失败"};
+        }
+        for(auto i = 0; i < count; ++i)
+        {
+            auto& channel = *static_cast<Channel*>(events_[i].data.ptr);
+            channel.setRevents(events_[i].events);
+            channel.handleEvent(now);
+        }
+        if(count == static_cast<int>(events_.size()))
+        {
+            events_.resize(events_.size() * 2);
+        }
+        runExpiredTimers_(now);
+        doPendingFunctors_();
+    }
+    thread_id_.store(std::thread::id{});
+}
+
+auto EventLoop::quit() -> void
+{
+    quit_.store(true);
+    if(not isInLoopThread())
+    {
+        wakeup_();
+    }
+}
+
+auto EventLoop::runInLoop(Functor cb) -> void
+{
+    if(isInLoopThread())
+    {
+        cb();
+    }
+    else
+    {
+        queueInLoop(std::move(cb));
+    }
+}
+
+auto EventLoop::queueInLoop(Functor cb) -> void
+{
+    {
+        auto _ = std::lock_guard{mutex_};
+        pending_functors_.push_back(std::move(cb));
+    }
+    // 正在执行投递的任务时再投递，也要唤醒，否则新任务要等到下一次有事件
+    if(not isInLoopThread() or calling_pending_functors_)
+    {
+        wakeup_();
+    }
+}
+
+auto EventLoop::runAfter(std::chrono::milliseconds delay, Functor cb) -> void
+{
+    timers_.push(Timer{Clock::now() + delay, timer_sequence_++, std::move(cb)});
+}
+
+auto EventLoop::updateChannel(Channel& channel) -> void
+{
+    if(not channel.isAdded())
+    {
+        epollCtl_(EPOLL_CTL_ADD, channel);
+        channel.setAdded(true);
+    }
+    else
+    {
+        epollCtl_(EPOLL_CTL_MOD, channel);
+    }
+}
+
+auto EventLoop::removeChannel(Channel& channel) -> void
+{
+    if(channel.isAdded())
+    {
+        epollCtl_(EPOLL_CTL_DEL, channel);
+        channel.setAdded(false);
+    }
+}
+
+auto EventLoop::epollCtl_(int op, Channel& channel) -> void
+{
+    auto event = epoll_event{};
+    event.events = channel.events();
+    event.data.ptr = &channel;
+    if(::epoll_ctl(epoll_fd_, op, channel.fd(), &event) < 0)
+    {
+        throw std::system_error{std::error_code(errno, std::system_category()), "epoll_ctl 失败"};
+    }
+}
+
+auto EventLoop::wakeup_() -> void
+{
+    auto one = uint64_t{1};
+    [[maybe_unused]] auto n = ::write(wakeup_fd_, &one, sizeof(one));
+}
+
+auto EventLoop::handleWakeup_(Timestamp) -> void
+{
+    auto value = uint64_t{0};
+    [[maybe_unused]] auto n = ::read(wakeup_fd_, &value, sizeof(value));
+}
+
+auto EventLoop::doPendingFunctors_() -> void
+{
+    auto functors = std::vector<Functor>{};
+    {
+        auto _ = std::lock_guard{mutex_};
+        functors.swap(pending_functors_);
+    }
+    calling_pending_functors_ = true;
+    for(auto& functor : functors)
+    {
+        functor();
+    }
+    calling_pending_functors_ = false;
+}
+
+auto EventLoop::runExpiredTimers_(Timestamp now) -> void
+{
+    while(not timers_.empty() and timers_.top().when_ <= now)
+    {
+        // 先取出再执行，回调里可以再加定时器
+        auto cb = std::move(const_cast<Timer&>(timers_.top()).cb_);
+        timers_.pop();
+        cb();
+    }
+}
+
+auto EventLoop::waitTimeoutMs_(Timestamp now) const -> int
+{
+    if(timers_.empty())
+    {
+        return c_max_wait_ms;
+    }
+    auto when = timers_.top().when_;
+    if(when <= now)
+    {
+        return 0;
+    }
+    // 向上取整，避免提前醒来空转一轮
+    auto ms = std::chrono::ceil<std::chrono::milliseconds>(when - now).count();
+    return static_cast<int>(std::min<int64_t>(ms, c_max_wait_ms));
+}
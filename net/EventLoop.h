@@ -0,0 +1,98 @@
+#pragma once
+#include "Channel.h"
+#include "Timestamp.h"
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <sys/epoll.h>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 单线程 epoll 事件循环：一个线程调用 loop()，处理就绪的 Channel、到期的定时器和其他线程投递的任务
+ * @details - 其他线程用 runInLoop()/queueInLoop() 投递任务，通过 eventfd 唤醒 epoll_wait
+ *          - 定时器只有一次性的 runAfter()，按到期时间放在小顶堆里，epoll_wait 的超时取最早的到期时间；
+ *            用不到 timerfd，重连退避这类毫秒级的定时够用
+ *          - Channel 的增删改只能在循环线程里做
+ * @code
+ *     auto loop = EventLoop{};
+ *     auto thread = std::thread{[&loop]{ loop.loop(); }};
+ *     loop.runAfter(std::chrono::milliseconds{100}, []{ ... });
+ *     loop.quit();
+ *     thread.join();
+ * @endcode
+ */
+class EventLoop{
+public:
+    using Functor = std::function<void()>;
+
+    EventLoop();
+    EventLoop(const EventLoop&) = delete;
+    EventLoop(EventLoop&&) = delete;
+    auto operator=(const EventLoop&) -> EventLoop& = delete;
+    auto operator=(EventLoop&&) -> EventLoop& = delete;
+    ~EventLoop();
+
+    // 在调用线程里运行，直到 quit()；loop() 开始之前调用的 quit() 同样有效
+    auto loop() -> void;
+
+    // 任意线程可调用：当前这一轮处理完后退出 loop()
+    auto quit() -> void;
+
+    // 在循环线程里执行 cb：当前就在循环线程则立即执行，否则投递
+    auto runInLoop(Functor cb) -> void;
+
+    // 投递到循环线程，在本轮事件处理完之后执行
+    auto queueInLoop(Functor cb) -> void;
+
+    // delay 之后在循环线程里执行一次 cb，只能在循环线程里调用
+    auto runAfter(std::chrono::milliseconds delay, Functor cb) -> void;
+
+    [[nodiscard]] auto isInLoopThread() const -> bool { return thread_id_.load() == std::this_thread::get_id(); }
+
+    // 由 Channel 调用
+    auto updateChannel(Channel& channel) -> void;
+    auto removeChannel(Channel& channel) -> void;
+
+private:
+    static constexpr int c_init_events = 16;
+    static constexpr int c_max_wait_ms = 10'000;
+
+    struct Timer{
+        Timestamp when_;
+        uint64_t sequence_;     // 到期时间相同时先加的先执行
+        Functor cb_;
+
+        auto operator>(const Timer& other) const -> bool
+        {
+            return when_ != other.when_ ? when_ > other.when_ : sequence_ > other.sequence_;
+        }
+    };
+
+    auto wakeup_() -> void;
+    auto handleWakeup_(Timestamp) -> void;
+    auto doPendingFunctors_() -> void;
+    auto runExpiredTimers_(Timestamp now) -> void;
+
+    // 距最早的定时器到期还有多少毫秒，没有定时器时返回 c_max_wait_ms
+    auto waitTimeoutMs_(Timestamp now) const -> int;
+
+    auto epollCtl_(int op, Channel& channel) -> void;
+
+    std::atomic<bool> quit_ = false;
+    std::atomic<std::thread::id> thread_id_;
+    int epoll_fd_ = -1;
+    int wakeup_fd_ = -1;
+    Channel wakeup_channel_;
+    std::vector<epoll_event> events_;
+
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<>> timers_;
+    uint64_t timer_sequence_ = 0;
+
+    std::mutex mutex_;
+    std::vector<Functor> pending_functors_;     // 受 mutex_ 保护
+    std::atomic<bool> calling_pending_functors_ = false;
+};
@@ -0,0 +1,5 @@
+#pragma once
+#include "common/alias.h"
+
+// 事件循环里的时间点：epoll_wait 返回的时刻，定时器也按它计算，单调时钟不受改系统时间影响
+using Timestamp = TimePoint;
@@ -0,0 +1,173 @@
+#include "logger/LoggerAppender.h"
+#include "logger/BinaryLogFormat.h"
+#include "common/alias.h"
+
+#include <array>
+#include <cerrno>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace {
+
+// 把 iov 全部写完(处理部分写入和 EINTR)
+auto WriteAll(int fd, iovec* iov, int count, const std::string& filename) -> void
+{
+    while(count > 0)
+    {
+        auto written = ::writev(fd, iov, count);
+        if(written < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error(
+                std::error_code(errno, std::system_category()), " 写入日志文件失败: " + filename
+            );
+        }
+        auto left = static_cast<size_t>(written);
+        while(count > 0 and left >= iov->iov_len)
+        {
+            left -= iov->iov_len;
+            ++iov;
+            --count;
+        }
+        if(count > 0)
+        {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+            iov->iov_len -= left;
+        }
+    }
+}
+
+} // namespace
+
+/*===========================BinaryFileAppender==================*/
+
+BinaryFileAppender::BinaryFileAppender(std::string filename,
+                                       size_t max_bytes,
+                                       Seconds roll_interval)
+    : RollingFileBase{std::move(filename), max_bytes, roll_interval}
+{
+    openFile_();
+}
+
+BinaryFileAppender::~BinaryFileAppender(){
+    auto _ = std::lock_guard{mutex_};
+    if(fd_ >= 0)
+    {
+        try{
+            sealBlock_();
+        } catch (const std::system_error& e){
+            // 析构函数里不能再抛出，只能报告
+            std::cerr << "[ERROR] BinaryFileAppender: " << e.what() << std::endl;
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+auto BinaryFileAppender::openFile_() -> void{
+    reopen_error_ = false;
+
+    fd_ = ::open(filename_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if(fd_ < 0)
+    {
+        auto ec = std::error_code(errno, std::system_category());
+        reopen_error_ = true;
+        throw std::system_error{ec, "打开日志文件失败: " + filename_};
+    }
+    last_open_time_ = Clock::now();
+
+    // 追加到已有文件时也写文件头，读取时据此确认格式版本
+    auto header = LogBuffer{};
+    BinaryLog::PutFileHeader(header);
+    auto iov = iovec{const_cast<char*>(header.data()), header.size()};
+    WriteAll(fd_, &iov, 1, filename_);
+
+    struct stat file_stat {};
+    offset_ = ::fstat(fd_, &file_stat) == 0 ? static_cast<size_t>(file_stat.st_size) : 0;
+    encoder_.reset();
+}
+
+auto BinaryFileAppender::rollFile_() -> void{
+    auto timer = ScopedLatency{rotation_ns_};
+    if(fd_ < 0)
+    {
+        openFile_();
+    }
+    sealBlock_();
+    ::close(fd_);
+    fd_ = -1;
+    renameCurrent_();
+    openFile_();
+}
+
+auto BinaryFileAppender::encode_(const LogEvent& event) -> void{
+    offset_ += encoder_.encode(event);
+    if(encoder_.size() >= c_block_size)
+    {
+        sealBlock_();
+    }
+}
+
+auto BinaryFileAppender::sealBlock_() -> void{
+    if(encoder_.empty())
+    {
+        return;
+    }
+    auto header = LogBuffer{};
+    encoder_.putBlockHeader(header);
+
+    auto payload = encoder_.payload();
+    auto iov = std::array<iovec, 2>{iovec{const_cast<char*>(header.data()), header.size()},
+                                    iovec{const_cast<char*>(payload.data()), payload.size()}};
+    WriteAll(fd_, iov.data(), static_cast<int>(iov.size()), filename_);
+    offset_ += header.size();
+
+    encoder_.reset();
+}
+
+auto BinaryFileAppender::maybeFlush_(uint64_t appends) -> void{
+    flush_count_ += appends;
+    auto now = Clock::now();
+    if(now - last_flush_time_ >= c_flush_seconds or flush_count_ >= c_flush_max_appends)
+    {
+        sealBlock_();
+        last_flush_time_ = now;
+        flush_count_ = 0;
+    }
+}
+
+auto BinaryFileAppender::log(const LogFormatter&, const LogEvent& event) -> void {
+    auto _ = std::lock_guard{mutex_};
+    if(shouldRoll_())
+    {
+        rollFile_();
+    }
+    encode_(event);
+    maybeFlush_(1);
+}
+
+auto BinaryFileAppender::log(const LogFormatter&, std::span<const LogEvent> events) -> void {
+    auto _ = std::lock_guard{mutex_};
+
+    // 同 RollingFileAppender：时间条件整批只查一次，批内只按大小滚动
+    if(shouldRoll_())
+    {
+        rollFile_();
+    }
+    for(const auto& event : events)
+    {
+        if(offset_ > max_bytes_)
+        {
+            rollFile_();
+        }
+        encode_(event);
+    }
+    maybeFlush_(events.size());
+}
@@ -0,0 +1,177 @@
+#include "logger/BinaryLogFormat.h"
+
+#include <algorithm>
+#include <zlib.h>
+
+namespace BinaryLog {
+
+auto PutFileHeader(LogBuffer& buf) -> void
+{
+    buf.append(c_file_magic, sizeof(c_file_magic));
+    PutFixed32(buf, c_version);
+    PutFixed32(buf, 0);
+}
+
+auto BlockEncoder::SiteKeyHash::operator()(const SiteKey& key) const noexcept -> size_t
+{
+    auto hash = std::hash<const void*>{}(key.file_);
+    hash ^= std::hash<const void*>{}(key.function_) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    hash ^= std::hash<uint32_t>{}(key.line_) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+BlockEncoder::BlockEncoder()
+{
+    reset();
+}
+
+auto BlockEncoder::reset() -> void
+{
+    block_.clear();
+    // 驻留表按块增长，这里先按一块的大小准备，遇到更大的句柄时在 nameId_ 里扩大
+    name_ids_.assign(std::max<size_t>(name_ids_.size(), LogNameRegistry::c_k_chunk_names), 0);
+    string_ids_.clear();
+    site_ids_.clear();
+    next_string_id_ = 1;
+    next_site_id_ = 1;
+    last_timestamp_us_ = 0;
+}
+
+auto BlockEncoder::putBlockHeader(LogBuffer& out) const -> void
+{
+    PutFixed32(out, c_block_magic);
+    PutFixed32(out, static_cast<uint32_t>(block_.size()));
+    PutFixed32(out, static_cast<uint32_t>(
+        crc32(0, reinterpret_cast<const Bytef*>(block_.data()), static_cast<uInt>(block_.size()))));
+}
+
+auto BlockEncoder::sealInto(LogBuffer& out) -> void
+{
+    if(block_.empty())
+    {
+        return;
+    }
+    putBlockHeader(out);
+    out.append(block_.view());
+    reset();
+}
+
+auto BlockEncoder::putString_(uint32_t id, std::string_view text) -> void
+{
+    block_.push_back(static_cast<char>(EntryTag::String));
+    PutVarint(block_, id);
+    PutVarint(block_, text.size());
+    block_.append(text);
+}
+
+auto BlockEncoder::nameId_(NameId name) -> uint32_t
+{
+    if(name >= name_ids_.size())
+    {
+        name_ids_.resize(std::max<size_t>(name + 1, name_ids_.size() * 2), 0);
+    }
+    if(name_ids_[name] == 0)
+    {
+        name_ids_[name] = next_string_id_++;
+        putString_(name_ids_[name], LogNameRegistry::Lookup(name));
+    }
+    return name_ids_[name];
+}
+
+auto BlockEncoder::staticStringId_(std::string_view text) -> uint32_t
+{
+    auto [it, inserted] = string_ids_.try_emplace(text.data(), next_string_id_);
+    if(inserted)
+    {
+        ++next_string_id_;
+        putString_(it->second, text);
+    }
+    return it->second;
+}
+
+auto BlockEncoder::siteId_(const LogEvent& event) -> uint32_t
+{
+    auto key = SiteKey{event.getFilename().data(), event.getFunctionName().data(), event.getLine()};
+    if(auto it = site_ids_.find(key); it != site_ids_.end())
+    {
+        return it->second;
+    }
+    auto file = staticStringId_(event.getFilename());
+    auto function = staticStringId_(event.getFunctionName());
+    auto id = next_site_id_++;
+    site_ids_.emplace(key, id);
+
+    block_.push_back(static_cast<char>(EntryTag::Site));
+    PutVarint(block_, id);
+    PutVarint(block_, file);
+    PutVarint(block_, function);
+    PutVarint(block_, key.line_);
+    return id;
+}
+
+auto BlockEncoder::encode(const LogEvent& event) -> size_t
+{
+    auto start = block_.size();
+
+    // 字典条目必须写在引用它们的事件之前
+    auto logger_name = nameId_(event.getLoggerNameId());
+    auto thread_name = nameId_(event.getThreadNameId());
+    auto site = siteId_(event);
+    auto args = event.isDeferred() ? event.getDeferredArgs() : LogEvent::DeferredArgs{};
+    auto raw = event.isDeferred() and std::ranges::none_of(args.types_, [](ArgType type){ return type == ArgType::Other; });
+    auto format = raw ? staticStringId_(args.format_) : 0;
+    auto field_count = size_t{0};
+    event.forEachField([this, &field_count](const LogEvent::Field& field){
+        staticStringId_(field.key_);
+        ++field_count;
+    });
+
+    auto timestamp_us = static_cast<int64_t>(event.getTime()) * LogEvent::c_k_us_per_second + event.getMicrosecond();
+    block_.push_back(static_cast<char>(EntryTag::Event));
+    block_.push_back(static_cast<char>(event.getLevel()));
+    PutVarint(block_, ZigZag(timestamp_us - last_timestamp_us_));
+    PutVarint(block_, event.getThreadId());
+    PutVarint(block_, event.getFiberId());
+    PutVarint(block_, event.getElapse());
+    PutVarint(block_, logger_name);
+    PutVarint(block_, thread_name);
+    PutVarint(block_, site);
+    PutVarint(block_, format);
+    last_timestamp_us_ = timestamp_us;
+
+    if(raw)
+    {
+        // 参数字节原样写出，格式化留给解码工具
+        block_.push_back(static_cast<char>(args.types_.size()));
+        for(auto type : args.types_)
+        {
+            block_.push_back(static_cast<char>(type));
+        }
+        PutVarint(block_, args.bytes_.size());
+        block_.append(args.bytes_.data(), args.bytes_.size());
+    }
+    else if(event.isDeferred())
+    {
+        // 有只能在本进程格式化的参数(枚举、自定义类型)，写格式化后的文本
+        auto text = event.rendered();
+        PutVarint(block_, text.getContent().size());
+        block_.append(text.getContent());
+    }
+    else
+    {
+        PutVarint(block_, event.getContent().size());
+        block_.append(event.getContent());
+    }
+
+    // 结构化字段：数值按原始字节，字符串按文本，键和格式串一样走块内字典
+    PutVarint(block_, field_count);
+    event.forEachField([this](const LogEvent::Field& field){
+        PutVarint(block_, staticStringId_(field.key_));
+        block_.push_back(static_cast<char>(field.type_));
+        PutVarint(block_, field.value_.size());
+        block_.append(field.value_.data(), field.value_.size());
+    });
+    return block_.size() - start;
+}
+
+} // namespace BinaryLog
@@ -0,0 +1,332 @@
+#include "logger/BinaryLogReader.h"
+#include "logger/LogName.h"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <system_error>
+#include <zlib.h>
+
+namespace {
+
+constexpr std::string_view c_block_magic_bytes = "CBLK";    // c_block_magic 的小端字节
+constexpr size_t c_max_args = 256;
+
+// 按类型取出第 index 个参数，用单个占位符 "{:spec}" 格式化
+auto FormatArg(std::string& out, size_t index, std::string_view spec,
+               std::span<const ArgType> types, std::string_view bytes) -> bool
+{
+    if(index >= types.size())
+    {
+        return false;
+    }
+    auto offset = size_t{0};
+    for(auto i = size_t{0}; i < index; ++i)
+    {
+        offset += BinaryLog::ArgSize(types[i]);
+    }
+    auto type = types[index];
+    if(type == ArgType::Other or offset + BinaryLog::ArgSize(type) > bytes.size())
+    {
+        return false;
+    }
+
+    auto field = std::string{"{:"};
+    field.append(spec);
+    field.push_back('}');
+    auto emit = [&]<typename T>() {
+        auto value = T{};
+        if constexpr (not std::is_same_v<T, std::nullptr_t>)
+        {
+            std::memcpy(&value, bytes.data() + offset, sizeof(T));
+        }
+        std::vformat_to(std::back_inserter(out), field, std::make_format_args(value));
+    };
+    try{
+        switch(type)
+        {
+            case ArgType::Bool:    emit.operator()<bool>(); break;
+            case ArgType::Char:    emit.operator()<char>(); break;
+            case ArgType::Int8:    emit.operator()<int8_t>(); break;
+            case ArgType::UInt8:   emit.operator()<uint8_t>(); break;
+            case ArgType::Int16:   emit.operator()<int16_t>(); break;
+            case ArgType::UInt16:  emit.operator()<uint16_t>(); break;
+            case ArgType::Int32:   emit.operator()<int32_t>(); break;
+            case ArgType::UInt32:  emit.operator()<uint32_t>(); break;
+            case ArgType::Int64:   emit.operator()<int64_t>(); break;
+            case ArgType::UInt64:  emit.operator()<uint64_t>(); break;
+            case ArgType::Float:   emit.operator()<float>(); break;
+            case ArgType::Double:  emit.operator()<double>(); break;
+            case ArgType::Pointer: emit.operator()<const void*>(); break;
+            case ArgType::Null:    emit.operator()<std::nullptr_t>(); break;
+            case ArgType::Other:   return false;
+        }
+    } catch (const std::format_error&){
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+BinaryLogReader::BinaryLogReader(const std::string& filename)
+{
+    auto stream = std::ifstream{filename, std::ios::in | std::ios::binary};
+    if(not stream)
+    {
+        throw std::system_error{std::error_code(errno, std::system_category()), "打开日志文件失败: " + filename};
+    }
+    data_.assign(std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{});
+    if(not readFileHeader_())
+    {
+        throw std::runtime_error{"不是 cotton 二进制日志或版本不支持: " + filename};
+    }
+}
+
+auto BinaryLogReader::readFileHeader_() -> bool
+{
+    auto header = BinaryLog::Cursor{std::string_view{data_}.substr(pos_)};
+    auto magic = header.getBytes(sizeof(BinaryLog::c_file_magic));
+    auto version = header.getFixed32();
+    header.getFixed32();
+    if(not header.ok() or magic != std::string_view{BinaryLog::c_file_magic, sizeof(BinaryLog::c_file_magic)}
+       or version < BinaryLog::c_min_version or version > BinaryLog::c_version)
+    {
+        return false;
+    }
+    version_ = version;
+    pos_ += BinaryLog::c_file_header_size;
+    return true;
+}
+
+auto BinaryLogReader::nextBlock_() -> bool
+{
+    auto view = std::string_view{data_};
+    auto file_magic = std::string_view{BinaryLog::c_file_magic, sizeof(BinaryLog::c_file_magic)};
+    while(pos_ < view.size())
+    {
+        // 追加写入时中途出现的文件头
+        if(view.substr(pos_).starts_with(file_magic) and readFileHeader_())
+        {
+            continue;
+        }
+
+        auto header = BinaryLog::Cursor{view.substr(pos_)};
+        auto magic = header.getFixed32();
+        auto size = header.getFixed32();
+        auto crc = header.getFixed32();
+        auto payload = header.getBytes(size);
+        if(header.ok() and magic == BinaryLog::c_block_magic and
+           crc == crc32(0, reinterpret_cast<const Bytef*>(payload.data()), static_cast<uInt>(payload.size())))
+        {
+            pos_ += BinaryLog::c_block_header_size + size;
+            block_ = BinaryLog::Cursor{payload};
+            last_timestamp_us_ = 0;
+            strings_.clear();
+            sites_.clear();
+            return true;
+        }
+
+        // 损坏或不完整(比如写到一半时崩溃)：跳到下一个块头或文件头
+        ++corrupt_blocks_;
+        auto next = std::min(view.find(c_block_magic_bytes, pos_ + 1), view.find(file_magic, pos_ + 1));
+        pos_ = next == std::string_view::npos ? view.size() : next;
+    }
+    return false;
+}
+
+auto BinaryLogReader::next(LogEvent& event) -> bool
+{
+    while(true)
+    {
+        while(not block_.done())
+        {
+            if(readEntry_(event))
+            {
+                return true;
+            }
+        }
+        if(not block_.ok())
+        {
+            // 校验通过但内容解不开，通常是更新版本写出的文件
+            ++corrupt_blocks_;
+        }
+        if(not nextBlock_())
+        {
+            return false;
+        }
+    }
+}
+
+auto BinaryLogReader::readEntry_(LogEvent& event) -> bool
+{
+    switch(static_cast<BinaryLog::EntryTag>(block_.getByte()))
+    {
+        case BinaryLog::EntryTag::String:
+        {
+            auto id = block_.getVarint();
+            auto text = block_.getBytes(block_.getVarint());
+            if(block_.ok())
+            {
+                strings_[id] = &string_storage_.emplace_back(text);
+            }
+            return false;
+        }
+        case BinaryLog::EntryTag::Site:
+        {
+            auto id = block_.getVarint();
+            auto file = block_.getVarint();
+            auto function = block_.getVarint();
+            auto line = block_.getVarint();
+            if(block_.ok())
+            {
+                sites_[id] = &site_storage_.emplace_back(LogEvent::SourceSite{lookupString_(file).data(), lookupString_(function).data(),
+                                                                              static_cast<uint32_t>(line)});
+            }
+            return false;
+        }
+        case BinaryLog::EntryTag::Event:
+            break;
+        default:
+            block_.fail();
+            return false;
+    }
+
+    // 级别字节来自文件，超出枚举范围时还原成 UNKNOW，不让无效值流到 LevelToString
+    auto level_byte = static_cast<int8_t>(block_.getByte());
+    auto level = level_byte >= static_cast<int8_t>(LogLevel::ALL) and level_byte <= static_cast<int8_t>(LogLevel::SYSFATAL)
+                     ? static_cast<LogLevel>(level_byte) : LogLevel::UNKNOW;
+    auto timestamp_us = last_timestamp_us_ + BinaryLog::UnZigZag(block_.getVarint());
+    auto thread_id = static_cast<uint32_t>(block_.getVarint());
+    auto co_id = static_cast<uint32_t>(block_.getVarint());
+    auto elapse = static_cast<uint32_t>(block_.getVarint());
+    auto logger_name = block_.getVarint();
+    auto thread_name = block_.getVarint();
+    auto site = block_.getVarint();
+    auto format = block_.getVarint();
+    last_timestamp_us_ = timestamp_us;
+
+    auto decoded = LogEvent{LogNameRegistry::Intern(lookupString_(logger_name)), level, elapse, thread_id,
+                            LogNameRegistry::Intern(lookupString_(thread_name)), 0, co_id, std::source_location{}};
+    if(auto it = sites_.find(site); it != sites_.end())
+    {
+        decoded.setSourceSite(it->second);
+    }
+    decoded.setTimePoint(std::chrono::system_clock::time_point{std::chrono::microseconds{timestamp_us}});
+    if(format != 0)
+    {
+        auto count = block_.getByte();
+        auto types = std::array<ArgType, c_max_args>{};
+        for(auto i = size_t{0}; i < count; ++i)
+        {
+            auto type = block_.getByte();
+            if(type > static_cast<uint8_t>(ArgType::Other))
+            {
+                block_.fail();
+            }
+            types[i] = static_cast<ArgType>(type);
+        }
+        auto bytes = block_.getBytes(block_.getVarint());
+        if(block_.ok())
+        {
+            decoded.append(RenderArgs(lookupString_(format), std::span<const ArgType>{types.data(), count}, bytes));
+        }
+    }
+    else
+    {
+        decoded.append(block_.getBytes(block_.getVarint()));
+    }
+    if(version_ >= 2)
+    {
+        // 字段的键指向 string_storage_，和文件名、函数名一样由 reader 持有
+        auto count = block_.getVarint();
+        for(auto i = uint64_t{0}; i < count and block_.ok(); ++i)
+        {
+            auto key = lookupString_(block_.getVarint());
+            auto type = block_.getByte();
+            auto value = block_.getBytes(block_.getVarint());
+            if(type > static_cast<uint8_t>(ArgType::Other))
+            {
+                block_.fail();
+            }
+            if(block_.ok())
+            {
+                decoded.addRawField(key, static_cast<ArgType>(type), value);
+            }
+        }
+    }
+    if(not block_.ok())
+    {
+        return false;
+    }
+    event = std::move(decoded);
+    return true;
+}
+
+auto BinaryLogReader::lookupString_(uint64_t id) const -> std::string_view
+{
+    auto it = strings_.find(id);
+    return it != strings_.end() ? std::string_view{*it->second} : std::string_view{""};
+}
+
+auto BinaryLogReader::RenderArgs(std::string_view fmt, std::span<const ArgType> types, std::string_view bytes) -> std::string
+{
+    // 逐个替换字段分别格式化，规则同 std::format：{{ 和 }} 是转义，{} 按顺序取参数，{n} 取第 n 个
+    auto out = std::string{};
+    auto next_arg = size_t{0};
+    for(auto i = size_t{0}; i < fmt.size();)
+    {
+        auto c = fmt[i];
+        if(c == '{' and i + 1 < fmt.size() and fmt[i + 1] == '{')
+        {
+            out.push_back('{');
+            i += 2;
+            continue;
+        }
+        if(c == '}')
+        {
+            out.push_back('}');
+            i += i + 1 < fmt.size() and fmt[i + 1] == '}' ? 2 : 1;
+            continue;
+        }
+        if(c != '{')
+        {
+            out.push_back(c);
+            ++i;
+            continue;
+        }
+
+        auto close = fmt.find('}', i);
+        if(close == std::string_view::npos)
+        {
+            out.append(fmt.substr(i));
+            break;
+        }
+        auto field = fmt.substr(i + 1, close - i - 1);
+        auto colon = field.find(':');
+        auto id = field.substr(0, colon);
+        auto spec = colon == std::string_view::npos ? std::string_view{} : field.substr(colon + 1);
+        auto index = next_arg++;
+        if(not id.empty())
+        {
+            index = 0;
+            for(auto digit : id)
+            {
+                index = index * 10 + static_cast<size_t>(digit - '0');
+            }
+        }
+        // 嵌套的动态宽度/精度({:{}})不支持，连同解不开的参数一起原样输出
+        if(spec.find('{') != std::string_view::npos or not FormatArg(out, index, spec, types, bytes))
+        {
+            out.append(fmt.substr(i, close - i + 1));
+        }
+        i = close + 1;
+    }
+    return out;
+}
@@ -1,23 +1,204 @@
 #include "logger/LogEvent.h"
-#include "logger/Logger.h"
 #include "logger/LogLevel.h"
+#include "logger/MessageArena.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <string>
 #include <source_location>
 #include <utility>
 
 /*===================================Event=======================================*/
-LogEvent::LogEvent(std::string logger_name,
+LogEvent::LogEvent(NameId logger_name,
                     LogLevel level,
                     uint32_t elapse,
                     uint32_t thread_id,
-                    std::string thread_name,
+                    NameId thread_name,
                     time_t timestamp,
                     uint32_t co_id,
                     std::source_location source_loc)
-    : logger_name_(std::move(logger_name)),
+    : location_{source_loc},
+      timestamp_us_(static_cast<int64_t>(timestamp) * c_k_us_per_second),
+      logger_name_(logger_name),
+      thread_name_(thread_name),
       level_(level),
       elapse_(elapse),
       thread_id_(thread_id),
-      thread_name_(std::move(thread_name)),
-      timestamp_(timestamp),
-      co_id_(co_id),
-      source_loc_(source_loc) {}
\ No newline at end of file
+      co_id_(co_id) {}
+
+LogEvent::LogEvent(std::string_view logger_name,
+                    LogLevel level,
+                    uint32_t elapse,
+                    uint32_t thread_id,
+                    std::string_view thread_name,
+                    time_t timestamp,
+                    uint32_t co_id,
+                    std::source_location source_loc)
+    : LogEvent(LogNameRegistry::Intern(logger_name), level, elapse, thread_id,
+               LogNameRegistry::Intern(thread_name), timestamp, co_id, source_loc) {}
+
+// 移动 = 拷贝定长字段 + 只拷贝内联消息里用到的字节 + 转移溢出块的所有权
+LogEvent::LogEvent(LogEvent&& other) noexcept
+    : location_(other.location_),
+      timestamp_us_(other.timestamp_us_),
+      overflow_(std::exchange(other.overflow_, nullptr)),
+      logger_name_(other.logger_name_),
+      thread_name_(other.thread_name_),
+      level_(other.level_),
+      has_site_(other.has_site_),
+      fields_len_(std::exchange(other.fields_len_, 0)),
+      elapse_(other.elapse_),
+      thread_id_(other.thread_id_),
+      co_id_(other.co_id_),
+      msg_len_(std::exchange(other.msg_len_, 0)),
+      overflow_cap_(other.overflow_cap_),
+      deferred_(std::exchange(other.deferred_, nullptr))
+{
+    if(overflow_ == nullptr)
+    {
+        std::memcpy(inline_msg_, other.inline_msg_, msg_len_ + fields_len_);
+    }
+}
+
+LogEvent& LogEvent::operator=(LogEvent&& other) noexcept
+{
+    if(this != &other)
+    {
+        releaseOverflow_();
+        location_     = other.location_;
+        timestamp_us_ = other.timestamp_us_;
+        overflow_     = std::exchange(other.overflow_, nullptr);
+        logger_name_  = other.logger_name_;
+        thread_name_  = other.thread_name_;
+        level_        = other.level_;
+        has_site_     = other.has_site_;
+        fields_len_   = std::exchange(other.fields_len_, 0);
+        elapse_       = other.elapse_;
+        thread_id_    = other.thread_id_;
+        co_id_        = other.co_id_;
+        msg_len_      = std::exchange(other.msg_len_, 0);
+        overflow_cap_ = other.overflow_cap_;
+        deferred_     = std::exchange(other.deferred_, nullptr);
+        if(overflow_ == nullptr)
+        {
+            std::memcpy(inline_msg_, other.inline_msg_, msg_len_ + fields_len_);
+        }
+    }
+    return *this;
+}
+
+auto LogEvent::rendered() const -> LogEvent
+{
+    auto out = LogEvent{logger_name_, level_, elapse_, thread_id_, thread_name_, 0, co_id_};
+    out.location_ = location_;
+    out.has_site_ = has_site_;
+    out.timestamp_us_ = timestamp_us_;
+    if(isDeferred())
+    {
+        deferred_->render_(storage_(), out);
+    }
+    else
+    {
+        out.append(getContent());
+    }
+    out.copyFields_(*this);
+    return out;
+}
+
+auto LogEvent::getDeferredArgs() const -> DeferredArgs
+{
+    auto fmt = std::string_view{};
+    // 加了字段后整块可能已经换到溢出块里
+    std::memcpy(&fmt, storage_(), sizeof(fmt));
+    return DeferredArgs{fmt,
+                        std::span<const ArgType>{deferred_->types_, deferred_->count_},
+                        std::span<const char>{storage_() + sizeof(fmt), msg_len_ - sizeof(fmt)}};
+}
+
+void LogEvent::vprint_(std::string_view fmt, std::format_args args)
+{
+    // 后台线程渲染延迟参数、或者已有字段时的 print，暂存串热身后不再分配
+    thread_local std::string t_scratch;
+    t_scratch.clear();
+    std::vformat_to(std::back_inserter(t_scratch), fmt, args);
+    append(t_scratch);
+}
+
+void LogEvent::append(std::string_view text)
+{
+    materialize();
+    if(msg_len_ + fields_len_ + text.size() > capacity_())
+    {
+        reserve_(msg_len_ + fields_len_ + text.size());
+    }
+    // 字段区整体后移，消息接在原来的消息后面
+    if(fields_len_ != 0)
+    {
+        std::memmove(tail_() + text.size(), tail_(), fields_len_);
+    }
+    std::memcpy(tail_(), text.data(), text.size());
+    msg_len_ += static_cast<uint32_t>(text.size());
+}
+
+void LogEvent::addRawField(std::string_view key, ArgType type, std::span<const char> value)
+{
+    putField_(key, type, value.data(), value.size());
+}
+
+void LogEvent::putField_(std::string_view key, ArgType type, const void* value, size_t size)
+{
+    auto record = sizeof(FieldHeader_) + size;
+    if(key.size() > UINT8_MAX or fields_len_ + record > c_k_max_fields_bytes)
+    {
+        return;
+    }
+    auto end = msg_len_ + fields_len_;
+    if(end + record > capacity_())
+    {
+        reserve_(end + record);
+    }
+    auto header = FieldHeader_{type, static_cast<uint8_t>(key.size()), static_cast<uint16_t>(size), key.data()};
+    auto* dst = storage_() + end;
+    std::memcpy(dst, &header, sizeof(header));
+    std::memcpy(dst + sizeof(header), value, size);
+    fields_len_ = static_cast<uint16_t>(fields_len_ + record);
+}
+
+void LogEvent::copyFields_(const LogEvent& from)
+{
+    if(from.fields_len_ == 0)
+    {
+        return;
+    }
+    auto end = msg_len_ + fields_len_;
+    if(end + from.fields_len_ > capacity_())
+    {
+        reserve_(end + from.fields_len_);
+    }
+    std::memcpy(storage_() + end, from.storage_() + from.msg_len_, from.fields_len_);
+    fields_len_ = static_cast<uint16_t>(fields_len_ + from.fields_len_);
+}
+
+void LogEvent::reserve_(size_t size)
+{
+    if(size <= capacity_())
+    {
+        return;
+    }
+    // 按倍数增长，避免多次 print 追加时反复换块
+    auto* block = MessageArena::Acquire(std::max(size, capacity_() * 2));
+    std::memcpy(block, storage_(), msg_len_ + fields_len_);
+    releaseOverflow_();
+    overflow_ = block;
+    overflow_cap_ = static_cast<uint32_t>(MessageArena::Capacity(block));
+}
+
+void LogEvent::releaseOverflow_()
+{
+    if(overflow_ != nullptr)
+    {
+        MessageArena::Release(overflow_);
+        overflow_ = nullptr;
+        overflow_cap_ = 0;
+    }
+}
@@ -4,8 +4,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
-#include <unordered_map>
-#include <functional>
+#include <iostream>
 
 namespace{
 
@@ -17,43 +16,8 @@ enum class ParseState{
 
 }   //namespace
 
-class PatternItemFacade;
-
-// 1. 无参工厂：生产不需要参数的 Item (如 %m 消息, %n 换行)
-using ItemFactoryFunc = std::function<Sptr<PatternItemFacade>()>;
-
-// 注册无参工厂函数, 如果这个函数被调用，就会返回一个映射表，表里存着各种格式符对应的工厂函数
-// 比如 "%m" -> 生产 MessageItem 的工厂函数
-auto RegisterItemFactoryFunc() -> std::unordered_map<std::string, ItemFactoryFunc>;
-
-// 2. 有参工厂：生产需要字符串参数的 Item (如 %d{...} 日期, 普通字符串)
-// 格式：std::function<返回值类型(参数类型1, 参数类型2, ...)> 变量名;
-// 这个函数类型表示一个函数，它接受一个 std::string 参数，并返回一个智能指针，指向 PatternItemFacade 类型的对象。
-using StatusItemFactoryFunc = std::function<Sptr<PatternItemFacade>(std::string)>;
-
-// 注册有参工厂函数
-// 这个函数被调用时，会返回一个映射表，表里存着各种格式符对应的工厂函数
-// 比如 "%d" -> 生产 DateItem 的工厂函数
-auto RegisterStatusItemFactoryFunc() -> std::unordered_map<std::string, StatusItemFactoryFunc>;
-
 void LogFormatter::startParse_()
 {
-    // 最后的小括号意思是立即调用这个lambda表达式，并将返回值赋值给变量, 用lambda表达式初始化静态变量
-    // 静态局部变量初始化 只会执行一次，第一次调用时初始化，后续调用时直接使用已初始化的值
-
-    // s_ProduceFuncMap1 放的是普通的单字符占位符
-    static auto s_ProduceFuncMap1 = []() -> std::unordered_map<std::string, ItemFactoryFunc>{
-        return RegisterItemFactoryFunc();
-    }();
-
-    // s_ProduceFuncMap2 放的是需要参数的占位符，主要是普通字符串和日期时间
-    static auto s_ProduceFuncMap2 = []() -> std::unordered_map<std::string, StatusItemFactoryFunc>{
-        return RegisterStatusItemFactoryFunc();
-    }();
-
-    assert(s_ProduceFuncMap1.size() != 0);
-    assert(s_ProduceFuncMap2.size() != 0);
-
     auto normal_str = std::string{};   
     auto state = ParseState::NORMAL;
 
@@ -68,8 +32,7 @@ void LogFormatter::startParse_()
                     i++;
                 } else {
                     if(!normal_str.empty()) {
-                        auto produce_func = s_ProduceFuncMap2["str"];
-                        pattern_items_.push_back(produce_func(std::move(normal_str)));
+                        pattern_items_.emplace_back(std::in_place_type<StringFormatItem>, std::move(normal_str));
                         normal_str.clear();
                     }
                     state = ParseState::PATTERN;
@@ -89,8 +52,9 @@ void LogFormatter::startParse_()
                     break;
                 }
                 
-                // 2. 这是一个普通的格式符号 (例如 %m, %p)，查找 Map
-                if(s_ProduceFuncMap1.find(std::string(1,c)) == s_ProduceFuncMap1.end())
+                // 2. 这是一个普通的格式符号 (例如 %m, %p)，查表生产
+                auto item = MakePatternItem(c);
+                if(not item)
                 {
                     // 没找到，按普通字符串处理
                     normal_str.push_back('%');
@@ -99,10 +63,8 @@ void LogFormatter::startParse_()
                     i++; // 消耗掉这个无效的格式符
                     break;
                 }
-                // string(1,c)为什么要这么写？ 通常是为了把一个原本是单引号的字符（char），转换成双引号的字符串（string），以便和其他字符串进行拼接。
-                // 查表生产，找到了，加入列表
-                auto produce_func = s_ProduceFuncMap1[std::string(1,c)];
-                pattern_items_.push_back(produce_func());
+                // 找到了，加入列表
+                pattern_items_.push_back(std::move(*item));
                 state = ParseState::NORMAL; // 活干完了，切回普通模式
                 i++; // 消耗掉这个格式符
                 break;
@@ -134,8 +96,14 @@ void LogFormatter::startParse_()
                 
                 // 此时 pattern_[i] 是 '}'
                 // 查表生产
-                auto produce_func = s_ProduceFuncMap2[std::string(1, escape_c)];
-                pattern_items_.push_back(produce_func(sub_pattern));
+                auto item = MakeStatusPatternItem(escape_c, std::move(sub_pattern));
+                if(not item)
+                {
+                    std::cerr << "[ERROR] LogFormatter parse error: '%" << escape_c << "' takes no sub pattern" << std::endl;
+                    error_ = true;
+                    return;
+                }
+                pattern_items_.push_back(std::move(*item));
                 state = ParseState::NORMAL;
                 i++;    // 消耗掉 '}'
                 break;
@@ -148,34 +116,33 @@ void LogFormatter::startParse_()
 
     if(not normal_str.empty())
     {
-        auto produce_func = s_ProduceFuncMap2["str"];
-        pattern_items_.push_back(produce_func(std::move(normal_str)));
+        pattern_items_.emplace_back(std::in_place_type<StringFormatItem>, std::move(normal_str));
     }
 
 }
 
-auto LogFormatter::format(std::ostream& os, const LogEvent& event) const -> size_t {
-    size_t total_size = 0;
-    std::ranges::for_each(pattern_items_,[&os, &event, &total_size](const Sptr<PatternItemFacade> item) -> void 
-    // item->format(...) 是多态调用！
-    // 不同的 item 会把自己负责的内容写到 os 里，并返回写入的长度。
+auto LogFormatter::format(LogBuffer& buf, const LogEvent& event) const -> size_t {
+    auto start = buf.size();
+    // 每个 item 把自己负责的内容追加到 buf 里，写入长度直接由 size() 的差值得到。
+    // std::visit 按 variant 下标直接跳到对应 Item 的 format，没有虚函数调用
+    for(const auto& item : pattern_items_)
     {
-        // 如果 item 是日期项，它就往 os 写入 "2023-10-27"。
-        // 如果 item 是消息项，它就往 os 写入 "User login success"。
-        // 这就体现了 多态 的威力：不管你是什么项，我统一调 format 接口。
-        total_size += item->format(os, event);
-    });
+        std::visit([&buf, &event](const auto& impl){ impl.format(buf, event); }, item);
+    }
+    return buf.size() - start;
+}
+
+auto LogFormatter::format(std::ostream& os, const LogEvent& event) const -> size_t {
+    thread_local LogBuffer t_buffer;
+    t_buffer.clear();
+    auto total_size = format(t_buffer, event);
+    os.write(t_buffer.data(), static_cast<std::streamsize>(total_size));
     return total_size;
 }
 
 auto LogFormatter::format(const LogEvent& event) const -> std::string 
 {
-    auto ss = std::ostringstream{};
-    // std::ranges::for_each(pattern_items_,[&ss, &event](const Sptr<PatternItemFacade> item) -> void 
-    // 使用auto 避免Sptr类型报错
-    std::ranges::for_each(pattern_items_,[&ss, &event](const auto& item)
-    {
-        item->format(ss, event);
-    });
-    return ss.str();
-}
\ No newline at end of file
+    auto buf = LogBuffer{};
+    format(buf, event);
+    return std::string{buf.view()};
+}
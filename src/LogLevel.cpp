@@ -21,8 +21,11 @@ auto LevelToString(LogLevel level) -> std::string_view
         XX(LogLevel::INFO, INFO)
         XX(LogLevel::DEBUG, DEBUG)
         XX(LogLevel::ALL, ALL)
+        XX(LogLevel::UNKNOW, UNKNOW)
 #undef XX
     }
+    // 不在枚举里的值(比如从外部数据强转来的)
+    return "UNKNOW";
 }
 
 auto StringToLevel(std::string_view str) -> LogLevel
@@ -58,22 +61,3 @@ auto StringToLevel(std::string_view str) -> LogLevel
         return LogLevel::ALL;
     }
 }
-
-auto operator<=(LogLevel lhs, LogLevel rhs) -> bool{
-    return static_cast<std::underlying_type_t<LogLevel>>(lhs) <= static_cast<std::underlying_type_t<LogLevel>>(rhs);
-}
-
-auto operator>(LogLevel lhs, LogLevel rhs) -> bool{
-    return not(lhs<=rhs);
-}
-
-auto operator==(LogLevel one, LogLevel two) -> bool{
-    return static_cast<std::underlying_type_t<LogLevel>>(one) == static_cast<std::underlying_type_t<LogLevel>>(two);
-}
-auto operator>=(LogLevel lhs, LogLevel rhs) -> bool{
-    return lhs > rhs or lhs == rhs;
-}
-
-auto operator<(LogLevel lhs, LogLevel rhs) -> bool{
-    return not(lhs >= rhs);
-}
\ No newline at end of file
@@ -5,23 +5,79 @@
 #include "logger/LoggerAppender.h"
 #include "logger/LogManager.h"
 
-LoggerManager::LoggerManager() : root_{new Logger("root")}, loggers_{{"root", root_}} {
+LoggerManager::LoggerManager() : root_{new Logger("root")} {
     root_->addAppender(std::make_shared<AppenderProxy<StdoutAppender>>());
+    tables_.push_back(std::make_unique<Table>(c_initial_capacity));
+    table_.store(tables_.back().get(), std::memory_order_release);
+
+    auto _ = std::lock_guard<std::mutex>{mtx_};
+    Insert_(*tables_.back(), entries_.emplace_back(Entry{UtilT::cHashString("root"), "root", root_}));
     init_();
 }
 
 void LoggerManager::init_(){}
 
-auto LoggerManager::getLogger(std::string_view logger_name) -> Sptr<Logger>{
+auto LoggerManager::Find_(const Table& table, std::string_view name, UtilT::Hash_t hash) -> const Entry*{
+    // 装载率不超过一半，一定能遇到空槽
+    for(auto i = hash & table.mask_;; i = (i + 1) & table.mask_){
+        const auto* entry = table.slots_[i].load(std::memory_order_acquire);
+        if(entry == nullptr){
+            return nullptr;
+        }
+        if(entry->hash_ == hash and entry->name_ == name){
+            return entry;
+        }
+    }
+}
+
+auto LoggerManager::Insert_(Table& table, const Entry& entry) -> void{
+    auto i = entry.hash_ & table.mask_;
+    while(table.slots_[i].load(std::memory_order_relaxed) != nullptr){
+        i = (i + 1) & table.mask_;
+    }
+    // release：读到这个指针的线程一定能看到构造好的条目
+    table.slots_[i].store(&entry, std::memory_order_release);
+}
+
+auto LoggerManager::getLogger(LoggerName logger_name) -> Sptr<Logger>{
+    if(const auto* entry = Find_(*table_.load(std::memory_order_acquire), logger_name.view(), logger_name.hash())){
+        return entry->logger_;
+    }
 
     auto _ = std::lock_guard<std::mutex>{mtx_};
+    return getOrCreate_(logger_name.view(), logger_name.hash()).logger_;
+}
 
-    if(auto it = loggers_.find(std::string(logger_name)); it != loggers_.end())
-        return it->second;
+auto LoggerManager::getOrCreate_(std::string_view name, UtilT::Hash_t hash) -> const Entry&{
+    auto* table = table_.load(std::memory_order_relaxed);
+    if(const auto* entry = Find_(*table, name, hash)){
+        return *entry;
+    }
 
-    auto logger = std::make_shared<Logger>(std::string{logger_name});
+    // 先建好上级，保证父日志器总是先于子日志器登记
+    auto parent = root_;
+    if(auto dot = name.rfind('.'); dot != std::string_view::npos){
+        auto parent_name = name.substr(0, dot);
+        parent = getOrCreate_(parent_name, UtilT::cHashString(parent_name)).logger_;
+        // 创建上级时可能已经扩容换了表，后面的装载率检查和插入都要用新表
+        table = table_.load(std::memory_order_relaxed);
+    }
 
-    loggers_.emplace(logger_name, logger);
+    auto logger = std::make_shared<Logger>(std::string{name});
+    logger->setParent(std::move(parent));
+    const auto& entry = entries_.emplace_back(Entry{hash, std::string{name}, std::move(logger)});
 
-    return logger;
+    if((entries_.size() * 2) > table->slots_.size()){
+        // 新表填好之后再发布，读者要么看到旧表，要么看到完整的新表
+        auto grown = std::make_unique<Table>(table->slots_.size() * 2);
+        for(const auto& existing : entries_){
+            Insert_(*grown, existing);
+        }
+        table_.store(grown.get(), std::memory_order_release);
+        tables_.push_back(std::move(grown));
+    }
+    else{
+        Insert_(*table, entry);
+    }
+    return entry;
 }
@@ -0,0 +1,111 @@
+#include "logger/LogName.h"
+#include "common/util.hpp"
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+constexpr size_t c_max_chunks = LogNameRegistry::c_k_max_names / LogNameRegistry::c_k_chunk_names;
+
+using Chunk = std::array<std::atomic<const std::string*>, LogNameRegistry::c_k_chunk_names>;
+
+struct NameStorage{
+    std::mutex mtx_;
+    std::deque<std::string> names_;                          // deque 尾部追加不会移动已有元素
+    std::unordered_map<std::string_view, NameId> index_;     // key 指向 names_ 里的字符串
+    std::deque<std::unique_ptr<Chunk>> owned_;               // 句柄表的块，程序结束前不释放
+    std::array<std::atomic<Chunk*>, c_max_chunks> chunks_{}; // 读者无锁查找用的块指针
+    std::atomic<uint64_t> overflow_ {0};
+
+    NameStorage()
+    {
+        names_.emplace_back();
+        index_.emplace(names_.back(), LogNameRegistry::c_empty_id);
+        publish(LogNameRegistry::c_empty_id, names_.back());
+    }
+
+    // 持有 mtx_ 时调用：块先发布，再发布块里的字符串指针
+    auto publish(NameId id, const std::string& name) -> void
+    {
+        auto& slot = chunks_[id / LogNameRegistry::c_k_chunk_names];
+        auto* chunk = slot.load(std::memory_order_relaxed);
+        if(chunk == nullptr)
+        {
+            chunk = owned_.emplace_back(std::make_unique<Chunk>()).get();
+            slot.store(chunk, std::memory_order_release);
+        }
+        (*chunk)[id % LogNameRegistry::c_k_chunk_names].store(&name, std::memory_order_release);
+    }
+};
+
+auto Storage() -> NameStorage&
+{
+    static auto s_storage = NameStorage{};
+    return s_storage;
+}
+
+// 线程局部的直接映射缓存，命中时不加锁；初始全部指向 0 号空字符串，天然正确
+struct CacheEntry{
+    std::string_view name_;
+    NameId id_ = LogNameRegistry::c_empty_id;
+};
+
+constexpr size_t c_cache_size = 16;
+thread_local std::array<CacheEntry, c_cache_size> t_cache{};
+
+}   // namespace
+
+auto LogNameRegistry::Intern(std::string_view name) -> NameId
+{
+    auto& entry = t_cache[UtilT::cHashString(name) & (c_cache_size - 1)];
+    if(entry.name_ == name)
+    {
+        return entry.id_;
+    }
+
+    auto& storage = Storage();
+    auto _ = std::lock_guard<std::mutex>{storage.mtx_};
+    if(auto it = storage.index_.find(name); it != storage.index_.end())
+    {
+        entry = CacheEntry{it->first, it->second};
+        return it->second;
+    }
+    if(storage.names_.size() >= c_k_max_names)
+    {
+        storage.overflow_.fetch_add(1, std::memory_order_relaxed);
+        return c_empty_id;
+    }
+
+    auto id = static_cast<NameId>(storage.names_.size());
+    const auto& stored = storage.names_.emplace_back(name);
+    storage.index_.emplace(stored, id);
+    storage.publish(id, stored);
+    entry = CacheEntry{stored, id};
+    return id;
+}
+
+auto LogNameRegistry::Lookup(NameId id) -> std::string_view
+{
+    if(id >= c_k_max_names)
+    {
+        return {};
+    }
+    const auto* chunk = Storage().chunks_[id / c_k_chunk_names].load(std::memory_order_acquire);
+    if(chunk == nullptr)
+    {
+        return {};
+    }
+    const auto* name = (*chunk)[id % c_k_chunk_names].load(std::memory_order_acquire);
+    return name != nullptr ? std::string_view{*name} : std::string_view{};
+}
+
+auto LogNameRegistry::OverflowCount() -> uint64_t
+{
+    return Storage().overflow_.load(std::memory_order_relaxed);
+}
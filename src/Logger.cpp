@@ -1,37 +1,239 @@
 #include "logger/Logger.h"
 #include "logger/LoggerAppender.h"
-#include
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+/*========================快照的纪元式回收==============================*/
+/**
+ * @details - 全局纪元从 1 开始，每换下一份快照加 1；换下来的快照记下换之前的纪元 E
+ *          - 读者最外层进入时把当时的全局纪元写进自己线程的槽位(0 表示不在读)，离开时清 0
+ *          - 槽位里的纪元都大于 E 时，没有读者还可能拿着这份快照，可以释放
+ *          - 读者一侧只有一次 seq_cst 写和几次普通读；槽位登记、扫描都在配置改动一侧
+ */
+namespace {
+
+struct ReaderSlot{
+    ReaderSlot();
+    ~ReaderSlot();
+
+    std::atomic<uint64_t> epoch_ = 0;
+    uint32_t depth_ = 0;        // 只有本线程访问
+};
+
+struct RetiredSnapshot{
+    uint64_t epoch_;
+    Uptr<const std::vector<Sptr<AppenderFacade>>> list_;
+};
+
+struct EpochDomain{
+    std::atomic<uint64_t> epoch_ = 1;
+    std::mutex slots_mutex_;
+    std::vector<ReaderSlot*> slots_;
+    std::vector<RetiredSnapshot> retired_;     // 受 Logger::s_config_mutex_ 保护
+};
+
+// 故意不析构：静态对象析构阶段仍可能有线程退出、注销槽位
+auto Domain() -> EpochDomain& {
+    static auto* s_domain = new EpochDomain;
+    return *s_domain;
+}
+
+ReaderSlot::ReaderSlot(){
+    auto& domain = Domain();
+    auto _ = std::lock_guard<std::mutex> {domain.slots_mutex_};
+    domain.slots_.push_back(this);
+}
+
+ReaderSlot::~ReaderSlot(){
+    auto& domain = Domain();
+    auto _ = std::lock_guard<std::mutex> {domain.slots_mutex_};
+    std::erase(domain.slots_, this);
+}
+
+thread_local ReaderSlot t_reader_slot;
+
+// 正在读的读者里最早的纪元，没有读者时返回 uint64_t 最大值
+auto OldestReaderEpoch() -> uint64_t {
+    auto& domain = Domain();
+    auto oldest = std::numeric_limits<uint64_t>::max();
+    auto _ = std::lock_guard<std::mutex> {domain.slots_mutex_};
+    for(const auto* slot : domain.slots_){
+        if(auto epoch = slot->epoch_.load(std::memory_order_seq_cst); epoch != 0){
+            oldest = std::min(oldest, epoch);
+        }
+    }
+    return oldest;
+}
+
+} // namespace
+
+// 读全局纪元、写槽位、之后读快照指针都是 seq_cst：配置一侧先换指针再推进纪元，
+// 扫描时看不到这次登记的话，这次读一定能读到新指针；x86 上只有写槽位是一条 xchg
+Logger::SnapshotReader_::SnapshotReader_(){
+    if(t_reader_slot.depth_++ == 0){
+        t_reader_slot.epoch_.store(Domain().epoch_.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    }
+}
+
+Logger::SnapshotReader_::~SnapshotReader_(){
+    if(--t_reader_slot.depth_ == 0){
+        t_reader_slot.epoch_.store(0, std::memory_order_release);
+    }
+}
 
 /*============================Logger==================================*/
 // Logger::Logger(std::string name) : name_(name){}
 
 // Logger::setLevel(LogLevel::Level level) {level_ = level;}
 
-void Logger::addAppender(std::shared_ptr<Appender> appender){
-    appenders_.push_back(appender);
+Logger::~Logger(){
+    auto _ = std::lock_guard<std::mutex> {s_config_mutex_};
+    if(parent_){
+        std::erase(parent_->children_, this);
+    }
 }
 
-void Logger::delAppender(std::shared_ptr<Appender> appender){
-    for(auto it = appenders_.begin(); it != appenders_.end(); ++it){
-        if(*it == appender){
-            appenders_.erase(it);
-            break;
-        }
+void Logger::publish_(AppenderList list){
+    auto next = std::make_unique<const AppenderList>(std::move(list));
+    // 读到新指针的线程一定能看到完整构造好的快照
+    appenders_.store(next.get(), std::memory_order_seq_cst);
+    auto previous = std::exchange(current_snapshot_, std::move(next));
+    appenders_generation_.fetch_add(1, std::memory_order_release);
+    // 构造时没有旧快照，也没有持有 s_config_mutex_，不碰回收列表
+    if(not previous){
+        return;
+    }
+    auto& domain = Domain();
+    domain.retired_.push_back({domain.epoch_.fetch_add(1, std::memory_order_seq_cst), std::move(previous)});
+    auto oldest = OldestReaderEpoch();
+    std::erase_if(domain.retired_, [oldest](const RetiredSnapshot& retired){ return retired.epoch_ < oldest; });
+}
+
+void Logger::refresh_(){
+    level_.store(own_level_.value_or(parent_ ? parent_->getLogLevel() : LogLevel::ALL), std::memory_order_relaxed);
+
+    auto list = own_appenders_;
+    if(parent_){
+        const auto& inherited = *parent_->current_snapshot_;
+        list.insert(list.end(), inherited.begin(), inherited.end());
+    }
+    // 只改级别时 appender 不变，不必再留一份快照
+    if(list != *current_snapshot_){
+        publish_(std::move(list));
+    }
+
+    for(auto* child : children_){
+        child->refresh_();
+    }
+}
+
+void Logger::setLogLevel(LogLevel level){
+    auto _ = std::lock_guard<std::mutex> {s_config_mutex_};
+    own_level_ = level;
+    refresh_();
+}
+
+void Logger::resetLogLevel(){
+    auto _ = std::lock_guard<std::mutex> {s_config_mutex_};
+    own_level_.reset();
+    refresh_();
+}
+
+void Logger::addAppender(std::shared_ptr<AppenderFacade> appender){
+    auto _ = std::lock_guard<std::mutex> {s_config_mutex_};
+    own_appenders_.push_back(std::move(appender));
+    refresh_();
+}
+
+void Logger::delAppender(std::shared_ptr<AppenderFacade> appender){
+    auto _ = std::lock_guard<std::mutex> {s_config_mutex_};
+    if(auto it = std::ranges::find(own_appenders_, appender); it != own_appenders_.end()){
+        own_appenders_.erase(it);
+        refresh_();
     }
 }
 
 void Logger::clearAppender(){
-    appenders_.clear();
+    auto _ = std::lock_guard<std::mutex> {s_config_mutex_};
+    own_appenders_.clear();
+    refresh_();
 }
 
-// 这个函数是对外暴露的接口，用户调用这个函数来输出日志事件，它会根据日志级别判断是否需要输出，并将日志事件传递给所有的Appender进行处理
-void Logger::log(const LogEvent& event) const {
-    if(event.getLevel() >= level_){
-        for(auto appender : appenders_){
-            appender->append(event);
+void Logger::setParent(Sptr<Logger> parent){
+    auto _ = std::lock_guard<std::mutex> {s_config_mutex_};
+    for(auto* ancestor = parent.get(); ancestor != nullptr; ancestor = ancestor->parent_.get()){
+        if(ancestor == this){
+            throw std::invalid_argument{"日志器层级不能成环: " + name_};
         }
     }
+    if(parent_){
+        std::erase(parent_->children_, this);
+    }
+    parent_ = std::move(parent);
+    if(parent_){
+        parent_->children_.push_back(this);
+    }
+    refresh_();
 }
 
+auto Logger::getParent() const -> Sptr<Logger>{
+    auto _ = std::lock_guard<std::mutex> {s_config_mutex_};
+    return parent_;
+}
 
+// 这个函数是对外暴露的接口，用户调用这个函数来输出日志事件，它会根据日志级别判断是否需要输出，并将日志事件传递给所有的Appender进行处理
+// AsyncLogger 的后台线程也走这里，延迟格式化的事件在这里才真正调用 std::format
+void Logger::log(const LogEvent& event) const {
+    if(not isLevelEnable(event.getLevel())){
+        return;
+    }
+    auto reader = SnapshotReader_{};
+    if(not event.isDeferred()){
+        for(const auto& appender : getAppenderSnapshot_()){
+            appender->log(event);
+        }
+        return;
+    }
+    auto rendered = std::optional<LogEvent>{};
+    for(const auto& appender : getAppenderSnapshot_()){
+        if(appender->wantsDeferred()){
+            appender->log(event);
+            continue;
+        }
+        if(not rendered){
+            rendered.emplace(event.rendered());
+        }
+        appender->log(*rendered);
+    }
+}
 
+void Logger::log(std::span<const LogEvent> events) const {
+    auto level = getLogLevel();
+    auto enabled = std::ranges::all_of(events, [level](const LogEvent& event){ return event.getLevel() >= level; });
+    if(not enabled){
+        for(const auto& event : events){
+            log(event);
+        }
+        return;
+    }
+    auto deferred = std::ranges::any_of(events, &LogEvent::isDeferred);
+    auto rendered = std::vector<LogEvent>{};
+    auto reader = SnapshotReader_{};
+    for(const auto& appender : getAppenderSnapshot_()){
+        if(not deferred or appender->wantsDeferred()){
+            appender->log(events);
+            continue;
+        }
+        // 有 appender 要文本时整批渲染一份，其余 appender 共用
+        if(rendered.empty()){
+            rendered.reserve(events.size());
+            for(const auto& event : events){
+                rendered.push_back(event.rendered());
+            }
+        }
+        appender->log(rendered);
+    }
+}
@@ -3,95 +3,43 @@
 #include <chrono>
 #include <filesystem>
 #include <iostream>
-#include <sys/select.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
 #include <system_error>
 #include <time.h>
+#include <unistd.h>
 /*=====================================LogAppender======================================*/
 
 /*===========================StdoutAppender==================*/
 void StdoutAppender::log(const LogFormatter& fmter, const LogEvent& event){
-    fmter.format(std::cout, event);
+    // 整行格式化好后只写一次，多线程输出时行与行之间也不会交错
+    thread_local LogBuffer t_buffer;
+    t_buffer.clear();
+    fmter.format(t_buffer, event);
+    std::cout.write(t_buffer.data(), static_cast<std::streamsize>(t_buffer.size()));
 }
 
-/*===========================RollingFileAppenderAppender==================*/
-
-RollingFileAppender::RollingFileAppender(std::string filename,
-                                         size_t max_bytes,
-                                         Seconds roll_interval)         
-    : filename_{std::move(filename)}
-    , basename_{std::filesystem::path{filename_}.filename().string()}
-    , max_bytes_{max_bytes_}
-    , roll_interval_{roll_interval} { openFile_(); }
-
-
-RollingFileAppender::~RollingFileAppender(){
-    auto _ = std::lock_guard{mutex_};
-    if(filestream_.is_open())
-    {
-        filestream_.close();
+void StdoutAppender::log(const LogFormatter& fmter, std::span<const LogEvent> events){
+    thread_local LogBuffer t_buffer;
+    t_buffer.clear();
+    for(const auto& event : events){
+        fmter.format(t_buffer, event);
     }
+    std::cout.write(t_buffer.data(), static_cast<std::streamsize>(t_buffer.size()));
 }
 
-auto RollingFileAppender::openFile_() -> void{
-    // 清楚错误标志，准备重新打开文件
-    reopen_error_ = false;
-    // 设置流，在failbit 或 badbit 时抛出异常
-    // failbit: 逻辑错误，格式错误、文件未找到
-    // badbit: 严重错误，如磁盘满、硬件故障、内存不足
-    filestream_.exceptions(std::ofstream::failbit | std::ofstream::badbit);
-
-    try{
-        // 使用 std::ios::app 模式打开文件，追加写入, std::ios::binary 确保以二进制模式写入，避免某些平台上的换行符转换问题
-        filestream_.open(filename_, std::ios::out | std::ios::app | std::ios::binary);
-    } catch (const std::ios_base::failure& e){
-        const auto& ec = e.code();
-        // cerr 是标准错误输出流，一般用于输出错误信息，当你往 cerr 里写东西时，它会强制立刻、马上输出到屏幕。即使程序下一行代码就崩溃了，cerr 输出的报错信息也能保证让你看到。这就是为什么报错要用 cerr。
-        std::cerr << "---文件操作失败---" << std::endl;
-        // e.what() 会输出你在 throw 时写的错误描述信息
-        std::cerr << "错误描述(what()): " << e.what() << std::endl;
-        std::cerr << "错误代码(value): " << ec.value() << std::endl;
-        std::cerr << "错误类别(category): " << ec.category().name() << std::endl;
-        throw std::system_error{ec};
-    }
-    last_open_time_ = Clock::now();
-    // 获取当前文件大小，更新 offset_。tellp() 的作用就是：返回当前光标距离文件开头有多少个字节（Byte）。
-    /* 写入数据
-        filestream_ << "hello"; 
-        问问流：现在写到第几个字节了？
-        如果文件是空的，写了5个字，tellp() 就返回 5
-        offset_ = filestream_.tellp();
-    */
-    offset_ = filestream_.tellp();
-}
-
-void RollingFileAppender::rollFile_(){
-    if(not filestream_.is_open())
-    {
-        // 文件未打开，无法滚动,直接尝试打开新的文件
-        openFile_();
-    }
-    // 1.关闭当前文件
-    filestream_.close();
-
-    // 2.生成带时间戳的新文件名
-    std::string new_filename = getNewLogFileName_();
+/*===========================RollingFileBase==================*/
 
-    // 3. 重命名文件 (旧文件名 -> 新文件名)
-    // 使用 std::rename 进行原子操作
-    int ret = std::rename(filename_.c_str(), new_filename.c_str());
-    if(ret != 0)
-    {
-        // 修正 system_error 调用
-        throw std::system_error(
-            std::error_code(errno, std::system_category()), " 重命名日志文件失败: " + filename_ + "->" + new_filename
-        );
-    }
-    // 4.打开一个新的日志文件
-    return openFile_();
-}
+RollingFileBase::RollingFileBase(std::string filename, size_t max_bytes, Seconds roll_interval)
+    : filename_{std::move(filename)}
+    , basename_{std::filesystem::path{filename_}.filename().string()}
+    , max_bytes_{max_bytes}
+    , roll_interval_{roll_interval} {}
 
 // 判断是否需要滚动日志文件
-auto RollingFileAppender::shouldRoll_() const -> bool
+auto RollingFileBase::shouldRoll_() const -> bool
 {
     // 1.大小检测
     if(offset_ > max_bytes_)
@@ -105,8 +53,7 @@ auto RollingFileAppender::shouldRoll_() const -> bool
     return elpased >= roll_interval_;
 }
 
-auto RollingFileAppender::getNewLogFileName_() const -> std::string{
-
+auto RollingFileBase::getNewLogFileName_() const -> std::string{
     auto p = std::filesystem::path{filename_};
 
     // 1.获取文件名主体(不包含扩展名)和扩展名
@@ -129,6 +76,170 @@ auto RollingFileAppender::getNewLogFileName_() const -> std::string{
     return (p.parent_path() / new_filename).string();
 }
 
+auto RollingFileBase::renameCurrent_() const -> void{
+    // 1.生成带时间戳的新文件名
+    std::string new_filename = getNewLogFileName_();
+
+    // 2. 重命名文件 (旧文件名 -> 新文件名)
+    // 使用 std::rename 进行原子操作
+    int ret = std::rename(filename_.c_str(), new_filename.c_str());
+    if(ret != 0)
+    {
+        // 修正 system_error 调用
+        throw std::system_error(
+            std::error_code(errno, std::system_category()), " 重命名日志文件失败: " + filename_ + "->" + new_filename
+        );
+    }
+}
+
+/*===========================RollingFileAppenderAppender==================*/
+
+RollingFileAppender::RollingFileAppender(std::string filename,
+                                         size_t max_bytes,
+                                         Seconds roll_interval,
+                                         RotationPolicy rotation)
+    : RollingFileBase{std::move(filename), max_bytes, roll_interval}
+    , worker_{filename_, rotation}
+{
+    // 写缓冲块一次分配好，之后反复使用
+    for(auto& chunk : chunks_)
+    {
+        chunk.reserve(c_write_chunk + LogBuffer::c_k_initial_capacity);
+    }
+    openFile_();
+}
+
+
+RollingFileAppender::~RollingFileAppender(){
+    auto _ = std::lock_guard{mutex_};
+    if(fd_ >= 0)
+    {
+        try{
+            writePending_();
+        } catch (const std::system_error& e){
+            // 析构函数里不能再抛出，只能报告
+            std::cerr << "[ERROR] RollingFileAppender: " << e.what() << std::endl;
+        }
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+auto RollingFileAppender::openFile_() -> void{
+    // 清楚错误标志，准备重新打开文件
+    reopen_error_ = false;
+
+    // O_APPEND 追加写入：多个进程同时写同一个文件时，每次 writev 都是原子地追加在末尾
+    fd_ = ::open(filename_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if(fd_ < 0)
+    {
+        auto ec = std::error_code(errno, std::system_category());
+        // cerr 是标准错误输出流，一般用于输出错误信息，当你往 cerr 里写东西时，它会强制立刻、马上输出到屏幕。即使程序下一行代码就崩溃了，cerr 输出的报错信息也能保证让你看到。这就是为什么报错要用 cerr。
+        std::cerr << "---文件操作失败---" << std::endl;
+        std::cerr << "错误描述(message): " << ec.message() << std::endl;
+        std::cerr << "错误代码(value): " << ec.value() << std::endl;
+        std::cerr << "错误类别(category): " << ec.category().name() << std::endl;
+        reopen_error_ = true;
+        throw std::system_error{ec, "打开日志文件失败: " + filename_};
+    }
+    attach_(fd_);
+}
+
+auto RollingFileAppender::attach_(int fd) -> void{
+    fd_ = fd;
+    last_open_time_ = Clock::now();
+    // 获取当前文件大小，更新 offset_，追加写入时新日志从这里开始
+    struct stat file_stat {};
+    offset_ = ::fstat(fd_, &file_stat) == 0 ? static_cast<size_t>(file_stat.st_size) : 0;
+}
+
+auto RollingFileAppender::append_(const LogFormatter& fmter, const LogEvent& event) -> void{
+    // 长度直接由格式化结果得到
+    offset_ += fmter.format(chunks_[chunk_index_], event);
+    if(chunks_[chunk_index_].size() >= c_write_chunk)
+    {
+        // 当前块写满了换下一块，全部写满时提交
+        if(++chunk_index_ == c_write_chunks)
+        {
+            writePending_();
+        }
+    }
+}
+
+auto RollingFileAppender::writePending_() -> void{
+    auto iov = std::array<iovec, c_write_chunks>{};
+    auto count = 0;
+    for(auto& chunk : chunks_)
+    {
+        if(not chunk.empty())
+        {
+            iov[count++] = iovec{const_cast<char*>(chunk.data()), chunk.size()};
+        }
+    }
+
+    auto* cur = iov.data();
+    while(count > 0)
+    {
+        auto written = ::writev(fd_, cur, count);
+        if(written < 0)
+        {
+            if(errno == EINTR)
+            {
+                continue;
+            }
+            throw std::system_error(
+                std::error_code(errno, std::system_category()), " 写入日志文件失败: " + filename_
+            );
+        }
+        // 部分写入：跳过已经写完的块，调整剩下第一块的起点
+        auto left = static_cast<size_t>(written);
+        while(count > 0 and left >= cur->iov_len)
+        {
+            left -= cur->iov_len;
+            ++cur;
+            --count;
+        }
+        if(count > 0)
+        {
+            cur->iov_base = static_cast<char*>(cur->iov_base) + left;
+            cur->iov_len -= left;
+        }
+    }
+
+    for(auto& chunk : chunks_)
+    {
+        chunk.clear();
+    }
+    chunk_index_ = 0;
+}
+
+void RollingFileAppender::rollFile_(){
+    auto timer = ScopedLatency{rotation_ns_};
+    if(fd_ < 0)
+    {
+        // 文件未打开，无法滚动,直接尝试打开新的文件
+        openFile_();
+    }
+    // 1.写完剩下的日志
+    writePending_();
+
+    // 2.换成预先打开的文件(后台还没准备好时 takeNextFd 当场打开)，旧 fd 的关闭和重命名都在后台做
+    auto next_fd = worker_.takeNextFd();
+    if(next_fd >= 0)
+    {
+        auto old_fd = fd_;
+        attach_(next_fd);
+        worker_.submit(old_fd, getNewLogFileName_());
+        return;
+    }
+
+    // 3.打开 .next 失败：关闭当前文件，重命名为带时间戳的文件名，再打开一个新的日志文件
+    ::close(fd_);
+    fd_ = -1;
+    renameCurrent_();
+    return openFile_();
+}
+
 auto RollingFileAppender::log(const LogFormatter& fmter, const LogEvent& event) -> void {
     // 1.加锁，确保线程安全
     auto _ = std::lock_guard{mutex_};
@@ -138,16 +249,13 @@ auto RollingFileAppender::log(const LogFormatter& fmter, const LogEvent& event)
     {
         rollFile_();
     }
-    // 3.格式化并写入日志,
-    auto total_size = fmter.format(filestream_, event);
+    // 3.格式化到写缓冲块(同时更新写入偏移量)，攒够了再一次性写入文件
+    append_(fmter, event);
 
-    // 4.更新写入偏移量
-    offset_ += total_size;
-
-    // 5.处理 Flush 策略
+    // 4.处理 Flush 策略
     flush_count_++;
 
-    // 6. 检查是否需要 Flush
+    // 5. 检查是否需要 Flush
     auto now = Clock::now();
 
     // 检查时间间隔
@@ -158,10 +266,38 @@ auto RollingFileAppender::log(const LogFormatter& fmter, const LogEvent& event)
 
     if(time_to_flush || count_to_flush)
     {
-        // 调用 std::ostream::flush() 将数据从 C++ 缓冲区推送到操作系统/ 
-        filestream_.flush();
+        // 把写缓冲块推送到操作系统
+        writePending_();
         // 重置状态
         last_flush_time_ = now;
         flush_count_ = 0;
     }
-}
\ No newline at end of file
+}
+
+auto RollingFileAppender::log(const LogFormatter& fmter, std::span<const LogEvent> events) -> void {
+    auto _ = std::lock_guard{mutex_};
+
+    // 时间条件整批只查一次，批内只按大小滚动
+    if(shouldRoll_())
+    {
+        rollFile_();
+    }
+    for(const auto& event : events)
+    {
+        if(offset_ > max_bytes_)
+        {
+            rollFile_();
+        }
+        append_(fmter, event);
+    }
+
+    // flush 策略同逐条接口，只是按整批计数：到了时机时把攒下的所有块一次 writev 提交
+    flush_count_ += events.size();
+    auto now = Clock::now();
+    if(now - last_flush_time_ >= c_flush_seconds or flush_count_ >= c_flush_max_appends)
+    {
+        writePending_();
+        last_flush_time_ = now;
+        flush_count_ = 0;
+    }
+}
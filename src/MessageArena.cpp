@@ -0,0 +1,123 @@
+#include "logger/MessageArena.h"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <new>
+
+namespace {
+
+// 每个内存块前面的头部，空闲时 next_ 串成链表
+struct alignas(16) BlockHeader{
+    BlockHeader* next_;
+    uint32_t size_class_;
+    uint32_t capacity_;
+};
+
+constexpr std::array<size_t, 4> c_size_classes = {256, 1024, 4096, 16384};
+constexpr uint32_t c_unpooled = UINT32_MAX;   // 超过最大档位，不进池
+
+/**
+ * @brief 带版本号的无锁栈(Treiber stack)
+ * @details 用户态指针只有低 48 位有效，高 16 位留给版本号防止 ABA；
+ *          池里的块从不归还系统，所以弹出时读取 next_ 不会访问已释放的内存
+ */
+class FreeList{
+public:
+    auto pop() -> BlockHeader*
+    {
+        auto head = head_.load(std::memory_order_acquire);
+        for(;;)
+        {
+            auto* node = unpack_(head);
+            if(node == nullptr)
+            {
+                return nullptr;
+            }
+            auto next = pack_(node->next_, tag_(head) + 1);
+            if(head_.compare_exchange_weak(head, next, std::memory_order_acquire, std::memory_order_acquire))
+            {
+                return node;
+            }
+        }
+    }
+
+    auto push(BlockHeader* node) -> void
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        for(;;)
+        {
+            node->next_ = unpack_(head);
+            if(head_.compare_exchange_weak(head, pack_(node, tag_(head) + 1), std::memory_order_release, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+    }
+
+private:
+    static auto pack_(BlockHeader* node, uint64_t tag) -> uint64_t
+    {
+        return (reinterpret_cast<uint64_t>(node) << 16) | (tag & 0xFFFF);
+    }
+    static auto unpack_(uint64_t packed) -> BlockHeader* { return reinterpret_cast<BlockHeader*>(packed >> 16); }
+    static auto tag_(uint64_t packed) -> uint64_t { return packed & 0xFFFF; }
+
+    std::atomic<uint64_t> head_{0};
+};
+
+static_assert(sizeof(void*) == 8, "FreeList 假设 64 位指针");
+
+std::array<FreeList, c_size_classes.size()> s_free_lists;
+
+auto HeaderOf(const char* block) -> BlockHeader*
+{
+    return reinterpret_cast<BlockHeader*>(const_cast<char*>(block)) - 1;
+}
+
+auto NewBlock(size_t capacity, uint32_t size_class) -> char*
+{
+    auto* header = static_cast<BlockHeader*>(::operator new(sizeof(BlockHeader) + capacity));
+    header->next_ = nullptr;
+    header->size_class_ = size_class;
+    header->capacity_ = static_cast<uint32_t>(capacity);
+    return reinterpret_cast<char*>(header + 1);
+}
+
+}   // namespace
+
+auto MessageArena::Acquire(size_t size) -> char*
+{
+    for(auto i = size_t{0}; i < c_size_classes.size(); ++i)
+    {
+        if(size <= c_size_classes[i])
+        {
+            if(auto* header = s_free_lists[i].pop())
+            {
+                return reinterpret_cast<char*>(header + 1);
+            }
+            return NewBlock(c_size_classes[i], static_cast<uint32_t>(i));
+        }
+    }
+    return NewBlock(size, c_unpooled);
+}
+
+auto MessageArena::Release(char* block) -> void
+{
+    if(block == nullptr)
+    {
+        return;
+    }
+    auto* header = HeaderOf(block);
+    if(header->size_class_ == c_unpooled)
+    {
+        ::operator delete(header);
+        return;
+    }
+    s_free_lists[header->size_class_].push(header);
+}
+
+auto MessageArena::Capacity(const char* block) -> size_t
+{
+    return HeaderOf(block)->capacity_;
+}
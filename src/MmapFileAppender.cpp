@@ -0,0 +1,218 @@
+#include "logger/LoggerAppender.h"
+#include "common/alias.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+/*===========================MmapFileAppender==================*/
+
+MmapFileAppender::MmapFileAppender(std::string filename,
+                                   size_t max_bytes,
+                                   Seconds roll_interval)
+    : RollingFileBase{std::move(filename), max_bytes, roll_interval}
+{
+    openFile_();
+}
+
+MmapFileAppender::~MmapFileAppender(){
+    auto _ = std::lock_guard{mutex_};
+    try{
+        closeFile_();
+    } catch (const std::system_error& e){
+        // 析构函数里不能再抛出，只能报告
+        std::cerr << "[ERROR] MmapFileAppender: " << e.what() << std::endl;
+    }
+}
+
+auto MmapFileAppender::openFile_() -> void{
+    reopen_error_ = false;
+
+    fd_ = ::open(filename_.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if(fd_ < 0)
+    {
+        auto ec = std::error_code(errno, std::system_category());
+        std::cerr << "---文件操作失败---" << std::endl;
+        std::cerr << "错误描述(message): " << ec.message() << std::endl;
+        std::cerr << "错误代码(value): " << ec.value() << std::endl;
+        std::cerr << "错误类别(category): " << ec.category().name() << std::endl;
+        reopen_error_ = true;
+        throw std::system_error{ec, "打开日志文件失败: " + filename_};
+    }
+    last_open_time_ = Clock::now();
+
+    // 新日志接在真实内容后面，而不是上次预分配的末尾
+    struct stat file_stat {};
+    auto file_size = ::fstat(fd_, &file_stat) == 0 ? static_cast<size_t>(file_stat.st_size) : 0;
+    offset_ = findLogicalEnd_(file_size);
+    mapChunk_();
+}
+
+auto MmapFileAppender::findLogicalEnd_(size_t file_size) const -> size_t{
+    // 从文件末尾向前按块读，找到最后一个非 '\0' 字节；正常关闭的文件第一块就能找到
+    char block[4096];
+    auto end = file_size;
+    while(end > 0)
+    {
+        auto len = std::min(end, sizeof(block));
+        auto begin = end - len;
+        if(::pread(fd_, block, len, static_cast<off_t>(begin)) != static_cast<ssize_t>(len))
+        {
+            // 读失败时保守处理：认为全部都是日志
+            return end;
+        }
+        for(auto i = len; i > 0; --i)
+        {
+            if(block[i - 1] != '\0')
+            {
+                return begin + i;
+            }
+        }
+        end = begin;
+    }
+    return 0;
+}
+
+auto MmapFileAppender::mapChunk_() -> void{
+    static const auto s_page_size = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+
+    // 新窗口先算在局部变量里，映射成功后才提交；中途抛异常时 map_ 保持为空，下次写入重新映射
+    auto map_offset = offset_ / s_page_size * s_page_size;
+    auto map_size = c_map_chunk;
+
+    // 预分配磁盘空间，写映射区时不会因为空间不足收到 SIGBUS；
+    // 文件系统不支持 fallocate 时退回 ftruncate(只扩展长度)
+    if(::fallocate(fd_, 0, static_cast<off_t>(map_offset), static_cast<off_t>(map_size)) != 0)
+    {
+        if(errno != EOPNOTSUPP and errno != ENOSYS)
+        {
+            throw std::system_error(
+                std::error_code(errno, std::system_category()), " 预分配日志文件失败: " + filename_
+            );
+        }
+        struct stat file_stat {};
+        if(::fstat(fd_, &file_stat) == 0 and static_cast<size_t>(file_stat.st_size) < map_offset + map_size)
+        {
+            if(::ftruncate(fd_, static_cast<off_t>(map_offset + map_size)) != 0)
+            {
+                throw std::system_error(
+                    std::error_code(errno, std::system_category()), " 扩展日志文件失败: " + filename_
+                );
+            }
+        }
+    }
+
+    auto* addr = ::mmap(nullptr, map_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, static_cast<off_t>(map_offset));
+    if(addr == MAP_FAILED)
+    {
+        throw std::system_error(
+            std::error_code(errno, std::system_category()), " 映射日志文件失败: " + filename_
+        );
+    }
+    map_ = static_cast<char*>(addr);
+    map_offset_ = map_offset;
+    map_size_ = map_size;
+}
+
+auto MmapFileAppender::copyToMap_() -> void{
+    const auto* data = buffer_.data();
+    auto left = buffer_.size();
+    while(left > 0)
+    {
+        // 上次映射失败时 map_ 为空，这里重新映射
+        auto pos = offset_ - map_offset_;
+        if(map_ == nullptr or pos >= map_size_)
+        {
+            // 当前映射区写满了，换下一段；脏页留在页缓存里由内核回写
+            if(map_ != nullptr)
+            {
+                ::munmap(map_, map_size_);
+                map_ = nullptr;
+            }
+            try {
+                mapChunk_();
+            } catch (const std::system_error&){
+                // 已经拷进去的前半段不能再写一遍，剩下的随异常丢弃
+                buffer_.clear();
+                throw;
+            }
+            continue;
+        }
+        auto n = std::min(left, map_size_ - pos);
+        std::memcpy(map_ + pos, data, n);
+        data += n;
+        left -= n;
+        offset_ += n;
+    }
+    buffer_.clear();
+}
+
+auto MmapFileAppender::closeFile_() -> void{
+    if(map_ != nullptr)
+    {
+        ::munmap(map_, map_size_);
+        map_ = nullptr;
+    }
+    if(fd_ >= 0)
+    {
+        // 去掉预分配但没有用到的部分
+        auto ret = ::ftruncate(fd_, static_cast<off_t>(offset_));
+        auto err = errno;
+        ::close(fd_);
+        fd_ = -1;
+        if(ret != 0)
+        {
+            throw std::system_error(
+                std::error_code(err, std::system_category()), " 截断日志文件失败: " + filename_
+            );
+        }
+    }
+}
+
+auto MmapFileAppender::rollFile_() -> void{
+    auto timer = ScopedLatency{rotation_ns_};
+    // 1.截断并关闭当前文件
+    closeFile_();
+
+    // 2.重命名为带时间戳的文件名
+    renameCurrent_();
+
+    // 3.打开一个新的日志文件
+    openFile_();
+}
+
+auto MmapFileAppender::log(const LogFormatter& fmter, const LogEvent& event) -> void{
+    auto _ = std::lock_guard{mutex_};
+    if(shouldRoll_())
+    {
+        rollFile_();
+    }
+    fmter.format(buffer_, event);
+    copyToMap_();
+}
+
+auto MmapFileAppender::log(const LogFormatter& fmter, std::span<const LogEvent> events) -> void{
+    auto _ = std::lock_guard{mutex_};
+
+    // 时间条件整批只查一次，批内只按大小滚动
+    if(shouldRoll_())
+    {
+        rollFile_();
+    }
+    for(const auto& event : events)
+    {
+        fmter.format(buffer_, event);
+        if(offset_ + buffer_.size() > max_bytes_)
+        {
+            copyToMap_();
+            rollFile_();
+        }
+    }
+    copyToMap_();
+}
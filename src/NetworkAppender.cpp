@@ -0,0 +1,683 @@
+#include "logger/NetworkAppender.h"
+#include "logger/LogFormatter.h"
+#include "net/EventLoop.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <netdb.h>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+constexpr size_t c_max_datagram = 65'507;       // IPv4 UDP 单个数据报的负载上限
+constexpr size_t c_datagram_headroom = 4_kb;    // 二进制 UDP 在块还差这么多字节到上限时就封块，给最后一条事件留余量
+constexpr size_t c_max_iov = 64;                // 一次 sendmsg 最多聚集的批数
+constexpr size_t c_max_spare = 16;              // 发完的缓冲最多留这么多块复用
+constexpr size_t c_read_chunk = 4_kb;
+
+// 解析好的收集端地址
+struct Endpoint{
+    int family = AF_UNSPEC;
+    int type = SOCK_STREAM;
+    sockaddr_storage addr {};
+    socklen_t addr_len = 0;
+};
+
+auto ParseEndpoint(const std::string& address) -> Endpoint
+{
+    auto scheme_end = address.find("://");
+    if(scheme_end == std::string::npos)
+    {
+        throw std::invalid_argument{"日志收集地址缺少协议: " + address};
+    }
+    auto scheme = std::string_view{address}.substr(0, scheme_end);
+    auto rest = address.substr(scheme_end + 3);
+
+    auto endpoint = Endpoint{};
+    if(scheme == "unix")
+    {
+        auto un = sockaddr_un{};
+        if(rest.empty() or rest.size() >= sizeof(un.sun_path))
+        {
+            throw std::invalid_argument{"Unix socket 路径为空或过长: " + address};
+        }
+        un.sun_family = AF_UNIX;
+        std::memcpy(un.sun_path, rest.data(), rest.size());
+        std::memcpy(&endpoint.addr, &un, sizeof(un));
+        endpoint.family = AF_UNIX;
+        endpoint.addr_len = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + rest.size() + 1);
+        return endpoint;
+    }
+    if(scheme != "tcp" and scheme != "udp")
+    {
+        throw std::invalid_argument{"不支持的日志收集地址: " + address};
+    }
+    endpoint.type = scheme == "tcp" ? SOCK_STREAM : SOCK_DGRAM;
+
+    // host:port，IPv6 写成 [::1]:port
+    auto colon = rest.rfind(':');
+    if(colon == std::string::npos or colon + 1 == rest.size())
+    {
+        throw std::invalid_argument{"日志收集地址缺少端口: " + address};
+    }
+    auto host = rest.substr(0, colon);
+    auto port = rest.substr(colon + 1);
+    if(host.size() >= 2 and host.front() == '[' and host.back() == ']')
+    {
+        host = host.substr(1, host.size() - 2);
+    }
+
+    auto hints = addrinfo{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = endpoint.type;
+    hints.ai_flags = AI_NUMERICSERV;
+    addrinfo* result = nullptr;
+    if(auto rc = ::getaddrinfo(host.c_str(), port.c_str(), &hints, &result); rc != 0 or result == nullptr)
+    {
+        throw std::invalid_argument{"解析日志收集地址失败: " + address + ": " + ::gai_strerror(rc)};
+    }
+    endpoint.family = result->ai_family;
+    endpoint.addr_len = result->ai_addrlen;
+    std::memcpy(&endpoint.addr, result->ai_addr, result->ai_addrlen);
+    ::freeaddrinfo(result);
+    return endpoint;
+}
+
+} // namespace
+
+/*===========================NetworkAppender::Connection==================*/
+
+/**
+ * @brief 后台 EventLoop 线程：维护到收集端的连接，把提交上来的批写出去
+ * @details 除了 submit() 和统计，其余成员只在循环线程里访问；
+ *          Channel 回调通过 bindTo 绑定到这里的 handle*_，它们只由 EventLoop 调用
+ */
+class NetworkAppender::Connection{
+public:
+    Connection(const NetworkAppenderOptions& options, const Endpoint& endpoint)
+        : endpoint_{endpoint}
+        , binary_{options.payload == NetworkPayload::Binary}
+        , max_in_flight_bytes_{options.max_in_flight_bytes}
+        , reconnect_min_{std::max(options.reconnect_min, std::chrono::milliseconds{1})}
+        , reconnect_max_{std::max(options.reconnect_max, reconnect_min_)}
+        , close_timeout_{options.close_timeout}
+        , backoff_{reconnect_min_}
+    {
+        iov_.reserve(c_max_iov);
+        loop_.queueInLoop([this]{ connect_(); });
+        thread_ = std::thread{[this]{ loop_.loop(); }};
+    }
+
+    Connection(const Connection&) = delete;
+    Connection(Connection&&) = delete;
+    auto operator=(const Connection&) -> Connection& = delete;
+    auto operator=(Connection&&) -> Connection& = delete;
+
+    ~Connection()
+    {
+        // 把积压的发完再退出，最多等 close_timeout_
+        loop_.runInLoop([this]{
+            closing_ = true;
+            loop_.runAfter(close_timeout_, [this]{ loop_.quit(); });
+            drain_();
+        });
+        thread_.join();
+
+        // 循环已经退出，剩下的由当前线程收尾
+        closeSocket_();
+        auto _ = std::lock_guard{mutex_};
+        for(auto* queue : {&sending_, &incoming_})
+        {
+            for(auto& message : *queue)
+            {
+                if(not message.prologue)
+                {
+                    dropped_events_.fetch_add(message.events, std::memory_order_relaxed);
+                }
+            }
+            queue->clear();
+        }
+    }
+
+    // 交出一批(batch 换成一块空缓冲)；超过 in-flight 上限时整批丢弃
+    auto submit(LogBuffer& batch, size_t events) -> void
+    {
+        auto size = batch.size();
+        auto wake = false;
+        {
+            auto _ = std::lock_guard{mutex_};
+            if(in_flight_bytes_.load(std::memory_order_relaxed) + size > max_in_flight_bytes_)
+            {
+                dropped_events_.fetch_add(events, std::memory_order_relaxed);
+                batch.clear();
+                return;
+            }
+            in_flight_bytes_.fetch_add(size, std::memory_order_relaxed);
+
+            auto bytes = LogBuffer{};
+            if(not spare_.empty())
+            {
+                bytes = std::move(spare_.back());
+                spare_.pop_back();
+            }
+            std::swap(bytes, batch);
+            incoming_.push_back(Message{std::move(bytes), events, false});
+            // 循环线程还没处理上一次唤醒时不用再投递
+            wake = not std::exchange(wake_pending_, true);
+        }
+        if(wake)
+        {
+            loop_.queueInLoop([this]{ drain_(); });
+        }
+    }
+
+    [[nodiscard]] auto getStats() const -> NetworkAppenderStats
+    {
+        return NetworkAppenderStats{
+            .sent_events = sent_events_.load(std::memory_order_relaxed),
+            .sent_bytes = sent_bytes_.load(std::memory_order_relaxed),
+            .send_calls = send_calls_.load(std::memory_order_relaxed),
+            .dropped_events = dropped_events_.load(std::memory_order_relaxed),
+            .connects = connects_.load(std::memory_order_relaxed),
+            .in_flight_bytes = in_flight_bytes_.load(std::memory_order_relaxed),
+        };
+    }
+
+    // 以下由 Channel 回调
+    auto handleRead_(Timestamp) -> void
+    {
+        // 收集端不该回数据，读出来丢掉；读到 EOF 说明对端关闭了连接
+        char buf[c_read_chunk];
+        for(;;)
+        {
+            auto n = ::recv(fd_, buf, sizeof(buf), MSG_DONTWAIT);
+            if(n > 0)
+            {
+                continue;
+            }
+            if(n < 0 and errno == EINTR)
+            {
+                continue;
+            }
+            if(n < 0 and (errno == EAGAIN or errno == EWOULDBLOCK))
+            {
+                return;
+            }
+            // UDP 上读到的错误是之前数据报的 ICMP 回报，不影响连接
+            if(endpoint_.type == SOCK_STREAM)
+            {
+                fail_();
+            }
+            return;
+        }
+    }
+
+    auto handleWrite_() -> void
+    {
+        if(state_ == State::Connecting)
+        {
+            auto error = 0;
+            auto len = socklen_t{sizeof(error)};
+            if(::getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &len) < 0 or error != 0)
+            {
+                fail_();
+                return;
+            }
+            onConnected_();
+            return;
+        }
+        flush_();
+    }
+
+    auto handleClose_() -> void
+    {
+        fail_();
+    }
+
+    auto handleError_() -> void
+    {
+        if(endpoint_.type == SOCK_DGRAM and state_ == State::Connected)
+        {
+            // 取走挂着的错误，否则 epoll 会一直报
+            auto error = 0;
+            auto len = socklen_t{sizeof(error)};
+            ::getsockopt(fd_, SOL_SOCKET, SO_ERROR, &error, &len);
+            return;
+        }
+        fail_();
+    }
+
+private:
+    enum class State : uint8_t
+    {
+        Disconnected,
+        Connecting,
+        Connected,
+    };
+
+    struct Message{
+        LogBuffer bytes;
+        size_t events = 0;
+        bool prologue = false;      // 连接建立后补发的文件头，不计入 in-flight
+    };
+
+    auto connect_() -> void
+    {
+        fd_ = ::socket(endpoint_.family, endpoint_.type | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if(fd_ < 0)
+        {
+            scheduleReconnect_();
+            return;
+        }
+        channel_ = std::make_unique<Channel>(loop_, fd_);
+        channel_->bindTo(*this);
+
+        if(::connect(fd_, reinterpret_cast<const sockaddr*>(&endpoint_.addr), endpoint_.addr_len) == 0)
+        {
+            onConnected_();
+        }
+        else if(errno == EINPROGRESS)
+        {
+            // 连接完成时可写
+            state_ = State::Connecting;
+            channel_->enableWriting();
+        }
+        else
+        {
+            fail_();
+        }
+    }
+
+    auto onConnected_() -> void
+    {
+        state_ = State::Connected;
+        backoff_ = reconnect_min_;
+        connects_.fetch_add(1, std::memory_order_relaxed);
+        offset_ = 0;
+        if(binary_ and endpoint_.type == SOCK_STREAM)
+        {
+            auto header = takeSpare_();
+            BinaryLog::PutFileHeader(header);
+            sending_.push_front(Message{std::move(header), 0, true});
+        }
+        channel_->enableReading();
+        flush_();
+    }
+
+    // 关闭当前连接，稍后重连；发了一半的那批从头重发
+    auto fail_() -> void
+    {
+        closeSocket_();
+        state_ = State::Disconnected;
+        offset_ = 0;
+        if(not sending_.empty() and sending_.front().prologue)
+        {
+            recycle_(std::move(sending_.front().bytes));
+            sending_.pop_front();
+        }
+        scheduleReconnect_();
+    }
+
+    auto scheduleReconnect_() -> void
+    {
+        loop_.runAfter(backoff_, [this]{ connect_(); });
+        backoff_ = std::min(backoff_ * 2, reconnect_max_);
+    }
+
+    auto closeSocket_() -> void
+    {
+        if(channel_)
+        {
+            // 可能正在这个 Channel 的回调里，先留着，下次关闭时再释放
+            channel_->remove();
+            retired_channel_ = std::move(channel_);
+        }
+        if(fd_ >= 0)
+        {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    // 把提交上来的批接到发送队列末尾
+    auto drain_() -> void
+    {
+        {
+            auto _ = std::lock_guard{mutex_};
+            wake_pending_ = false;
+            if(sending_.empty())
+            {
+                sending_.swap(incoming_);
+            }
+            else
+            {
+                std::ranges::move(incoming_, std::back_inserter(sending_));
+                incoming_.clear();
+            }
+        }
+        if(state_ == State::Connected)
+        {
+            flush_();
+        }
+        else if(closing_ and sending_.empty())
+        {
+            loop_.quit();
+        }
+    }
+
+    auto flush_() -> void
+    {
+        if(endpoint_.type == SOCK_STREAM)
+        {
+            flushStream_();
+        }
+        else
+        {
+            flushDatagram_();
+        }
+        if(state_ != State::Connected)
+        {
+            return;
+        }
+        if(sending_.empty())
+        {
+            if(channel_->isWriting())
+            {
+                channel_->disableWriting();
+            }
+            if(closing_)
+            {
+                loop_.quit();
+            }
+        }
+    }
+
+    // 排队的多批用一次 sendmsg 聚集写出，直到发完或写不动
+    auto flushStream_() -> void
+    {
+        while(not sending_.empty())
+        {
+            iov_.clear();
+            for(auto& message : sending_)
+            {
+                auto skip = iov_.empty() ? offset_ : 0;
+                iov_.push_back(iovec{const_cast<char*>(message.bytes.data()) + skip, message.bytes.size() - skip});
+                if(iov_.size() == c_max_iov)
+                {
+                    break;
+                }
+            }
+            auto header = msghdr{};
+            header.msg_iov = iov_.data();
+            header.msg_iovlen = iov_.size();
+            // MSG_NOSIGNAL：对端已关闭时返回 EPIPE 而不是发 SIGPIPE
+            auto written = ::sendmsg(fd_, &header, MSG_NOSIGNAL);
+            if(written < 0)
+            {
+                if(errno == EINTR)
+                {
+                    continue;
+                }
+                if(errno == EAGAIN or errno == EWOULDBLOCK)
+                {
+                    waitWritable_();
+                    return;
+                }
+                fail_();
+                return;
+            }
+            send_calls_.fetch_add(1, std::memory_order_relaxed);
+
+            auto left = static_cast<size_t>(written);
+            while(left > 0)
+            {
+                auto remaining = sending_.front().bytes.size() - offset_;
+                if(left < remaining)
+                {
+                    offset_ += left;
+                    break;
+                }
+                left -= remaining;
+                offset_ = 0;
+                complete_();
+            }
+        }
+    }
+
+    // UDP：每批一个数据报，发送失败的那批直接丢弃
+    auto flushDatagram_() -> void
+    {
+        while(not sending_.empty())
+        {
+            const auto& bytes = sending_.front().bytes;
+            auto written = ::send(fd_, bytes.data(), bytes.size(), MSG_NOSIGNAL);
+            if(written < 0)
+            {
+                if(errno == EINTR)
+                {
+                    continue;
+                }
+                if(errno == EAGAIN or errno == EWOULDBLOCK)
+                {
+                    waitWritable_();
+                    return;
+                }
+                drop_();
+                continue;
+            }
+            send_calls_.fetch_add(1, std::memory_order_relaxed);
+            complete_();
+        }
+    }
+
+    auto waitWritable_() -> void
+    {
+        if(not channel_->isWriting())
+        {
+            channel_->enableWriting();
+        }
+    }
+
+    // 队首那批已经完整写出
+    auto complete_() -> void
+    {
+        auto& message = sending_.front();
+        sent_bytes_.fetch_add(message.bytes.size(), std::memory_order_relaxed);
+        if(not message.prologue)
+        {
+            sent_events_.fetch_add(message.events, std::memory_order_relaxed);
+            in_flight_bytes_.fetch_sub(message.bytes.size(), std::memory_order_relaxed);
+        }
+        recycle_(std::move(message.bytes));
+        sending_.pop_front();
+    }
+
+    auto drop_() -> void
+    {
+        auto& message = sending_.front();
+        dropped_events_.fetch_add(message.events, std::memory_order_relaxed);
+        in_flight_bytes_.fetch_sub(message.bytes.size(), std::memory_order_relaxed);
+        recycle_(std::move(message.bytes));
+        sending_.pop_front();
+    }
+
+    auto recycle_(LogBuffer bytes) -> void
+    {
+        bytes.clear();
+        auto _ = std::lock_guard{mutex_};
+        if(spare_.size() < c_max_spare)
+        {
+            spare_.push_back(std::move(bytes));
+        }
+    }
+
+    auto takeSpare_() -> LogBuffer
+    {
+        auto _ = std::lock_guard{mutex_};
+        if(spare_.empty())
+        {
+            return LogBuffer{};
+        }
+        auto bytes = std::move(spare_.back());
+        spare_.pop_back();
+        return bytes;
+    }
+
+    const Endpoint endpoint_;
+    const bool binary_;
+    const size_t max_in_flight_bytes_;
+    const std::chrono::milliseconds reconnect_min_;
+    const std::chrono::milliseconds reconnect_max_;
+    const std::chrono::milliseconds close_timeout_;
+
+    EventLoop loop_;
+
+    // 只在循环线程里访问
+    int fd_ = -1;
+    Uptr<Channel> channel_;
+    Uptr<Channel> retired_channel_;     // 上一个连接的 Channel
+    State state_ = State::Disconnected;
+    std::deque<Message> sending_;
+    size_t offset_ = 0;                 // 队首那批已经写出的字节数
+    std::chrono::milliseconds backoff_;
+    bool closing_ = false;
+    std::vector<iovec> iov_;
+
+    // 写日志的线程和循环线程之间交接
+    std::mutex mutex_;
+    std::deque<Message> incoming_;
+    std::vector<LogBuffer> spare_;      // 发完的缓冲，submit 时换给写日志的线程
+    bool wake_pending_ = false;
+
+    std::atomic<size_t> in_flight_bytes_ = 0;
+    std::atomic<uint64_t> sent_events_ = 0;
+    std::atomic<uint64_t> sent_bytes_ = 0;
+    std::atomic<uint64_t> send_calls_ = 0;
+    std::atomic<uint64_t> dropped_events_ = 0;
+    std::atomic<uint64_t> connects_ = 0;
+
+    std::thread thread_;
+};
+
+/*===========================NetworkAppender==================*/
+
+NetworkAppender::NetworkAppender(NetworkAppenderOptions options)
+    : options_{std::move(options)}
+{
+    auto endpoint = ParseEndpoint(options_.address);
+    datagram_ = endpoint.type == SOCK_DGRAM;
+    if(datagram_)
+    {
+        options_.max_batch_bytes = std::min(options_.max_batch_bytes, c_max_datagram);
+    }
+    options_.max_batch_bytes = std::max<size_t>(options_.max_batch_bytes, 1_kb);
+
+    // 二进制时每批是文件头(仅 UDP) + 块头 + 块负载，块负载达到这个大小就封块提交
+    block_limit_ = options_.max_batch_bytes - BinaryLog::c_file_header_size - BinaryLog::c_block_header_size;
+    if(datagram_)
+    {
+        block_limit_ -= std::min(block_limit_ / 2, c_datagram_headroom);
+    }
+    batch_.reserve(options_.max_batch_bytes);
+    connection_ = std::make_unique<Connection>(options_, endpoint);
+}
+
+NetworkAppender::~NetworkAppender()
+{
+    {
+        auto _ = std::lock_guard{mutex_};
+        submit_();
+    }
+    connection_.reset();
+}
+
+auto NetworkAppender::append_(const LogFormatter& fmter, const LogEvent& event) -> void
+{
+    if(options_.payload == NetworkPayload::Binary)
+    {
+        encoder_.encode(event);
+        ++batch_events_;
+        if(encoder_.size() >= block_limit_)
+        {
+            submit_();
+        }
+        return;
+    }
+
+    line_.clear();
+    fmter.format(line_, event);
+    if(not batch_.empty() and batch_.size() + line_.size() > options_.max_batch_bytes)
+    {
+        submit_();
+    }
+    batch_.append(line_.view());
+    ++batch_events_;
+}
+
+auto NetworkAppender::submit_() -> void
+{
+    if(options_.payload == NetworkPayload::Binary)
+    {
+        if(encoder_.empty())
+        {
+            return;
+        }
+        // 流式连接的文件头由连接建立时补发，UDP 每个数据报自带
+        if(datagram_)
+        {
+            BinaryLog::PutFileHeader(batch_);
+        }
+        encoder_.sealInto(batch_);
+    }
+    if(batch_.empty())
+    {
+        return;
+    }
+    connection_->submit(batch_, batch_events_);
+    batch_events_ = 0;
+}
+
+void NetworkAppender::log(const LogFormatter& fmter, const LogEvent& event)
+{
+    auto _ = std::lock_guard{mutex_};
+    append_(fmter, event);
+    submit_();
+}
+
+void NetworkAppender::log(const LogFormatter& fmter, std::span<const LogEvent> events)
+{
+    auto _ = std::lock_guard{mutex_};
+    for(const auto& event : events)
+    {
+        append_(fmter, event);
+    }
+    submit_();
+}
+
+auto NetworkAppender::getStats() const -> NetworkAppenderStats
+{
+    return connection_->getStats();
+}
+
+auto NetworkAppender::waitIdle(std::chrono::milliseconds timeout) const -> bool
+{
+    auto deadline = Clock::now() + timeout;
+    while(connection_->getStats().in_flight_bytes > 0)
+    {
+        if(Clock::now() >= deadline)
+        {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    return true;
+}
@@ -1,236 +1,266 @@
-#include "common/alias.h"
-#include "logger/LogEvent.h"
-#include "logger/PatternItemFacade.h"
-#include "logger/PatternItemProxy.hpp"
-
-#include  <cstddef>
-#include <functional>
-#include <sys/types.h>
-#include <string.h>
-#include <chrono>
-#include <format>
-/* ======================================FormatterItem==============================*/
-class FunctionNameFormatItem {
-public:
-    static auto format(std::ostream&os, const LogEvent& event) -> size_t 
-    {
-        std::streampos start = os.tellp();
-        os << event.getLoggerName();
-        return static_cast<size_t>(os.tellp() - start);
-    }
-};
-
-/**
- * @brief 消息format
- */
-
-class MessageFormatItem{
-public:
-    static auto format(std::ostream& os, const LogEvent& event) -> size_t
-    {
-        std::streampos start = os.tellp();
-        os << event.getLoggerName();
-        return static_cast<size_t>(os.tellp() - start);
-    }
-};
+#include "logger/PatternItems.hpp"
+#include "logger/TextKernels.h"
 
-/** @brief 日志级别format */
-class LevelFormatItem{
-public:
-    static auto format(std::ostream& os, const LogEvent& event) -> size_t {
-        std::streampos start = os.tellp();
-        os << LevelToString(event.getLevel());
-        return static_cast<size_t>(os.tellp() - start);
-    }
-};
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <ctime>
+#include <string>
+#include <utility>
 
-/** @brief 耗时format */
-class ElapseFormatItem{
-public:
-    static auto format(std::ostream& os, const LogEvent& event) -> size_t {
-        std::streampos start = os.tellp();
-        os << std::to_string(event.getElapse());
-        return static_cast<size_t>(os.tellp() - start);
-    }
-};
+namespace {
 
-/** @brief 日志器名字format */
-class NameFormatItem{
-public:
-    static auto format(std::ostream& os, const LogEvent& event) -> size_t {
-        std::streampos start = os.tellp();
-        os << event.getLoggerName();
-        return static_cast<size_t>(os.tellp() - start);
-    }
-};
+// 单个缓存项能容纳的日期文本长度，与原来 strftime 的缓冲一致
+constexpr size_t c_k_date_text_size = 128;
+// 每个线程的缓存槽位数，同一线程同时用到的日期格式一般只有一两个
+constexpr size_t c_k_date_cache_slots = 4;
 
-/** @brief 线程ID format */
-class ThreadIdFormatItem{
-public:
-    static auto format(std::ostream& os, const LogEvent& event) -> size_t {
-        // 记录当前写指针的位置，计算写入的长度
-        std::streampos start = os.tellp();
-        // 写入线程ID
-        os << event.getThreadId();
-        // 计算并返回写入的长度
-        return static_cast<size_t>(os.tellp() - start);
-    }
+/** @brief 某个 DateTimeFormatItem 在当前线程、某一秒的渲染结果 */
+struct DateCacheEntry
+{
+    uint64_t id_ = 0;           // 0 表示空槽
+    std::time_t second_ = 0;
+    // 第 i 段渲染结果的结束位置，秒以下的部分插在各段之间
+    std::array<uint16_t, DateTimeFormatItem::c_k_max_sub_second + 1> ends_ {};
+    char text_[c_k_date_text_size];
 };
 
-/** @brief 协程ID format */
-class FiberIdFormatItem{
-public:
-    static auto format(std::ostream&os, const LogEvent& event) -> size_t {
-        std::streampos start = os.tellp();
-        os << event.getFiberId();
-        return static_cast<size_t>(os.tellp() - start);
-    }
-};
+thread_local std::array<DateCacheEntry, c_k_date_cache_slots> t_date_cache;
 
-/** @brief 线程名称 format */
-class ThreadNameFormatItem{
-public:
-    static auto format(std::ostream& os, const LogEvent& event) -> size_t {
-        std::streampos start = os.tellp();
-        os << event.getThreadName();
-        return static_cast<size_t>(os.tellp() - start);
+// 需要转义的字节在 JSON 字符串里怎么写：反斜杠后面的字符，'u' 表示 \u00XX
+constexpr auto c_k_json_escapes = []{
+    auto table = std::array<char, 256>{};
+    for(auto c = 0; c < 0x20; ++c)
+    {
+        table[c] = 'u';
     }
-};
+    table['\b'] = 'b';
+    table['\f'] = 'f';
+    table['\n'] = 'n';
+    table['\r'] = 'r';
+    table['\t'] = 't';
+    table['"'] = '"';
+    table['\\'] = '\\';
+    return table;
+}();
 
-/** @brief 换行符 format */
-class NewLineFormatItem{
-public:
-    static auto format(std::ostream& os, const LogEvent& event) -> size_t {
-        os.put('\n');
-        return 1;
-    }
-};
+constexpr char c_k_hex_digits[] = "0123456789abcdef";
 
-/** @brief 文件名 format */
-class FilenameFormatItem{
-public:
-    static auto format(std::ostream& os, const LogEvent& event) -> size_t {
-        std::streampos start = os.tellp();
-        os << event.getFilename();
-        return static_cast<size_t>(os.tellp() - start);
+// 不需要转义的连续字节整段追加；下一个要转义的字节由 TextKernels 按向量宽度查找
+auto AppendJsonEscaped(LogBuffer& buf, std::string_view text) -> void
+{
+    for(;;)
+    {
+        auto run = TextKernels::FindJsonEscape(text);
+        buf.append(text.data(), run);
+        if(run == text.size()) [[likely]]
+        {
+            return;
+        }
+        auto byte = static_cast<unsigned char>(text[run]);
+        auto escape = c_k_json_escapes[byte];
+        buf.push_back('\\');
+        buf.push_back(escape);
+        if(escape == 'u')
+        {
+            buf.append("00", 2);
+            buf.push_back(c_k_hex_digits[byte >> 4]);
+            buf.push_back(c_k_hex_digits[byte & 0xF]);
+        }
+        text.remove_prefix(run + 1);
     }
-};
+}
 
-/** @brief 行号 format */
-class LineFormatItem{
-public:
-    static auto format(std::ostream& os, const LogEvent& event) -> size_t {
-        std::streampos start = os.tellp();
-        os << event.getLine();
-        return static_cast<size_t>(os.tellp() - start);
+// logfmt 的值：为空或含空格、引号、等号、控制字符时加引号并转义，否则原样输出
+auto AppendLogfmtValue(LogBuffer& buf, std::string_view text) -> void
+{
+    auto needs_quote = text.empty() or std::ranges::any_of(text, [](char c){
+        return static_cast<unsigned char>(c) <= ' ' or c == '"' or c == '=';
+    });
+    if(not needs_quote)
+    {
+        buf.append(text);
+        return;
     }
-};
+    buf.push_back('"');
+    AppendJsonEscaped(buf, text);
+    buf.push_back('"');
+}
 
-/** @brief tab format */
-class TabFormatItem{
-public:
-    static auto format(std::ostream& os, const LogEvent& event) -> size_t {
-        os.put('\t');
-        return 1;
-    }
-};
+template <typename T>
+auto AppendChars(LogBuffer& buf, T value) -> void
+{
+    // 最长的 double 不到 32 个字符；多留一截，CopyBytes 内联后 >32 字节的 memcpy 分支不会被报越界读
+    char digits[64];
+    auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+    buf.append(digits, static_cast<size_t>(end - digits));
+}
 
-/** @brief % format */
-class PercentSignFormatItem{
-public:
-    static auto format(std::ostream& os, const LogEvent& event) -> size_t {
-        os.put('%');
-        return 1;
+// 字段的值：json 为 true 时字符串加引号转义、非有限浮点数输出 null
+auto AppendFieldValue(LogBuffer& buf, const LogEvent::Field& field, bool json) -> void
+{
+    auto append_text = [&buf, json](std::string_view text){
+        if(json)
+        {
+            buf.push_back('"');
+            AppendJsonEscaped(buf, text);
+            buf.push_back('"');
+        }
+        else
+        {
+            AppendLogfmtValue(buf, text);
+        }
+    };
+    auto append_float = [&buf, json](double value, auto exact){
+        if(json and not std::isfinite(value))
+        {
+            buf.append("null", 4);
+            return;
+        }
+        AppendChars(buf, exact);
+    };
+    switch(field.type_)
+    {
+        case ArgType::Bool:    buf.append(field.as<bool>() ? std::string_view{"true"} : std::string_view{"false"}); break;
+        case ArgType::Char:    { auto c = field.as<char>(); append_text(std::string_view{&c, 1}); break; }
+        case ArgType::Int8:    buf.appendInt(field.as<int8_t>()); break;
+        case ArgType::UInt8:   buf.appendInt(field.as<uint8_t>()); break;
+        case ArgType::Int16:   buf.appendInt(field.as<int16_t>()); break;
+        case ArgType::UInt16:  buf.appendInt(field.as<uint16_t>()); break;
+        case ArgType::Int32:   buf.appendInt(field.as<int32_t>()); break;
+        case ArgType::UInt32:  buf.appendInt(field.as<uint32_t>()); break;
+        case ArgType::Int64:   buf.appendInt(field.as<int64_t>()); break;
+        case ArgType::UInt64:  buf.appendInt(field.as<uint64_t>()); break;
+        case ArgType::Float:   { auto v = field.as<float>(); append_float(v, v); break; }
+        case ArgType::Double:  { auto v = field.as<double>(); append_float(v, v); break; }
+        case ArgType::Pointer:
+        {
+            char digits[2 + 2 * sizeof(uintptr_t)] = {'0', 'x'};
+            auto [end, ec] = std::to_chars(digits + 2, digits + sizeof(digits),
+                                           reinterpret_cast<uintptr_t>(field.as<const void*>()), 16);
+            append_text(std::string_view{digits, static_cast<size_t>(end - digits)});
+            break;
+        }
+        case ArgType::Null:    buf.append("null", 4); break;
+        case ArgType::Other:   append_text(field.text()); break;
     }
-};
+}
 
-/*===================================FormatItem with Status======================= */
-/** @brief 时间 format*/
-class DateTimeFormatItem{
-public:
-    explicit DateTimeFormatItem(std::string data_format) : date_format_(move(data_format)){}
+}   // namespace
 
-    auto format(std::ostream& os, const LogEvent& event)-> size_t
+/*===================================DateTimeFormatItem======================= */
+DateTimeFormatItem::DateTimeFormatItem(std::string data_format)
+    : date_format_(std::move(data_format))
+    , cache_id_(s_next_cache_id_.fetch_add(1, std::memory_order_relaxed))
+{
+    // 按 %L / %f 把格式拆成若干段；%% 之类的转义成对跳过
+    auto part_begin = size_t{0};
+    for(auto i = size_t{0}; i + 1 < date_format_.size(); ++i)
     {
-        std::streampos start = os.tellp();
-        auto t = event.getTime();
-        std::tm tm_buf;
-        localtime_r(&t, &tm_buf); // 将时间戳转换为本地时间
-        char buf[128];
-        std::strftime(buf, sizeof(buf), date_format_.c_str(), &tm_buf);
-        os << buf;
-        return static_cast<size_t>(os.tellp() - start);
+        if(date_format_[i] != '%')
+        {
+            continue;
+        }
+        auto c = date_format_[i + 1];
+        if((c == 'L' or c == 'f') and sub_seconds_.size() < c_k_max_sub_second)
+        {
+            parts_.push_back(date_format_.substr(part_begin, i - part_begin));
+            sub_seconds_.push_back(c == 'L' ? SubSecond::Milli : SubSecond::Micro);
+            part_begin = i + 2;
+        }
+        ++i;
     }
+    parts_.push_back(date_format_.substr(part_begin));
+}
 
-    // 左值
-    auto getSubpattern() & -> const std::string&
+auto DateTimeFormatItem::format(LogBuffer& buf, const LogEvent& event) const -> void
+{
+    auto second = event.getTime();
+    auto& entry = t_date_cache[cache_id_ % c_k_date_cache_slots];
+    if(entry.id_ != cache_id_ or entry.second_ != second)
     {
-        return date_format_;
+        // 换秒了(或者槽位被别的格式占用)，重新渲染各段
+        std::tm tm_buf;
+        localtime_r(&second, &tm_buf); // 将时间戳转换为本地时间
+        auto pos = size_t{0};
+        for(auto i = size_t{0}; i < parts_.size(); ++i)
+        {
+            if(not parts_[i].empty())
+            {
+                pos += std::strftime(entry.text_ + pos, c_k_date_text_size - pos, parts_[i].c_str(), &tm_buf);
+            }
+            entry.ends_[i] = static_cast<uint16_t>(pos);
+        }
+        entry.id_ = cache_id_;
+        entry.second_ = second;
     }
 
-    // 右值
-    auto getSubpattern() && -> std::string
+    auto begin = size_t{0};
+    for(auto i = size_t{0}; i < parts_.size(); ++i)
     {
-        return std::move(date_format_);
+        buf.append(entry.text_ + begin, entry.ends_[i] - begin);
+        begin = entry.ends_[i];
+        if(i < sub_seconds_.size())
+        {
+            auto micros = event.getMicrosecond();
+            if(sub_seconds_[i] == SubSecond::Milli)
+            {
+                buf.appendFixed(micros / 1000, 3);
+            }
+            else
+            {
+                buf.appendFixed(micros, 6);
+            }
+        }
     }
+}
 
-private:
-    std::string date_format_ =  "%Y-%m-%d %H:%M:%S";
-};
-
-class StringFormatItem{
-public:
-    explicit StringFormatItem(std::string str) : str_(std::move(str)){}
+/*===================================结构化字段======================= */
+auto EscapedMessageFormatItem::format(LogBuffer& buf, const LogEvent& event) -> void
+{
+    AppendJsonEscaped(buf, event.getContent());
+}
 
-    auto format(std::ostream& os, const LogEvent& event) -> size_t
-    {
-        std::streampos start = os.tellp();
-        os << str_;
-        return static_cast<size_t>(os.tellp() - start);
-    }
-private:
-    std::string str_;
+auto JsonFieldsFormatItem::format(LogBuffer& buf, const LogEvent& event) -> void
+{
+    event.forEachField([&buf](const LogEvent::Field& field){
+        buf.append(",\"", 2);
+        AppendJsonEscaped(buf, field.key_);
+        buf.append("\":", 2);
+        AppendFieldValue(buf, field, true);
+    });
 }
 
-using ItemFactoryFunc = std::function<Sptr<PatternItemFacade>()>;
-auto RegisterItemFactoryFunc() -> std::unordered_map<std::string, ItemFactoryFunc>{
-    auto func_map = std::unordered_map<std::string, ItemFactory>{
-#define XX(str, ItemType) \
-        { \
-            #str,[]() -> Sptr<PatternItemFacade>{return Sptr<PatternItemFacade>{new PatternItemProxy<ItemType>{}}}; \
-        }
-        XX(m, MessageFormatItem),       // m:消息
-        XX(p, levelFormatItem),         // p:日志级别
-        XX(c, NameFormatItem),          // c:日志器名称
-        XX(r, ElapseFormatItem),        // r:累计毫秒数
-        XX(f, FilenameFormatItem),      // f:文件名
-        XX(l, LineFormatItem),          // l:行号
-        XX(t, ThreadIdFormatItem),      // t:线程号
-        XX(F, FiberIdFormatItem),       // F:协程号
-        XX(N, ThreadNameFormatItem),    // N:线程名称
-        XX(T, TabFormatItem),           // T:制表符
-        XX(n, NewLineFormatItem),       // n:换行符
-        XX(%, PercentSignFormatItem),   // %:百分号
-        XX(v, FunctionNameFormatItem),  //v:函数名XX()
-#undef XX
-    };
-    return func_map;
+auto LogfmtFieldsFormatItem::format(LogBuffer& buf, const LogEvent& event) -> void
+{
+    event.forEachField([&buf](const LogEvent::Field& field){
+        buf.push_back(' ');
+        buf.append(field.key_);
+        buf.push_back('=');
+        AppendFieldValue(buf, field, false);
+    });
 }
 
-using StatusItemFactoryFunc = std::function<Sptr<PatternItemFacade>(std::string)>;
+/*===================================Item 注册表======================= */
 
-auto RegisterStatusItemFactoryFunc() -> std::unordered_map<std::string, StatusItemFactoryFunc>{
-    return std::unordered_map<std::string, StatusItemFactoryFunc>{
-#define XX(str, ItemType) \
-        { \
-            #str, [](std::string sub_pattern) -> Sptr<PatternItemFacade>{ \
-                // std::make_shared<...>(...)在堆内存（Heap）里分配一块空间，创建这个对象。返回一个智能指针。
-                return std::static_pointer_cast<PatternItemFacade>(std::make_shared<PatternItemProxy<ItemType>>(sub_pattern)); \
-            } \
-        }
-            XX(d, DateTimeFormatItem),
-            XX(str, StringFormatItem)
+auto MakePatternItem(char c) -> std::optional<PatternItem>
+{
+    switch(c)
+    {
+#define XX(ch, ItemType) \
+        case ch: return PatternItem{std::in_place_type<ItemType>};
+        COTTON_PATTERN_ITEM_LIST(XX)
 #undef XX
-    };
+        default: return std::nullopt;
+    }
 }
 
+auto MakeStatusPatternItem(char c, std::string sub_pattern) -> std::optional<PatternItem>
+{
+    switch(c)
+    {
+        case 'd': return PatternItem{std::in_place_type<DateTimeFormatItem>, std::move(sub_pattern)};
+        default:  return std::nullopt;
+    }
+}
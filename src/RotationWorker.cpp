@@ -0,0 +1,429 @@
+#include "logger/RotationWorker.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <memory>
+#include <system_error>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace {
+
+constexpr size_t c_compress_chunk = 64 * 1024;     // 压缩、恢复 .next 时每次读入的字节数
+constexpr int c_worker_nice = 19;                  // 后台线程的 nice 值(最低优先级)
+
+auto ReportError(std::string_view what, const std::string& path) -> void
+{
+    auto ec = std::error_code(errno, std::system_category());
+    std::cerr << "[ERROR] RotationWorker: " << what << " " << path << ": " << ec.message() << std::endl;
+}
+
+} // namespace
+
+RotationWorker::RotationWorker(std::string filename, RotationPolicy policy)
+    : filename_{std::move(filename)}
+    , next_filename_{filename_ + ".next"}
+    , policy_{policy}
+{
+    recoverNext_();
+    // 第一个 .next 由后台线程打开，它还没打开时的滚动由 takeNextFd 同步兜底
+    thread_ = std::thread{[this]{ run_(); }};
+}
+
+RotationWorker::~RotationWorker()
+{
+    {
+        auto _ = std::lock_guard{mutex_};
+        stop_ = true;
+    }
+    cond_.notify_one();
+    thread_.join();
+
+    // 没用上的 .next 是空文件，直接删掉；不空说明重命名失败、写日志的线程写到了 .next 里，留给下次启动时 recoverNext_ 并入 <filename>
+    if(next_fd_ >= 0)
+    {
+        struct stat file_stat {};
+        auto empty = ::fstat(next_fd_, &file_stat) == 0 and file_stat.st_size == 0;
+        ::close(next_fd_);
+        if(empty)
+        {
+            ::unlink(next_filename_.c_str());
+        }
+    }
+}
+
+auto RotationWorker::takeNextFd() -> int
+{
+    {
+        auto _ = std::lock_guard{mutex_};
+        if(next_fd_ >= 0)
+        {
+            next_taken_ = true;
+            return std::exchange(next_fd_, -1);
+        }
+    }
+
+    // 后台还没准备好：不等 nice 19 的后台线程被调度，在这里把重命名和打开做完
+    {
+        auto _ = std::lock_guard{rotate_mutex_};
+        if(prepareNext_())
+        {
+            sync_fallbacks_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    auto _ = std::lock_guard{mutex_};
+    if(next_fd_ < 0)
+    {
+        // 同步打开也失败：这一次由调用方同步滚动，同时让后台再试着打开一次
+        retry_open_ = true;
+        cond_.notify_one();
+        return -1;
+    }
+    next_taken_ = true;
+    return std::exchange(next_fd_, -1);
+}
+
+auto RotationWorker::submit(int old_fd, std::string rotated_name) -> void
+{
+    {
+        auto _ = std::lock_guard{mutex_};
+        rotations_.push_back(Rotation{old_fd, std::move(rotated_name)});
+        next_taken_ = false;
+    }
+    cond_.notify_one();
+}
+
+auto RotationWorker::run_() -> void
+{
+    // 压缩和清理都不急，不和业务线程抢 CPU
+    ::setpriority(PRIO_PROCESS, static_cast<id_t>(::gettid()), c_worker_nice);
+
+    {
+        auto _ = std::lock_guard{rotate_mutex_};
+        std::ignore = prepareNext_();
+    }
+    auto lock = std::unique_lock{mutex_};
+
+    while(true)
+    {
+        cond_.wait(lock, [this]{ return stop_ or retry_open_ or not rotations_.empty() or not finished_.empty(); });
+
+        // 1.重命名优先：写日志的线程下一次滚动就要用 .next，没准备好它就得自己同步打开
+        if(not rotations_.empty() or retry_open_)
+        {
+            lock.unlock();
+            {
+                auto _ = std::lock_guard{rotate_mutex_};
+                std::ignore = prepareNext_();
+            }
+            lock.lock();
+            continue;
+        }
+
+        // 2.压缩并清理滚动出去的文件，一次一个，中间随时让位给新的重命名
+        if(not finished_.empty())
+        {
+            auto path = std::move(finished_.front());
+            finished_.pop_front();
+            lock.unlock();
+            if(policy_.compress_)
+            {
+                compress_(path);
+            }
+            enforceRetention_();
+            lock.lock();
+            continue;
+        }
+
+        if(stop_)
+        {
+            break;
+        }
+    }
+}
+
+auto RotationWorker::recoverNext_() -> void
+{
+    auto in = ::open(next_filename_.c_str(), O_RDONLY | O_CLOEXEC);
+    if(in < 0)
+    {
+        return;
+    }
+    struct stat file_stat {};
+    if(::fstat(in, &file_stat) != 0 or file_stat.st_size == 0)
+    {
+        ::close(in);
+        ::unlink(next_filename_.c_str());
+        return;
+    }
+
+    // .next 里是滚动到一半时写的日志，接在 <filename> 后面(<filename> 已经被改名时就是新建)
+    auto out = ::open(filename_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if(out < 0)
+    {
+        ReportError("打开日志文件失败", filename_);
+        ::close(in);
+        return;
+    }
+    auto buffer = std::make_unique<char[]>(c_compress_chunk);
+    auto ok = true;
+    while(ok)
+    {
+        auto n = ::read(in, buffer.get(), c_compress_chunk);
+        if(n < 0 and errno == EINTR)
+        {
+            continue;
+        }
+        if(n <= 0)
+        {
+            ok = n == 0;
+            break;
+        }
+        for(auto done = ssize_t{0}; done < n;)
+        {
+            auto written = ::write(out, buffer.get() + done, static_cast<size_t>(n - done));
+            if(written < 0 and errno == EINTR)
+            {
+                continue;
+            }
+            if(written < 0)
+            {
+                ok = false;
+                break;
+            }
+            done += written;
+        }
+    }
+    ::close(in);
+    ok = ::close(out) == 0 and ok;
+
+    if(not ok)
+    {
+        // 追加失败时不能再把它当 .next 接着写，改成单独的文件保留下来
+        auto kept = uniqueName_(filename_ + ".recovered");
+        ReportError("恢复 .next 失败，改名保留为 " + kept, next_filename_);
+        std::rename(next_filename_.c_str(), kept.c_str());
+        return;
+    }
+    ::unlink(next_filename_.c_str());
+}
+
+auto RotationWorker::prepareNext_() -> bool
+{
+    auto rotations = std::deque<Rotation>{};
+    auto need_open = false;
+    {
+        auto _ = std::lock_guard{mutex_};
+        rotations = std::exchange(rotations_, {});
+        retry_open_ = false;
+        need_open = next_fd_ < 0 and not next_taken_;
+    }
+    for(auto& rotation : rotations)
+    {
+        rotate_(rotation);
+    }
+    // 只有持有 rotate_mutex_ 的一方会设置 next_fd_，开锁期间它只可能被取走，不会被别人填上
+    auto fd = need_open ? openNext_() : -1;
+    {
+        auto _ = std::lock_guard{mutex_};
+        if(fd >= 0)
+        {
+            next_fd_ = fd;
+        }
+        for(auto& rotation : rotations)
+        {
+            finished_.push_back(std::move(rotation.rotated_name_));
+        }
+    }
+    if(not rotations.empty())
+    {
+        // 调用方同步兜底时，压缩和清理仍交给后台
+        cond_.notify_one();
+    }
+    return need_open;
+}
+
+auto RotationWorker::rotate_(Rotation& rotation) -> void
+{
+    // 写日志的线程已经换到 .next 上了，旧文件这时才关闭
+    ::close(rotation.fd_);
+
+    rotation.rotated_name_ = uniqueName_(rotation.rotated_name_);
+    if(std::rename(filename_.c_str(), rotation.rotated_name_.c_str()) != 0)
+    {
+        ReportError("重命名日志文件失败", filename_);
+    }
+    if(std::rename(next_filename_.c_str(), filename_.c_str()) != 0)
+    {
+        ReportError("重命名日志文件失败", next_filename_);
+    }
+}
+
+auto RotationWorker::openNext_() -> int
+{
+    // 启动时残留的 .next 已经由 recoverNext_ 处理掉，这里正常是新建；
+    // 不截断：rotate_ 里 .next 改名失败时写日志的线程还在往这个文件写
+    auto fd = ::open(next_filename_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if(fd < 0)
+    {
+        ReportError("预先打开日志文件失败", next_filename_);
+    }
+    return fd;
+}
+
+auto RotationWorker::compress_(const std::string& path) -> void
+{
+    auto gz_path = path + ".gz";
+    auto tmp_path = gz_path + ".tmp";
+
+    auto in = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if(in < 0)
+    {
+        // 滚动比压缩快时，排队等压缩的旧文件可能已经被 enforceRetention_ 删掉了
+        if(errno != ENOENT)
+        {
+            ReportError("打开待压缩文件失败", path);
+        }
+        return;
+    }
+    auto out = gzopen(tmp_path.c_str(), "wb");
+    if(out == nullptr)
+    {
+        ReportError("创建压缩文件失败", tmp_path);
+        ::close(in);
+        return;
+    }
+
+    auto buffer = std::make_unique<char[]>(c_compress_chunk);
+    auto ok = true;
+    while(true)
+    {
+        auto n = ::read(in, buffer.get(), c_compress_chunk);
+        if(n < 0 and errno == EINTR)
+        {
+            continue;
+        }
+        if(n <= 0)
+        {
+            ok = n == 0;
+            break;
+        }
+        if(gzwrite(out, buffer.get(), static_cast<unsigned>(n)) != static_cast<int>(n))
+        {
+            ok = false;
+            break;
+        }
+    }
+    ::close(in);
+    ok = gzclose(out) == Z_OK and ok;
+
+    auto ec = std::error_code{};
+    if(not ok)
+    {
+        std::cerr << "[ERROR] RotationWorker: 压缩失败，保留原文件 " << path << std::endl;
+        std::filesystem::remove(tmp_path, ec);
+        return;
+    }
+    // 和 gzip 一样保留原文件的修改时间，清理时按它排序
+    std::filesystem::last_write_time(tmp_path, std::filesystem::last_write_time(path, ec), ec);
+    std::filesystem::rename(tmp_path, gz_path, ec);
+    if(ec)
+    {
+        std::cerr << "[ERROR] RotationWorker: 重命名压缩文件失败 " << tmp_path << ": " << ec.message() << std::endl;
+        return;
+    }
+    std::filesystem::remove(path, ec);
+}
+
+auto RotationWorker::enforceRetention_() -> void
+{
+    if(policy_.max_files_ == 0 and policy_.max_total_bytes_ == 0)
+    {
+        return;
+    }
+
+    // 滚动出去的文件名形如 stem.2026-01-01_00-00-00[.N]extension[.gz]
+    auto p = std::filesystem::path{filename_};
+    auto prefix = p.stem().string() + ".";
+    auto extension = p.extension().string();
+    auto dir = p.parent_path().empty() ? std::filesystem::path{"."} : p.parent_path();
+    auto is_rotated = [&prefix, &extension](const std::string& name){
+        if(not name.starts_with(prefix) or name.size() <= prefix.size() or
+           name[prefix.size()] < '0' or name[prefix.size()] > '9' or name.ends_with(".tmp"))
+        {
+            return false;
+        }
+        return name.ends_with(extension) or name.ends_with(extension + ".gz");
+    };
+
+    struct Rotated{
+        std::filesystem::file_time_type time_;
+        std::filesystem::path path_;
+        uintmax_t size_ = 0;
+    };
+    auto files = std::vector<Rotated>{};
+    auto total = uintmax_t{0};
+    auto ec = std::error_code{};
+    for(const auto& entry : std::filesystem::directory_iterator{dir, ec})
+    {
+        auto name = entry.path().filename().string();
+        if(not entry.is_regular_file(ec) or not is_rotated(name))
+        {
+            continue;
+        }
+        auto rotated = Rotated{entry.last_write_time(ec), entry.path(), entry.file_size(ec)};
+        total += rotated.size_;
+        files.push_back(std::move(rotated));
+    }
+
+    // 从最旧的开始删，直到数量和总大小都满足限制
+    std::ranges::sort(files, [](const Rotated& lhs, const Rotated& rhs){
+        return std::tie(lhs.time_, lhs.path_) < std::tie(rhs.time_, rhs.path_);
+    });
+    auto count = files.size();
+    for(const auto& file : files)
+    {
+        auto over_count = policy_.max_files_ != 0 and count > policy_.max_files_;
+        auto over_bytes = policy_.max_total_bytes_ != 0 and total > policy_.max_total_bytes_;
+        if(not over_count and not over_bytes)
+        {
+            break;
+        }
+        if(std::filesystem::remove(file.path_, ec))
+        {
+            --count;
+            total -= file.size_;
+        }
+    }
+}
+
+auto RotationWorker::uniqueName_(const std::string& name) const -> std::string
+{
+    auto exists = [](const std::string& path){
+        auto ec = std::error_code{};
+        return std::filesystem::exists(path, ec) or std::filesystem::exists(path + ".gz", ec);
+    };
+    if(not exists(name))
+    {
+        return name;
+    }
+    auto p = std::filesystem::path{name};
+    for(auto seq = 1;; ++seq)
+    {
+        auto candidate = (p.parent_path() / std::format("{}.{}{}", p.stem().string(), seq, p.extension().string())).string();
+        if(not exists(candidate))
+        {
+            return candidate;
+        }
+    }
+}
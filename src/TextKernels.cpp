@@ -0,0 +1,129 @@
+#include "logger/TextKernels.h"
+
+#include <array>
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#define COTTON_TEXT_KERNELS_X86 1
+#endif
+
+namespace TextKernels {
+
+namespace {
+
+constexpr auto c_k_needs_json_escape = []{
+    auto table = std::array<bool, 256>{};
+    for(auto c = 0; c < 0x20; ++c)
+    {
+        table[c] = true;
+    }
+    table['"'] = true;
+    table['\\'] = true;
+    return table;
+}();
+
+auto FindScalar(const char* begin, const char* end) -> const char*
+{
+    while(begin != end and not c_k_needs_json_escape[static_cast<unsigned char>(*begin)])
+    {
+        ++begin;
+    }
+    return begin;
+}
+
+#ifdef COTTON_TEXT_KERNELS_X86
+// 三类字节各比较一次再合并：x <= 0x1F 等价于 min(x, 0x1F) == x
+auto FindSse2(const char* begin, const char* end) -> const char*
+{
+    const auto quote = _mm_set1_epi8('"');
+    const auto backslash = _mm_set1_epi8('\\');
+    const auto control = _mm_set1_epi8(0x1F);
+    for(; end - begin >= 16; begin += 16)
+    {
+        auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+        auto hits = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(bytes, quote), _mm_cmpeq_epi8(bytes, backslash)),
+                                 _mm_cmpeq_epi8(_mm_min_epu8(bytes, control), bytes));
+        if(auto mask = static_cast<uint32_t>(_mm_movemask_epi8(hits)); mask != 0)
+        {
+            return begin + std::countr_zero(mask);
+        }
+    }
+    return FindScalar(begin, end);
+}
+
+__attribute__((target("avx2")))
+auto FindAvx2(const char* begin, const char* end) -> const char*
+{
+    const auto quote = _mm256_set1_epi8('"');
+    const auto backslash = _mm256_set1_epi8('\\');
+    const auto control = _mm256_set1_epi8(0x1F);
+    for(; end - begin >= 32; begin += 32)
+    {
+        auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+        auto hits = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(bytes, quote), _mm256_cmpeq_epi8(bytes, backslash)),
+                                    _mm256_cmpeq_epi8(_mm256_min_epu8(bytes, control), bytes));
+        if(auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits)); mask != 0)
+        {
+            return begin + std::countr_zero(mask);
+        }
+    }
+    // 不足 32 字节的尾巴先按 16 字节看一次
+    return FindSse2(begin, end);
+}
+#endif
+
+using FindFunc = auto (*)(const char*, const char*) -> const char*;
+
+auto FindFor(Isa isa) -> FindFunc
+{
+#ifdef COTTON_TEXT_KERNELS_X86
+    if(isa == Isa::Avx2 and BestIsa() == Isa::Avx2)
+    {
+        return FindAvx2;
+    }
+    if(isa != Isa::Scalar)
+    {
+        return FindSse2;
+    }
+#endif
+    return FindScalar;
+}
+
+} // namespace
+
+auto BestIsa() -> Isa
+{
+#ifdef COTTON_TEXT_KERNELS_X86
+    static const auto s_isa = []{
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") ? Isa::Avx2 : Isa::Sse2;
+    }();
+    return s_isa;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+auto IsaName(Isa isa) -> std::string_view
+{
+    switch(isa)
+    {
+        case Isa::Scalar: return "scalar";
+        case Isa::Sse2:   return "sse2";
+        case Isa::Avx2:   return "avx2";
+    }
+    return "scalar";
+}
+
+auto FindJsonEscape(std::string_view text) -> size_t
+{
+    static const auto s_find = FindFor(BestIsa());
+    return static_cast<size_t>(s_find(text.data(), text.data() + text.size()) - text.data());
+}
+
+auto FindJsonEscape(std::string_view text, Isa isa) -> size_t
+{
+    return static_cast<size_t>(FindFor(isa)(text.data(), text.data() + text.size()) - text.data());
+}
+
+} // namespace TextKernels
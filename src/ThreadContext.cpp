@@ -0,0 +1,46 @@
+#include "logger/ThreadContext.h"
+
+#include <array>
+#include <pthread.h>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+// 内核线程名最长 15 字节(不含结尾的 '\0')
+constexpr size_t c_max_os_name = 15;
+
+} // namespace
+
+auto ThreadContext::init_() -> void
+{
+    // 在任何线程缓存线程号之前登记，之后 fork 出的子进程都会刷新
+    [[maybe_unused]] static const auto s_fork_handler = ::pthread_atfork(nullptr, nullptr, &ThreadContext::onForkChild_);
+
+    t_local_.tid_ = static_cast<uint32_t>(::gettid());
+
+    // 没有设置过名称的线程沿用内核里的名字(默认是进程名)
+    auto os_name = std::array<char, c_max_os_name + 1>{};
+    if(::pthread_getname_np(::pthread_self(), os_name.data(), os_name.size()) == 0)
+    {
+        t_local_.name_ = LogNameRegistry::Intern(std::string_view{os_name.data()});
+    }
+}
+
+auto ThreadContext::onForkChild_() -> void
+{
+    // 没初始化过的线程下次用到时自然会取；这里只调用 gettid()，在 fork 之后的子进程里是安全的
+    if(t_local_.tid_ != 0)
+    {
+        t_local_.tid_ = static_cast<uint32_t>(::gettid());
+    }
+}
+
+auto ThreadContext::SetName(std::string_view name) -> void
+{
+    local_();
+    t_local_.name_ = LogNameRegistry::Intern(name);
+
+    auto os_name = std::string{name.substr(0, c_max_os_name)};
+    ::pthread_setname_np(::pthread_self(), os_name.c_str());
+}
@@ -2,10 +2,11 @@
 
 # 解析：
 # 1. testlogger.cpp       : 你的测试主程序
-# 2. ../src/*.cpp         : 你的所有源代码 (Logger.cpp 等)
+# 2. ../src/*.cpp ../net/*.cpp : 你的所有源代码 (Logger.cpp 等，NetworkAppender 用到 net/ 下的 EventLoop)
 # 3. -I../include         : 让编译器能找到 "logger/Logger.h"
 # 4. -I..                 : 让编译器能找到 "common/alias.h" (关键修复！)
 # 5. -std=c++23 -lpthread : 标准库和线程库支持
+# 6. -lz                  : 滚动文件的 gzip 压缩(zlib)
 
-g++ testlogger.cpp ../src/*.cpp -I../include -I.. -std=c++23 -lpthread -o testlogger && ./testlogger
+g++ testlogger.cpp ../src/*.cpp ../net/*.cpp -I../include -I.. -std=c++23 -lpthread -lz -o testlogger && ./testlogger
 ./run testlogger
\ No newline at end of file
@@ -2,24 +2,1615 @@
 #include "logger/AsyncLogger.h"
 #include "logger/LoggerAppender.h"
 #include "logger/AppenderProxy.hpp"
+#include "logger/BinaryLogReader.h"
+#include "logger/LogManager.h"
+#include "logger/NetworkAppender.h"
+#include "logger/StaticLogFormatter.hpp"
+#include "logger/TextKernels.h"
+#include "logger/ThreadContext.h"
 #include "common/alias.h"
+#include "common/LogMacros.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <atomic>
+#include <charconv>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <limits>
+#include <new>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+    std::atomic<size_t> g_alloc_count = 0;
+}
+
+// 替换全局 operator new，统计堆分配次数(TestBufferPoolBurstNoAllocations 用)
+auto operator new(std::size_t size) -> void*
+{
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    if(auto* p = std::malloc(size == 0 ? 1 : size))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+// 按缓存行对齐的类型(事件缓冲、AsyncLogger 本身)走对齐版本，同样计数
+auto operator new(std::size_t size, std::align_val_t align) -> void*
+{
+    g_alloc_count.fetch_add(1, std::memory_order_relaxed);
+    auto alignment = static_cast<std::size_t>(align);
+    if(auto* p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment))
+    {
+        return p;
+    }
+    throw std::bad_alloc{};
+}
+
+// 上面两个 operator new 都是 malloc/aligned_alloc 分配的，这里配对的 free 是对的；
+// GCC 把 delete 内联到 new 表达式旁边后只看到 new 配 free，会误报 -Wmismatched-new-delete
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+// 只计数的 Appender，用来检查异步日志有没有丢事件
+std::atomic<size_t> g_logged_count = 0;
+
+std::atomic<size_t> g_logged_error_count = 0;
+
+class CountingAppender{
+public:
+    static void log(const LogFormatter&, const LogEvent& event)
+    {
+        g_logged_count.fetch_add(1);
+        if(event.getLevel() >= LogLevel::ERROR)
+        {
+            g_logged_error_count.fetch_add(1);
+        }
+    }
+};
+
+// 检查延迟格式化的事件到达 appender 时内容已经在后台线程格式化好
+std::atomic<size_t> g_content_mismatch = 0;
+
+class ContentCheckAppender{
+public:
+    static void log(const LogFormatter&, const LogEvent& event)
+    {
+        g_logged_count.fetch_add(1);
+        if(event.getContent() != "deferred 7 2.5 x true")
+        {
+            g_content_mismatch.fetch_add(1);
+        }
+    }
+};
+
+// 延迟格式化：纯值参数只记录字节，字符串参数退化为立即格式化，两者输出必须一致
+auto TestDeferredFormatting() -> bool
+{
+    constexpr size_t c_events = 200;
+
+    g_logged_count = 0;
+    g_content_mismatch = 0;
+    auto async_logger = std::make_shared<AsyncLogger>(1, AsyncFrontEnd::MpscRing);
+    async_logger->addAppender(std::make_shared<AppenderProxy<ContentCheckAppender>>());
+    async_logger->start();
+
+    auto deferred_count = size_t{0};
+    for(auto i = size_t{0}; i < c_events; ++i)
+    {
+        auto event = LogEvent{"TestLogger", LogLevel::INFO, 0, 0, "Main", 0, 0};
+        if(i % 2 == 0)
+        {
+            event.printDeferred("deferred {} {} {} {}", 7, 2.5, 'x', true);
+        }
+        else
+        {
+            event.printDeferred("deferred {} {} {} {}", 7, 2.5, std::string_view{"x"}, true);
+        }
+        deferred_count += event.isDeferred();
+        async_logger->append(std::move(event));
+    }
+    async_logger->stop();
+
+    std::cout << "Deferred formatting: " << deferred_count << " deferred, "
+              << g_content_mismatch << " mismatches in " << g_logged_count << " events\n";
+    return g_logged_count == c_events and g_content_mismatch == 0 and deferred_count == c_events / 2;
+}
+
+// 编译期格式器与运行期格式器对同一模式的输出必须逐字节一致
+auto TestStaticFormatterMatchesRuntime() -> bool
+{
+    auto event = LogEvent{"TestLogger", LogLevel::WARN, 5, 77, "Main", 1700000000, 3};
+    event.print("static {} %x {}", 1, "formatter");
+
+    auto runtime = LogFormatter{}.format(event);
+    auto compiled = StaticLogFormatter<c_k_default_pattern>{}.format(event);
+    auto odd_runtime = LogFormatter{"%q%%[%p]%x%m"}.format(event);
+    auto odd_compiled = StaticLogFormatter<"%q%%[%p]%x%m">{}.format(event);
+
+    // 秒以下的部分：%L 毫秒、%f 微秒，同一秒内第二次走缓存
+    event.setTimePoint(SystemClock::time_point{std::chrono::seconds{1700000000} + std::chrono::microseconds{7042}});
+    auto sub_second = LogFormatter{"%d{%S.%L|%f}"}.format(event);
+    auto sub_second_cached = StaticLogFormatter<"%d{%S.%L|%f}">{}.format(event);
+
+    auto ok = runtime == compiled and odd_runtime == odd_compiled
+          and sub_second == "20.007|007042" and sub_second_cached == sub_second;
+    std::cout << "Static formatter: " << (ok ? "matches" : "differs from") << " runtime formatter\n";
+    return ok;
+}
+
+// MmapFileAppender：模拟崩溃留下的预分配 '\0'，重新打开后要接着真实内容写，关闭后文件长度必须精确
+auto TestMmapAppenderRecoversAfterCrash() -> bool
+{
+    constexpr auto c_file = "mmap_test.log";
+    constexpr size_t c_events = 100;
+    const auto c_previous = std::string{"line written before the crash\n"};
+
+    {
+        auto crashed = std::ofstream{c_file, std::ios::out | std::ios::trunc | std::ios::binary};
+        crashed << c_previous;
+    }
+    std::filesystem::resize_file(c_file, 1_mb);     // 崩溃时还没截断的预分配部分
+
+    auto formatter = LogFormatter{"%c %p %m%n"};
+    auto expected = c_previous;
+    {
+        auto appender = MmapFileAppender{c_file};
+        for(auto i = size_t{0}; i < c_events; ++i)
+        {
+            auto event = LogEvent{"TestLogger", LogLevel::INFO, 0, 0, "Main", 0, 0};
+            event.print("mmap {}", i);
+            expected += formatter.format(event);
+            appender.log(formatter, event);
+        }
+    }
+
+    auto stream = std::ifstream{c_file, std::ios::binary};
+    auto content = std::string{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+    std::filesystem::remove(c_file);
+
+    auto ok = content == expected;
+    std::cout << "Mmap appender: " << content.size() << "/" << expected.size() << " bytes after reopen"
+              << (ok ? "" : ", content differs") << "\n";
+    return ok;
+}
+
+// RollingFileAppender：滚动交给后台，旧文件压缩成 .gz，只保留最新的 c_keep 个，不留下 .next 和未压缩的滚动文件
+auto TestRollingFileRetention() -> bool
+{
+    constexpr auto c_dir = "rotation_test";
+    constexpr size_t c_keep = 3;
+    constexpr size_t c_events = 400;
+    const auto c_file = std::string{c_dir} + "/app.log";
+    std::filesystem::remove_all(c_dir);
+    std::filesystem::create_directory(c_dir);
+
+    auto formatter = LogFormatter{"%c %p %m%n"};
+    {
+        auto appender = RollingFileAppender{c_file, 1_kb, Seconds{60 * 60},
+                                            RotationPolicy{.compress_ = true, .max_files_ = c_keep}};
+        for(auto i = size_t{0}; i < c_events; ++i)
+        {
+            auto event = LogEvent{"TestLogger", LogLevel::INFO, 0, 0, "Main", 0, 0};
+            event.print("rotation {}", i);
+            appender.log(formatter, event);
+        }
+    }
+
+    auto gz_files = size_t{0};
+    auto others = size_t{0};
+    for(const auto& entry : std::filesystem::directory_iterator{c_dir})
+    {
+        auto name = entry.path().filename().string();
+        if(name.ends_with(".log.gz"))
+        {
+            ++gz_files;
+        }
+        else if(name != "app.log")
+        {
+            ++others;
+        }
+    }
+    std::filesystem::remove_all(c_dir);
+
+    auto ok = gz_files == c_keep and others == 0;
+    std::cout << "Rolling file retention: " << gz_files << " compressed kept, " << others << " stray files\n";
+    return ok;
+}
+
+// 滚动到一半时崩溃：<filename> 是旧日志，.next 里是更新的日志。重启后 .next 要接在 <filename> 后面，之后的日志再接在它后面
+auto TestRollingFileRecoversNext() -> bool
+{
+    constexpr auto c_dir = "recover_test";
+    const auto c_file = std::string{c_dir} + "/app.log";
+    std::filesystem::remove_all(c_dir);
+    std::filesystem::create_directory(c_dir);
+    std::ofstream{c_file} << "before crash: old\n";
+    std::ofstream{c_file + ".next"} << "before crash: rotated to .next\n";
+
+    auto formatter = LogFormatter{"%m%n"};
+    {
+        auto appender = RollingFileAppender{c_file};
+        auto event = LogEvent{"TestLogger", LogLevel::INFO, 0, 0, "Main", 0, 0};
+        event.print("after restart");
+        appender.log(formatter, event);
+    }
+
+    auto stream = std::ifstream{c_file};
+    auto content = std::string{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+    auto next_left = std::filesystem::exists(c_file + ".next");
+    std::filesystem::remove_all(c_dir);
+
+    auto ok = content == "before crash: old\nbefore crash: rotated to .next\nafter restart\n" and not next_left;
+    std::cout << "Rolling file recovery: leftover .next " << (content.find(".next\nafter") != std::string::npos ? "appended in order" : "out of order")
+              << (next_left ? ", .next still present\n" : ", .next removed\n");
+    return ok;
+}
+
+// 连续快速滚动：后台(nice 19)来不及预先打开 .next 时写日志的线程自己同步打开，不等后台；
+// 每个文件里的行号连续，所有文件的行号区间拼起来正好是 [0, c_events)，没有丢失也没有交错
+auto TestRotationSyncFallback() -> bool
+{
+    constexpr auto c_dir = "fallback_test";
+    constexpr size_t c_events = 2000;
+    std::filesystem::remove_all(c_dir);
+    std::filesystem::create_directory(c_dir);
+
+    auto formatter = LogFormatter{"%m%n"};
+    auto rotations = Histogram::Snapshot{};
+    auto fallbacks = uint64_t{0};
+    {
+        auto appender = AppenderProxy<RollingFileAppender>{formatter, std::string{c_dir} + "/app.log", 256};
+        for(auto i = size_t{0}; i < c_events; ++i)
+        {
+            auto event = LogEvent{"TestLogger", LogLevel::INFO, 0, 0, "Main", 0, 0};
+            event.print("{}", i);
+            appender.log(event);
+        }
+        rotations = appender.getRotationStats();
+        fallbacks = appender.getRotationFallbacks();
+    }
+
+    auto ranges = std::vector<std::pair<size_t, size_t>>{};    // 每个文件的 [首行, 末行+1)
+    auto contiguous = true;
+    for(const auto& entry : std::filesystem::directory_iterator{c_dir})
+    {
+        auto stream = std::ifstream{entry.path()};
+        auto line = std::string{};
+        auto range = std::pair<size_t, size_t>{0, 0};
+        auto first = true;
+        while(std::getline(stream, line))
+        {
+            auto value = std::stoul(line);
+            contiguous = contiguous and (first or value == range.second);
+            range = {first ? value : range.first, value + 1};
+            first = false;
+        }
+        if(not first)
+        {
+            ranges.push_back(range);
+        }
+    }
+    std::filesystem::remove_all(c_dir);
+    std::ranges::sort(ranges);
+    auto expected_begin = size_t{0};
+    for(const auto& [begin, end] : ranges)
+    {
+        contiguous = contiguous and begin == expected_begin;
+        expected_begin = end;
+    }
+
+    auto ok = contiguous and expected_begin == c_events and rotations.count > 0 and fallbacks <= rotations.count
+              and ranges.size() == rotations.count + 1;
+    std::cout << "Rotation fallback: " << rotations.count << " rotations, " << fallbacks << " opened synchronously, "
+              << ranges.size() << " files" << (contiguous ? ", lines contiguous\n" : ", lines lost or interleaved\n");
+    return ok;
+}
+
+// BinaryFileAppender + BinaryLogReader：延迟参数原样写出、普通消息写文本，解码后按同一模式输出应与直接格式化完全一致
+auto TestBinaryLogRoundTrip() -> bool
+{
+    constexpr auto c_file = "binary_test.bin";
+    constexpr size_t c_events = 300;
+    std::filesystem::remove(c_file);
+
+    auto formatter = LogFormatter{"%d{%Y-%m-%d %H:%M:%S.%f} %p %c %N %t %F %r [%f:%l %v] %m%n"};
+    auto expected = std::string{};
+    {
+        auto appender = BinaryFileAppender{c_file};
+        auto now = std::chrono::system_clock::now();
+        for(auto i = size_t{0}; i < c_events; ++i)
+        {
+            auto event = LogEvent{"TestLogger", i % 2 == 0 ? LogLevel::INFO : LogLevel::ERROR,
+                                  static_cast<uint32_t>(i), 7, "Main", 0, static_cast<uint32_t>(i % 3)};
+            event.setTimePoint(now + std::chrono::microseconds{i * 1500});
+            if(i % 3 == 0)
+            {
+                event.printDeferred("deferred {} {:>6.2f} {} {:x} {{{}}}", i, 0.25 * static_cast<double>(i), i % 2 == 0, i, 'c');
+            }
+            else if(i % 3 == 1)
+            {
+                event.printDeferred("mixed {}-{} {:>3} {}", static_cast<int8_t>(-5), static_cast<uint16_t>(i), -static_cast<int64_t>(i), nullptr);
+            }
+            else
+            {
+                event.print("text {} {}", "message", i);
+            }
+            expected += formatter.format(event.rendered());
+            appender.log(formatter, event);
+        }
+        // 超出枚举范围的级别：直接格式化和解码后都输出 UNKNOW
+        auto invalid = LogEvent{"TestLogger", static_cast<LogLevel>(42), 0, 7, "Main", 0, 0};
+        invalid.setTimePoint(now);
+        invalid.print("invalid level");
+        expected += formatter.format(invalid);
+        appender.log(formatter, invalid);
+    }
+
+    auto decoded = std::string{};
+    auto corrupt = size_t{0};
+    auto last_level = LogLevel::ALL;
+    {
+        auto reader = BinaryLogReader{c_file};
+        auto event = LogEvent{};
+        while(reader.next(event))
+        {
+            decoded += formatter.format(event);
+            last_level = event.getLevel();
+        }
+        corrupt = reader.getCorruptBlocks();
+    }
+    auto binary_size = std::filesystem::file_size(c_file);
+    std::filesystem::remove(c_file);
+
+    auto ok = decoded == expected and corrupt == 0 and last_level == LogLevel::UNKNOW
+              and expected.find(" UNKNOW ") != std::string::npos;
+    std::cout << "Binary log: " << binary_size << " bytes for " << expected.size() << " bytes of text"
+              << (ok ? ", decoded identically" : ", decoded text differs") << "\n";
+    return ok;
+}
+
+// 名称驻留表按块增长：超过一块的名称都能登记、查回原字符串，二进制日志里大句柄的名称也能还原
+auto TestLogNameRegistryGrows() -> bool
+{
+    constexpr auto c_file = "name_registry_test.bin";
+    constexpr size_t c_names = LogNameRegistry::c_k_chunk_names + 100;
+    std::filesystem::remove(c_file);
+
+    auto ids = std::vector<NameId>{};
+    for(auto i = size_t{0}; i < c_names; ++i)
+    {
+        ids.push_back(LogNameRegistry::Intern(std::format("registry.grow.{}", i)));
+    }
+    auto ok = LogNameRegistry::OverflowCount() == 0;
+    for(auto i = size_t{0}; i < c_names; ++i)
+    {
+        auto name = std::format("registry.grow.{}", i);
+        ok = ok and ids[i] != LogNameRegistry::c_empty_id and LogNameRegistry::Lookup(ids[i]) == name
+                and LogNameRegistry::Intern(name) == ids[i];
+    }
+
+    auto formatter = LogFormatter{"%c %m%n"};
+    auto last = std::format("registry.grow.{}", c_names - 1);
+    {
+        auto appender = BinaryFileAppender{c_file};
+        auto event = LogEvent{ids.back(), LogLevel::INFO, 0, 0, LogNameRegistry::c_empty_id, 0, 0};
+        event.print("large name id");
+        appender.log(formatter, event);
+    }
+    auto decoded = std::string{};
+    {
+        auto reader = BinaryLogReader{c_file};
+        auto event = LogEvent{};
+        while(reader.next(event))
+        {
+            decoded += formatter.format(event);
+        }
+    }
+    std::filesystem::remove(c_file);
+    ok = ok and decoded == last + " large name id\n";
+
+    std::cout << "Name registry: " << c_names << " names interned (largest id " << ids.back() << "), "
+              << LogNameRegistry::OverflowCount() << " overflowed" << (ok ? ", all round-trip\n" : ", lookups broken\n");
+    return ok;
+}
+
+// 收到的事件里已经渲染好、以 "raw args " 开头的条数
+std::atomic<size_t> g_rendered_count = 0;
+
+class RenderedCheckAppender{
+public:
+    static void log(const LogFormatter&, const LogEvent& event)
+    {
+        if(not event.isDeferred() and event.getContent().starts_with("raw args "))
+        {
+            g_rendered_count.fetch_add(1);
+        }
+    }
+};
+
+// 经 AsyncLogger 和同步 Logger 写 BinaryFileAppender：延迟格式化的事件按原始参数存下，文件里有格式串、没有渲染好的消息；
+// 挂在同一日志器上的文本 appender 照样收到渲染好的文本
+auto TestBinaryAppenderKeepsRawArgs() -> bool
+{
+    constexpr auto c_file = "binary_raw_test.bin";
+    constexpr size_t c_events = 200;
+    std::filesystem::remove(c_file);
+    g_rendered_count = 0;
+
+    auto formatter = LogFormatter{"%p %m%n"};
+    auto expected = std::string{};
+    {
+        auto binary = std::make_shared<AppenderProxy<BinaryFileAppender>>(LogFormatter{}, c_file);
+        auto text = std::make_shared<AppenderProxy<RenderedCheckAppender>>();
+
+        auto async_logger = std::make_shared<AsyncLogger>(1);
+        async_logger->addAppender(binary);
+        async_logger->addAppender(text);
+        async_logger->start();
+        for(auto i = size_t{0}; i < c_events; ++i)
+        {
+            COTTON_LOG_INFO(async_logger, "raw args {} {:>6.2f}", i, 0.5 * static_cast<double>(i));
+            expected += std::format("INFO raw args {} {:>6.2f}\n", i, 0.5 * static_cast<double>(i));
+        }
+        async_logger->stop();
+
+        auto logger = std::make_shared<Logger>("RawArgsLogger");
+        logger->addAppender(binary);
+        logger->addAppender(text);
+        for(auto i = size_t{0}; i < c_events; ++i)
+        {
+            COTTON_LOG_WARN(logger, "raw args {} {:>6.2f}", i, 0.5 * static_cast<double>(i));
+            expected += std::format("WARN raw args {} {:>6.2f}\n", i, 0.5 * static_cast<double>(i));
+        }
+    }
+
+    auto stream = std::ifstream{c_file, std::ios::binary};
+    auto bytes = std::string{std::istreambuf_iterator<char>{stream}, std::istreambuf_iterator<char>{}};
+    auto raw = bytes.find("raw args {} {:>6.2f}") != std::string::npos and bytes.find("raw args 1") == std::string::npos;
+    auto decoded = std::string{};
+    {
+        auto reader = BinaryLogReader{c_file};
+        auto event = LogEvent{};
+        while(reader.next(event))
+        {
+            decoded += formatter.format(event);
+        }
+    }
+    std::filesystem::remove(c_file);
+
+    auto ok = raw and decoded == expected and g_rendered_count == 2 * c_events;
+    std::cout << "Binary appender via loggers: " << bytes.size() << " bytes, "
+              << (raw ? "raw arguments stored" : "rendered text stored") << ", "
+              << g_rendered_count << "/" << 2 * c_events << " rendered for the text appender"
+              << (decoded == expected ? "" : ", decoded text differs") << "\n";
+    return ok;
+}
+
+// 日志宏：级别被关掉时参数不求值，打开后同步/异步 logger 都能收到带参数的消息
+auto TestLogMacrosSkipDisabled() -> bool
+{
+    auto evaluated = size_t{0};
+    auto expensive = [&evaluated]{ return ++evaluated; };
+
+    auto logger = std::make_shared<Logger>("MacroLogger");
+    logger->addAppender(std::make_shared<AppenderProxy<CountingAppender>>());
+    logger->setLogLevel(LogLevel::INFO);
+    g_logged_count = 0;
+
+    for(auto i = 0; i < 10; ++i)
+    {
+        COTTON_LOG_DEBUG(logger, "disabled {}", expensive());
+    }
+    auto skipped = evaluated == 0 and g_logged_count == 0;
+
+    COTTON_LOG_INFO(logger, "enabled {}", expensive());
+    if(evaluated == 1)
+        COTTON_LOG_ERROR(logger.get(), "raw pointer {} {}", expensive(), "works");
+    else
+        COTTON_LOG_ERROR(logger, "unreachable");
+
+    auto async_logger = std::make_shared<AsyncLogger>();
+    async_logger->addAppender(std::make_shared<AppenderProxy<CountingAppender>>());
+    async_logger->start();
+    COTTON_LOG_WARN(async_logger, "async {}", expensive());
+    async_logger->stop();
+
+    auto ok = skipped and evaluated == 3 and g_logged_count == 3;
+    std::cout << "Log macros: " << evaluated << " arguments evaluated, " << g_logged_count << " events logged"
+              << (skipped ? "" : ", disabled call evaluated its arguments") << "\n";
+    return ok;
+}
+
+// 运行期反复增删的 appender，单独计数，不影响 g_logged_count
+std::atomic<size_t> g_reconfigured_count = 0;
+
+class ReconfiguredAppender{
+public:
+    static void log(const LogFormatter&, const LogEvent&)
+    {
+        g_reconfigured_count.fetch_add(1);
+    }
+};
+
+// 64 个线程写日志的同时另一个线程反复增删 appender：不能崩溃，常驻 appender 一条都不能少；
+// 结束后换下来的快照都已释放，被删掉的 appender 随之析构
+auto TestAppenderReconfigureWhileLogging() -> bool
+{
+    constexpr size_t c_threads = 64;
+    constexpr size_t c_events = 2000;
+
+    auto logger = std::make_shared<Logger>("ReconfigLogger");
+    auto permanent = std::make_shared<AppenderProxy<CountingAppender>>();
+    logger->addAppender(permanent);
+    g_logged_count = 0;
+    g_reconfigured_count = 0;
+
+    auto running = std::atomic<bool>{true};
+    auto reconfigs = size_t{0};
+    auto extra = std::make_shared<AppenderProxy<ReconfiguredAppender>>();
+    auto watched = std::weak_ptr<AppenderFacade>{extra};
+    auto reconfigurer = std::thread{[&, extra = std::move(extra)]{
+        while(running.load())
+        {
+            logger->addAppender(extra);
+            std::this_thread::yield();
+            logger->delAppender(extra);
+            ++reconfigs;
+            std::this_thread::yield();
+        }
+    }};
+
+    auto threads = std::vector<std::thread>{};
+    for(auto t = size_t{0}; t < c_threads; ++t)
+    {
+        threads.emplace_back([&logger]{
+            for(auto i = size_t{0}; i < c_events; ++i)
+            {
+                log(*logger, LogLevel::INFO);
+                if(i % 64 == 0)
+                {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for(auto& thread : threads)
+    {
+        thread.join();
+    }
+    running = false;
+    reconfigurer.join();
+
+    logger->clearAppender();
+    log(*logger, LogLevel::INFO);
+    auto ok = g_logged_count == c_threads * c_events and logger->getAppenderCount() == 0 and watched.expired();
+    std::cout << "Appender reconfiguration: " << reconfigs << " rounds while logging, "
+              << g_reconfigured_count << " events hit the transient appender, removed appender "
+              << (watched.expired() ? "destroyed" : "still alive") << "\n";
+    return ok;
+}
+
+// 点分名称的层级：上级自动创建，级别和 appender 沿层级继承，表扩容后查找结果不变
+auto TestLoggerHierarchy() -> bool
+{
+    auto manager = LoggerManager{};
+    auto root = manager.getRoot();
+    root->clearAppender();
+    root->addAppender(std::make_shared<AppenderProxy<CountingAppender>>());
+    g_logged_count = 0;
+
+    auto http = manager.getLogger("app.net.http");
+    auto net = http->getParent();
+    auto app = net->getParent();
+    auto ok = net->getLoggerName() == "app.net" and app->getLoggerName() == "app" and app->getParent() == root;
+    ok = ok and manager.getLogger(std::string{"app.net"}) == net and manager.getLogger("app.net.http") == http;
+
+    // 运行期填充的 char 缓冲：名称到第一个 '\0' 为止，哈希在运行期计算
+    char buffer[32] = {};
+    *std::format_to(buffer, "app.{}", "net") = '\0';
+    constexpr auto c_http_name = LoggerName{"app.net.http"};
+    static_assert(c_http_name.hash() == UtilT::cHashString("app.net.http"));
+    ok = ok and manager.getLogger(buffer) == net and manager.getLogger(c_http_name) == http;
+
+    // 级别：沿用最近一个设置过级别的上级
+    root->setLogLevel(LogLevel::WARN);
+    log(*http, LogLevel::INFO);
+    ok = ok and http->getLogLevel() == LogLevel::WARN and g_logged_count == 0;
+    net->setLogLevel(LogLevel::DEBUG);
+    root->setLogLevel(LogLevel::ERROR);
+    log(*http, LogLevel::INFO);
+    ok = ok and http->getLogLevel() == LogLevel::DEBUG and app->getLogLevel() == LogLevel::ERROR and g_logged_count == 1;
+    net->resetLogLevel();
+    ok = ok and http->getLogLevel() == LogLevel::ERROR;
+
+    // appender：自己的 + 上级的，上级改动后同步下来
+    auto extra = std::make_shared<AppenderProxy<CountingAppender>>();
+    app->addAppender(extra);
+    log(*http, LogLevel::FATAL);
+    ok = ok and http->getAppenderCount() == 2 and g_logged_count == 3;
+    app->delAppender(extra);
+    ok = ok and http->getAppenderCount() == 1;
+
+    // 插入足够多的名称触发扩容(有的扩容发生在创建上级的途中)，之前的日志器仍能找到，再查一次拿到的是同一个
+    auto workers = std::vector<Sptr<Logger>>{};
+    for(auto i = 0; i < 200; ++i)
+    {
+        workers.push_back(manager.getLogger(std::format("svc{}.worker", i)));
+    }
+    for(auto i = 0; i < 200; ++i)
+    {
+        ok = ok and manager.getLogger(std::format("svc{}.worker", i)) == workers[static_cast<size_t>(i)];
+    }
+    ok = ok and manager.getLogger("app.net.http") == http and manager.getLogger("svc7")->getParent() == root
+            and manager.getLogger(std::string_view{"svc199.worker"})->getParent() == manager.getLogger("svc199");
+
+    std::cout << "Logger hierarchy: " << (ok ? "levels and appenders inherited" : "inheritance broken") << "\n";
+    return ok;
+}
+
+// metrics_logger 收到的指标行
+std::atomic<size_t> g_metrics_lines = 0;
+std::atomic<size_t> g_metrics_malformed = 0;
+
+class MetricsCaptureAppender{
+public:
+    static void log(const LogFormatter&, const LogEvent& event)
+    {
+        g_metrics_lines.fetch_add(1);
+        if(not event.getContent().starts_with("enqueued="))
+        {
+            g_metrics_malformed.fetch_add(1);
+        }
+    }
+};
+
+// 指标：入队/写出/过滤的事件数守恒，每个 appender 有写入耗时，滚动次数能看到，metrics_logger 定期收到指标行
+auto TestAsyncLoggerMetrics() -> bool
+{
+    constexpr auto c_dir = "metrics_test";
+    constexpr size_t c_info = 900;
+    constexpr size_t c_debug = 100;
+    std::filesystem::remove_all(c_dir);
+    std::filesystem::create_directory(c_dir);
+    g_logged_count = 0;
+    g_metrics_lines = 0;
+    g_metrics_malformed = 0;
+
+    auto metrics_logger = std::make_shared<Logger>("metrics");
+    metrics_logger->addAppender(std::make_shared<AppenderProxy<MetricsCaptureAppender>>());
+
+    auto metrics = AsyncLoggerMetrics{};
+    {
+        auto async_logger = std::make_shared<AsyncLogger>(AsyncLoggerOptions{
+            .flush_interval = 1, .metrics_logger = metrics_logger, .metrics_interval = std::chrono::seconds{0}});
+        async_logger->addAppender(std::make_shared<AppenderProxy<CountingAppender>>());
+        async_logger->addAppender(std::make_shared<AppenderProxy<RollingFileAppender>>(
+            LogFormatter{"%p %m%n"}, std::string{c_dir} + "/app.log", 1_kb));
+        async_logger->setLogLevel(LogLevel::INFO);
+        async_logger->start();
+        for(auto i = size_t{0}; i < c_info + c_debug; ++i)
+        {
+            auto event = LogEvent{"TestLogger", i < c_info ? LogLevel::INFO : LogLevel::DEBUG, 0, 0, "Main", 0, 0};
+            event.print("metrics {}", i);
+            async_logger->append(std::move(event));
+        }
+        async_logger->stop();
+        metrics = async_logger->getMetrics();
+    }
+    std::filesystem::remove_all(c_dir);
+
+    auto ok = metrics.enqueued == c_info + c_debug and metrics.written == c_info and metrics.filtered == c_debug
+              and metrics.totalDropped() == 0 and metrics.pending_buffers == 0 and g_logged_count == c_info
+              and metrics.batch_size.sum == c_info and metrics.appenders.size() == 2
+              and metrics.appenders[0].write_latency_ns.count == metrics.batch_size.count
+              and metrics.appenders[1].rotation_ns.count > 0
+              and g_metrics_lines > 0 and g_metrics_malformed == 0;
+    std::cout << "Async metrics: " << FormatMetrics(metrics) << ", " << g_metrics_lines << " metrics lines\n";
+    return ok;
+}
+
+// 并行消费：记录每个生产者(thread_id)收到的最后一个序号(elapse)，检查同一生产者的事件在这个 appender 上是否保序
+struct OrderState{
+    std::vector<int64_t> last_seq = std::vector<int64_t>(8, -1);
+    std::atomic<size_t> count = 0;
+    size_t disorder = 0;
+    bool gate_passed = true;    // 慢 appender 放行时另一个 appender 是否已经收齐
+};
+
+class OrderCheckAppender{
+public:
+    explicit OrderCheckAppender(OrderState* state, const OrderState* gate = nullptr, size_t gate_count = 0)
+        : state_{state}, gate_{gate}, gate_count_{gate_count} {}
+
+    void log(const LogFormatter&, const LogEvent& event)
+    {
+        log(LogFormatter{}, std::span<const LogEvent>{&event, 1});
+    }
+
+    // 带 gate 的是慢 appender：第一批卡住，直到另一个 appender 收齐 gate_count 条(最多等 5 秒)
+    void log(const LogFormatter&, std::span<const LogEvent> events)
+    {
+        auto deadline = Clock::now() + std::chrono::seconds{5};
+        while(gate_ != nullptr and gate_->count.load() < gate_count_ and Clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        if(gate_ != nullptr)
+        {
+            state_->gate_passed = gate_->count.load() >= gate_count_;
+            gate_ = nullptr;
+        }
+        for(const auto& event : events)
+        {
+            auto& last = state_->last_seq[event.getThreadId()];
+            if(static_cast<int64_t>(event.getElapse()) <= last)
+            {
+                ++state_->disorder;
+            }
+            last = event.getElapse();
+        }
+        state_->count.fetch_add(events.size());
+    }
+
+private:
+    OrderState* state_;
+    const OrderState* gate_;
+    size_t gate_count_;
+};
+
+// 并行消费：慢 appender 卡住时快 appender 照样收齐全部事件，两边都不丢、同一生产者的事件保持顺序
+auto TestParallelConsumersPreserveOrder(AsyncFrontEnd front_end) -> bool
+{
+    constexpr size_t c_producers = 4;
+    constexpr size_t c_events = 250;
+    constexpr size_t c_total = c_producers * c_events;
+
+    auto fast = OrderState{};
+    auto slow = OrderState{};
+    auto options = AsyncLoggerOptions{.flush_interval = 1, .front_end = front_end, .consumer_threads = 4};
+    options.overflow.max_pending_buffers = 64;
+    auto metrics = AsyncLoggerMetrics{};
+    auto running_format_threads = size_t{0};
+    {
+        auto async_logger = std::make_shared<AsyncLogger>(options);
+        async_logger->addAppender(std::make_shared<AppenderProxy<OrderCheckAppender>>(LogFormatter{}, &fast));
+        async_logger->addAppender(std::make_shared<AppenderProxy<OrderCheckAppender>>(LogFormatter{}, &slow, &fast, c_total));
+        async_logger->start();
+        auto threads = std::vector<std::thread>{};
+        for(auto t = uint32_t{0}; t < c_producers; ++t)
+        {
+            threads.emplace_back([&async_logger, t]{
+                for(auto i = uint32_t{0}; i < c_events; ++i)
+                {
+                    auto event = LogEvent{"TestLogger", LogLevel::INFO, i, t, "Worker", 0, 0};
+                    event.print("parallel {} {}", t, i);
+                    async_logger->append(std::move(event));
+                }
+            });
+        }
+        for(auto& th : threads)
+        {
+            th.join();
+        }
+        running_format_threads = async_logger->getMetrics().format_threads;
+        async_logger->stop();
+        metrics = async_logger->getMetrics();
+    }
+
+    auto ok = fast.count == c_total and slow.count == c_total and fast.disorder == 0 and slow.disorder == 0
+              and slow.gate_passed and metrics.totalDropped() == 0
+              and metrics.written == c_total and metrics.in_flight_batches == 0
+              and running_format_threads == options.consumer_threads and metrics.format_threads == 0;
+    std::cout << "Parallel consumers (" << running_format_threads << " format threads): fast " << fast.count << "/" << c_total
+              << ", slow " << slow.count << "/" << c_total
+              << ", disorder " << fast.disorder + slow.disorder
+              << (slow.gate_passed ? ", slow appender did not block fast one\n" : ", slow appender blocked fast one\n");
+    return ok;
+}
+
+// 并行消费运行中删掉 appender：它的写线程写完已发的票就被回收，不用等到 stop()，appender 随之析构
+auto TestParallelConsumersReapRemovedLane() -> bool
+{
+    auto state = OrderState{};
+    auto async_logger = std::make_shared<AsyncLogger>(AsyncLoggerOptions{.flush_interval = 1, .consumer_threads = 2});
+    auto removed = std::make_shared<AppenderProxy<OrderCheckAppender>>(LogFormatter{}, &state);
+    auto watched = std::weak_ptr<AppenderFacade>{removed};
+    async_logger->addAppender(std::make_shared<AppenderProxy<CountingAppender>>());
+    async_logger->addAppender(removed);
+    async_logger->start();
+
+    auto next_id = uint32_t{0};
+    auto append = [&async_logger, &next_id]{
+        auto event = LogEvent{"TestLogger", LogLevel::INFO, next_id++, 0, "Main", 0, 0};
+        event.print("reap {}", next_id);
+        async_logger->append(std::move(event));
+    };
+    // 先等它的写线程写过一批，确认通道已经建好
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{10};
+    while(state.count == 0 and std::chrono::steady_clock::now() < deadline)
+    {
+        append();
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    }
+    async_logger->delAppender(removed);
+    removed.reset();
+    // 之后每一批分发时都会回收写完的通道；后台线程至少每 flush_interval 醒一次
+    while(not watched.expired() and std::chrono::steady_clock::now() < deadline)
+    {
+        append();
+        std::this_thread::sleep_for(std::chrono::milliseconds{50});
+    }
+    auto reaped = state.count > 0 and watched.expired();
+    async_logger->stop();
+
+    std::cout << "Parallel consumers: removed appender lane " << (reaped ? "reaped while running" : "still alive until stop()") << "\n";
+    return reaped;
+}
+
+// 闸门关着时后台线程卡在第一批上，生产者的突发就会一直堆在待写缓冲里
+std::atomic<bool> g_burst_gate_open = true;
+std::atomic<size_t> g_burst_count = 0;
+
+class BurstGateAppender{
+public:
+    static void log(const LogFormatter&, const LogEvent&) { g_burst_count.fetch_add(1); }
+
+    static void log(const LogFormatter&, std::span<const LogEvent> events)
+    {
+        while(not g_burst_gate_open.load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        g_burst_count.fetch_add(events.size());
+    }
+};
+
+// 缓冲池：远超两块备用缓冲的突发全部用预热好的缓冲周转，一块都不新分配；
+// 第一轮突发里还有登记 appender 耗时直方图这类一次性分配，之后的突发整个进程零堆分配
+auto TestBufferPoolBurstNoAllocations() -> bool
+{
+    constexpr size_t c_burst_buffers = 20;
+    constexpr size_t c_burst = c_burst_buffers * c_k_event_count;
+    constexpr size_t c_prewarm = c_burst_buffers + 4;     // 突发 + 当前/备用 + 后台线程的两块预留
+
+    auto async_logger = std::make_shared<AsyncLogger>(AsyncLoggerOptions{
+        .flush_interval = 1, .buffer_pool = {.capacity = 32, .prewarm = c_prewarm}});
+    async_logger->addAppender(std::make_shared<AppenderProxy<BurstGateAppender>>());
+    async_logger->start();
+    g_burst_count = 0;
+
+    // 一轮突发：关闸，写 c_burst 条(全部堆积在待写列表)，开闸，等后台线程写完
+    auto burst = [&async_logger](size_t round) -> size_t {
+        g_burst_gate_open = false;
+        auto before = g_alloc_count.load();
+        for(auto i = size_t{0}; i < c_burst; ++i)
+        {
+            auto event = LogEvent{"TestLogger", LogLevel::INFO, 0, 0, "Main", 0, 0};
+            event.print("burst {} {}", round, i);
+            async_logger->append(std::move(event));
+        }
+        g_burst_gate_open = true;
+        auto deadline = Clock::now() + std::chrono::seconds{5};
+        while(g_burst_count.load() < (round + 1) * c_burst and Clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        return g_alloc_count.load() - before;
+    };
+
+    auto first = burst(0);
+    auto second = burst(1);
+    auto third = burst(2);
+    auto metrics = async_logger->getMetrics();
+    async_logger->stop();
+
+    auto ok = second == 0 and third == 0 and g_burst_count == 3 * c_burst and metrics.totalDropped() == 0
+              and metrics.buffers_allocated == c_prewarm;
+    std::cout << "Buffer pool: allocations per burst of " << c_burst_buffers << " buffers: "
+              << first << " (first), " << second << ", " << third << "; buffers allocated " << metrics.buffers_allocated << "\n";
+    return ok;
+}
+
+// 记录 appender 收到的最后一条事件的身份字段和按 "%t %N %F" 格式化的结果
+struct IdentityCapture{
+    uint32_t thread_id = 0;
+    std::string thread_name;
+    uint32_t fiber_id = 0;
+    std::string formatted;
+};
+
+IdentityCapture g_identity;
+
+class IdentityCaptureAppender{
+public:
+    static void log(const LogFormatter&, const LogEvent& event)
+    {
+        g_identity.thread_id = event.getThreadId();
+        g_identity.thread_name = std::string{event.getThreadName()};
+        g_identity.fiber_id = event.getFiberId();
+        g_identity.formatted = LogFormatter{"%t %N %F"}.format(event);
+    }
+};
+
+auto CurrentFiberForTest() -> uint32_t { return 99; }
+
+// 线程上下文：事件里是真实的内核线程号、设置过的线程名和协程号，取这些字段不分配内存
+auto TestThreadContext() -> bool
+{
+    auto logger = std::make_shared<Logger>("ThreadContextLogger");
+    logger->addAppender(std::make_shared<AppenderProxy<IdentityCaptureAppender>>());
+
+    auto ok = true;
+    auto worker = std::thread{[&]{
+        auto tid = static_cast<uint32_t>(::gettid());
+        auto unnamed = ThreadContext::GetName();
+        ThreadContext::SetName("ctx-worker");
+        ThreadContext::SetFiberId(7);
+        COTTON_LOG_INFO(logger, "identity");
+        ok = ok and not unnamed.empty() and g_identity.thread_id == tid and g_identity.thread_name == "ctx-worker"
+             and g_identity.fiber_id == 7 and g_identity.formatted == std::format("{} ctx-worker 7", tid);
+
+        auto os_name = std::array<char, 16>{};
+        ::pthread_getname_np(::pthread_self(), os_name.data(), os_name.size());
+        ok = ok and std::string_view{os_name.data()} == "ctx-worker";
+
+        ThreadContext::SetFiberIdHook(&CurrentFiberForTest);
+        COTTON_LOG_INFO(logger, "identity");
+        ThreadContext::SetFiberIdHook(nullptr);
+        ok = ok and g_identity.fiber_id == 99;
+
+        auto before = g_alloc_count.load();
+        for(auto i = 0; i < 1000; ++i)
+        {
+            auto event = MakeLogEvent(*logger, LogLevel::INFO, std::source_location::current());
+            ok = ok and event.getThreadId() == tid and event.getFiberId() == 7;
+        }
+        ok = ok and g_alloc_count.load() == before;
+    }};
+    worker.join();
+    ok = ok and ThreadContext::GetTid() == static_cast<uint32_t>(::gettid()) and ThreadContext::GetName() == "Main";
+
+    // fork 出的子进程里线程号要换成子进程的，名称沿用
+    if(auto child = ::fork(); child == 0)
+    {
+        auto child_ok = ThreadContext::GetTid() == static_cast<uint32_t>(::gettid()) and ThreadContext::GetName() == "Main";
+        ::_exit(child_ok ? 0 : 1);
+    }
+    else
+    {
+        auto status = 0;
+        ok = ok and child > 0 and ::waitpid(child, &status, 0) == child and WIFEXITED(status) and WEXITSTATUS(status) == 0;
+    }
+
+    std::cout << "Thread context: " << g_identity.formatted << (ok ? " (tid/name/fiber correct)\n" : " (mismatch)\n");
+    return ok;
+}
+
+// 本机收集端：在 127.0.0.1 的随机端口上建 socket，port 返回端口号；TCP 只 bind 不 listen，由测试决定何时开始接受连接
+auto BindLoopback(int type, uint16_t& port) -> int
+{
+    auto fd = ::socket(AF_INET, type | SOCK_CLOEXEC, 0);
+    auto addr = sockaddr_in{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    auto len = socklen_t{sizeof(addr)};
+    ::bind(fd, reinterpret_cast<sockaddr*>(&addr), len);
+    ::getsockname(fd, reinterpret_cast<sockaddr*>(&addr), &len);
+    port = ntohs(addr.sin_port);
+    // 收集端最多等 5 秒，appender 出问题时测试失败而不是卡住
+    auto timeout = timeval{.tv_sec = 5, .tv_usec = 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    return fd;
+}
+
+// 从连接上读，直到对端关闭或者读到 lines 行(lines 为 0 时一直读到关闭)
+auto ReadConnection(int fd, size_t lines = 0) -> std::string
+{
+    auto received = std::string{};
+    char buf[4096];
+    while(lines == 0 or static_cast<size_t>(std::ranges::count(received, '\n')) < lines)
+    {
+        auto n = ::recv(fd, buf, sizeof(buf), 0);
+        if(n <= 0)
+        {
+            break;
+        }
+        received.append(buf, static_cast<size_t>(n));
+    }
+    return received;
+}
+
+constexpr size_t c_max_udp_read = 64_kb;
+
+// 测试用的事件：一半延迟格式化，一半普通文本。文本输出的 appender 收到的都是日志器渲染好的事件，materialize 模拟这一步
+auto MakeNetworkEvents(size_t count, bool materialize) -> std::vector<LogEvent>
+{
+    auto events = std::vector<LogEvent>{};
+    for(auto i = size_t{0}; i < count; ++i)
+    {
+        auto& event = events.emplace_back("NetLogger", i % 2 == 0 ? LogLevel::INFO : LogLevel::WARN,
+                                          0, 7, "Main", 0, static_cast<uint32_t>(i % 3));
+        if(i % 2 == 0)
+        {
+            event.printDeferred("shipped {} {:>6.2f} {}", i, 0.5 * static_cast<double>(i), i % 3 == 0);
+        }
+        else
+        {
+            event.print("text {} {}", "line", i);
+        }
+        if(materialize)
+        {
+            event.materialize();
+        }
+    }
+    return events;
+}
+
+// TCP 文本：收集端还没起来时先积压，起来后整批发出；收集端断开后按退避重连，两次连接收到的内容拼起来与直接格式化一致
+auto TestNetworkAppenderReconnect() -> bool
+{
+    constexpr size_t c_batch = 200;
+    auto formatter = LogFormatter{"%p %c %m%n"};
+    auto first = MakeNetworkEvents(c_batch, true);
+    auto second = MakeNetworkEvents(c_batch, true);
+    auto expected = std::string{};
+    for(const auto& event : first)
+    {
+        expected += formatter.format(event.rendered());
+    }
+    for(const auto& event : second)
+    {
+        expected += formatter.format(event.rendered());
+    }
+
+    auto port = uint16_t{0};
+    auto listen_fd = BindLoopback(SOCK_STREAM, port);
+    auto received = std::string{};
+    auto stats = NetworkAppenderStats{};
+    auto reconnected = false;
+    {
+        auto appender = std::make_unique<NetworkAppender>(NetworkAppenderOptions{
+            .address = "tcp://127.0.0.1:" + std::to_string(port),
+            .max_batch_bytes = 1_kb,
+            .reconnect_min = std::chrono::milliseconds{5},
+            .reconnect_max = std::chrono::milliseconds{20},
+        });
+        // 还没 listen，连接被拒绝，日志先排队
+        appender->log(formatter, std::span<const LogEvent>{first});
+        std::this_thread::sleep_for(std::chrono::milliseconds{30});
+
+        ::listen(listen_fd, 4);
+        auto conn = ::accept(listen_fd, nullptr, nullptr);
+        received = ReadConnection(conn, c_batch);
+        ::close(conn);
+
+        // 等 appender 发现连接断开并重连上来，再发第二批
+        auto collector = std::thread{[listen_fd, &received]{
+            auto conn = ::accept(listen_fd, nullptr, nullptr);
+            received += ReadConnection(conn);
+            ::close(conn);
+        }};
+        auto deadline = Clock::now() + std::chrono::seconds{3};
+        while(appender->getStats().connects < 2 and Clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        }
+        reconnected = appender->getStats().connects == 2;
+        appender->log(formatter, std::span<const LogEvent>{second});
+        appender->waitIdle(std::chrono::seconds{3});
+        stats = appender->getStats();
+        // 析构时关闭连接，收集端读到 EOF
+        appender.reset();
+        collector.join();
+    }
+    ::close(listen_fd);
+
+    auto ok = reconnected and received == expected and stats.sent_events == 2 * c_batch
+          and stats.dropped_events == 0 and stats.send_calls < 2 * c_batch;
+    std::cout << "Network appender (tcp): " << stats.sent_events << " events in " << stats.send_calls
+              << " sends, " << stats.connects << " connects" << (ok ? ", received identically\n" : ", mismatch\n");
+    return ok;
+}
+
+// UDP 文本：每个数据报不超过 max_batch_bytes 且只含整行；Unix socket 二进制(经 Logger 交付)：延迟格式化的事件按原始参数发出，
+// 收到的字节存成文件后能用 BinaryLogReader 解码
+auto TestNetworkAppenderPayloads() -> bool
+{
+    constexpr size_t c_events = 300;
+    constexpr size_t c_datagram = 1_kb;
+    constexpr auto c_socket = "net_test.sock";
+    constexpr auto c_file = "net_test.bin";
+    auto formatter = LogFormatter{"%d{%Y-%m-%d %H:%M:%S.%f} %p %c %t %F %m%n"};
+    auto events = MakeNetworkEvents(c_events, false);
+    auto text_events = MakeNetworkEvents(c_events, true);
+    auto expected = std::string{};
+    for(const auto& event : events)
+    {
+        expected += formatter.format(event.rendered());
+    }
+
+    // UDP
+    auto port = uint16_t{0};
+    auto udp_fd = BindLoopback(SOCK_DGRAM, port);
+    auto datagrams = std::string{};
+    auto whole_lines = true;
+    auto udp_stats = NetworkAppenderStats{};
+    {
+        auto appender = NetworkAppender{NetworkAppenderOptions{
+            .address = "udp://127.0.0.1:" + std::to_string(port),
+            .max_batch_bytes = c_datagram,
+        }};
+        appender.log(formatter, std::span<const LogEvent>{text_events});
+        appender.waitIdle(std::chrono::seconds{3});
+        udp_stats = appender.getStats();
+    }
+    char datagram[c_max_udp_read];
+    for(auto i = uint64_t{0}; i < udp_stats.send_calls; ++i)
+    {
+        auto n = ::recv(udp_fd, datagram, sizeof(datagram), 0);
+        if(n <= 0)
+        {
+            break;
+        }
+        whole_lines = whole_lines and static_cast<size_t>(n) <= c_datagram and datagram[n - 1] == '\n';
+        datagrams.append(datagram, static_cast<size_t>(n));
+    }
+    ::close(udp_fd);
+    auto udp_ok = datagrams == expected and whole_lines and udp_stats.send_calls > 1;
+
+    // Unix socket + 二进制
+    std::filesystem::remove(c_socket);
+    auto unix_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    auto addr = sockaddr_un{};
+    addr.sun_family = AF_UNIX;
+    std::strcpy(addr.sun_path, c_socket);
+    ::bind(unix_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    ::listen(unix_fd, 4);
+    auto bytes = std::string{};
+    auto collector = std::thread{[unix_fd, &bytes]{
+        auto conn = ::accept(unix_fd, nullptr, nullptr);
+        bytes = ReadConnection(conn);
+        ::close(conn);
+    }};
+    {
+        // 经 Logger 交付：延迟格式化的事件不渲染，原始参数直接编码进二进制流
+        auto logger = std::make_shared<Logger>("NetLogger");
+        logger->addAppender(std::make_shared<AppenderProxy<NetworkAppender>>(LogFormatter{}, NetworkAppenderOptions{
+            .address = std::string{"unix://"} + c_socket,
+            .payload = NetworkPayload::Binary,
+            .max_batch_bytes = 4_kb,
+        }));
+        logger->log(std::span<const LogEvent>{events});
+    }
+    collector.join();
+    ::close(unix_fd);
+    std::filesystem::remove(c_socket);
+
+    std::ofstream{c_file, std::ios::binary}.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    auto decoded = std::string{};
+    auto corrupt = size_t{0};
+    {
+        auto reader = BinaryLogReader{c_file};
+        auto event = LogEvent{};
+        while(reader.next(event))
+        {
+            decoded += formatter.format(event);
+        }
+        corrupt = reader.getCorruptBlocks();
+    }
+    std::filesystem::remove(c_file);
+    auto raw = bytes.find("shipped {} {:>6.2f} {}") != std::string::npos and bytes.find("shipped 0") == std::string::npos;
+    auto binary_ok = decoded == expected and corrupt == 0 and raw;
+
+    std::cout << "Network appender (udp): " << udp_stats.send_calls << " datagrams"
+              << (udp_ok ? ", whole lines\n" : ", mismatch\n");
+    std::cout << "Network appender (unix, binary): " << bytes.size() << " bytes"
+              << (raw ? ", raw arguments" : ", rendered text")
+              << (decoded == expected and corrupt == 0 ? ", decoded identically\n" : ", decoded text differs\n");
+    return udp_ok and binary_ok;
+}
+
+// ThreadLocal 前端：线程退出时没写满的暂存缓冲、以及 stop() 时存活线程的暂存缓冲都不能丢
+auto TestThreadLocalStagingFlush() -> bool
+{
+    constexpr size_t c_threads = 4;
+    constexpr size_t c_events  = 100;     // 不是 64 的整数倍，保证每个线程都留下半满的缓冲
+
+    g_logged_count = 0;
+    auto async_logger = std::make_shared<AsyncLogger>(1, AsyncFrontEnd::ThreadLocal);
+    async_logger->addAppender(std::make_shared<AppenderProxy<CountingAppender>>());
+    async_logger->start();
+
+    auto threads = std::vector<std::thread>{};
+    for(auto t = size_t{0}; t < c_threads; ++t)
+    {
+        threads.emplace_back([&async_logger]{
+            for(auto i = size_t{0}; i < c_events; ++i)
+            {
+                async_logger->append(LogEvent{"TestLogger", LogLevel::INFO, 0, 0, "Worker", 0, 0});
+            }
+        });
+    }
+    for(auto& th : threads)
+    {
+        th.join();
+    }
+
+    // 主线程自己的暂存缓冲要靠 stop() 收走
+    for(auto i = size_t{0}; i < c_events; ++i)
+    {
+        async_logger->append(LogEvent{"TestLogger", LogLevel::INFO, 0, 0, "Main", 0, 0});
+    }
+    async_logger->stop();
+
+    auto expected = (c_threads + 1) * c_events;
+    std::cout << "ThreadLocal staging: " << g_logged_count << "/" << expected << " events written\n";
+    return g_logged_count == expected;
+}
+
+// 长寿命线程反复使用短寿命的 ThreadLocal logger：已析构 logger 的暂存登记项在下一次登记时被清掉，不会一直累积
+auto TestThreadLocalStagingPrunesDeadLoggers() -> bool
+{
+    constexpr size_t c_loggers = 50;
+
+    g_logged_count = 0;
+    auto max_entries = size_t{0};
+    auto final_entries = size_t{0};
+    std::thread{[&]{
+        for(auto i = size_t{0}; i < c_loggers; ++i)
+        {
+            auto async_logger = std::make_shared<AsyncLogger>(1, AsyncFrontEnd::ThreadLocal);
+            async_logger->addAppender(std::make_shared<AppenderProxy<CountingAppender>>());
+            async_logger->start();
+            async_logger->append(LogEvent{"TestLogger", LogLevel::INFO, 0, 0, "Worker", 0, 0});
+            max_entries = std::max(max_entries, AsyncLogger::threadStagingCount());
+            async_logger->stop();
+        }
+        final_entries = AsyncLogger::threadStagingCount();
+    }}.join();
+
+    std::cout << "ThreadLocal staging: " << c_loggers << " short-lived loggers, at most " << max_entries
+              << " staging entries on the thread, " << g_logged_count << "/" << c_loggers << " events written\n";
+    return max_entries == 1 and final_entries == 1 and g_logged_count == c_loggers;
+}
+
+// DropBelowLevel：突发流量下 DEBUG 可以丢，FATAL 一条都不能丢，且丢弃计数必须精确
+auto TestDropBelowLevelKeepsFatal() -> bool
+{
+    constexpr size_t c_total = c_k_event_count * 8;
+
+    g_logged_count = 0;
+    g_logged_error_count = 0;
+    auto options = AsyncLoggerOptions{};
+    options.overflow.policy = OverflowPolicy::DropBelowLevel;
+    options.overflow.max_pending_buffers = 2;
+    auto async_logger = std::make_shared<AsyncLogger>(options);
+    async_logger->addAppender(std::make_shared<AppenderProxy<CountingAppender>>());
+
+    // 后台线程还没启动，模拟消费者完全跟不上的突发
+    auto fatal_count = size_t{0};
+    for(auto i = size_t{0}; i < c_total; ++i)
+    {
+        auto level = (i % 10 == 0) ? LogLevel::FATAL : LogLevel::DEBUG;
+        fatal_count += (level == LogLevel::FATAL);
+        async_logger->append(LogEvent{"TestLogger", level, 0, 0, "Main", 0, 0});
+    }
+    async_logger->start();
+    async_logger->stop();
+
+    auto stats = async_logger->getOverflowStats();
+    std::cout << "DropBelowLevel: " << g_logged_error_count << "/" << fatal_count << " FATAL written, "
+              << stats.dropped_below_level << " DEBUG dropped\n";
+    return g_logged_error_count == fatal_count
+       and g_logged_count + stats.dropped_below_level == c_total
+       and stats.dropped_below_level > 0;
+}
+
+// MpscRing + DropBelowLevel：消费者卡在 appender 里、环形队列写满时，FATAL 最多等 block_timeout 就计数丢弃，生产者不会一直自旋
+auto TestRingDropBelowLevelStalledConsumer() -> bool
+{
+    constexpr size_t c_extra_after_drop = 10;
+    constexpr size_t c_max_events = AsyncLogger::EventRing::capacity() * 2;
+
+    auto options = AsyncLoggerOptions{.front_end = AsyncFrontEnd::MpscRing};
+    options.overflow.policy = OverflowPolicy::DropBelowLevel;
+    options.overflow.block_timeout = std::chrono::milliseconds{2};
+    auto async_logger = std::make_shared<AsyncLogger>(options);
+    async_logger->addAppender(std::make_shared<AppenderProxy<BurstGateAppender>>());
+    g_burst_count = 0;
+    g_burst_gate_open = false;
+    async_logger->start();
+
+    // 生产者一直写 FATAL，直到出现丢弃后再多写几条；修复前它会卡在满队列上直到闸门打开
+    auto appended = std::atomic<size_t>{0};
+    auto producer_done = std::atomic<bool>{false};
+    auto producer = std::thread{[&]{
+        auto extra = size_t{0};
+        while(appended.load() < c_max_events and extra < c_extra_after_drop)
+        {
+            async_logger->append(LogEvent{"TestLogger", LogLevel::FATAL, 0, 0, "Main", 0, 0});
+            appended.fetch_add(1);
+            extra += (async_logger->getOverflowStats().dropped_block_timeout > 0);
+        }
+        producer_done = true;
+    }};
+
+    auto deadline = Clock::now() + std::chrono::seconds{2};
+    while(not producer_done.load() and Clock::now() < deadline)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+    }
+    auto finished_while_stalled = producer_done.load();
+    g_burst_gate_open = true;
+    producer.join();
+    async_logger->stop();
+
+    auto stats = async_logger->getOverflowStats();
+    std::cout << "Ring DropBelowLevel with stalled consumer: producer " << (finished_while_stalled ? "returned" : "spun")
+              << ", " << stats.dropped_block_timeout << " FATAL dropped after block_timeout, "
+              << g_burst_count << "/" << appended << " written\n";
+    return finished_while_stalled and stats.dropped_block_timeout >= c_extra_after_drop
+       and stats.dropped_below_level == 0 and g_burst_count + stats.dropped_block_timeout == appended;
+}
+
+// 结构化字段：JSON/logfmt 输出、延迟事件上的字段、二进制往返，数值字段不分配内存
+auto TestStructuredFields() -> bool
+{
+    enum class Side : uint8_t { Buy = 1, Sell = 2 };
+    constexpr auto c_file = "fields_test.bin";
+
+    auto event = LogEvent{"TestLogger", LogLevel::INFO, 0, 7, "Main", 1700000000, 0};
+    event.print("order \"{}\"\n filled", 42);
+    event.with("user_id", uint64_t{12345}).with("px", 101.25).with("ok", true).with("side", Side::Sell)
+         .with("delta", -3).with("ratio", std::numeric_limits<double>::infinity());
+    event.with("path", std::string_view{"/api/v1 \"x\"\t"}).with("name", "cotton");
+    // 有字段之后再 print，消息插在字段前面
+    event.print(" {}", "done");
+
+    auto json = LogFormatter{R"({"msg":"%E"%j})"}.format(event);
+    auto expected_json = std::string{R"({"msg":"order \"42\"\n filled done","user_id":12345,"px":101.25,"ok":true,)"
+                                     R"("side":2,"delta":-3,"ratio":null,"path":"/api/v1 \"x\"\t","name":"cotton"})"};
+    auto logfmt = LogFormatter{"%K"}.format(event);
+    auto expected_logfmt = std::string{R"( user_id=12345 px=101.25 ok=true side=2 delta=-3 ratio=inf path="/api/v1 \"x\"\t" name=cotton)"};
+    auto full = LogFormatter{c_k_json_pattern}.format(event);
+    auto compiled = StaticLogFormatter<c_k_json_pattern>{}.format(event);
+    auto control = LogEvent{"TestLogger", LogLevel::INFO, 0, 7, "Main", 0, 0};
+    control.print("a{}b", '\x01');
+    // 放得进内联缓冲的数值字段只是几次 memcpy
+    auto before = g_alloc_count.load();
+    control.with("user_id", uint64_t{12345}).with("px", 101.25).with("ok", true).with("side", Side::Buy);
+    auto allocations = g_alloc_count.load() - before;
+
+    // 延迟事件：参数在后台渲染，字段原样跟着走，二进制编码保留原始字节
+    auto deferred = LogEvent{"TestLogger", LogLevel::WARN, 0, 7, "Main", 1700000000, 0};
+    deferred.printDeferred("deferred {} {}", 1, 2.5);
+    deferred.with("request", 9).with("route", "/health");
+    auto rendered = LogFormatter{R"({"msg":"%E"%j})"}.format(deferred.rendered());
+
+    std::filesystem::remove(c_file);
+    {
+        auto appender = BinaryFileAppender{c_file};
+        appender.log(LogFormatter{}, deferred);
+        appender.log(LogFormatter{}, event);
+    }
+    auto decoded = std::string{};
+    {
+        auto reader = BinaryLogReader{c_file};
+        auto back = LogEvent{};
+        while(reader.next(back))
+        {
+            decoded += LogFormatter{R"({"msg":"%E"%j})"}.format(back);
+        }
+    }
+    std::filesystem::remove(c_file);
+
+    auto ok = json == expected_json and logfmt == expected_logfmt and allocations == 0
+          and full == compiled and full.ends_with(R"(,"tid":7,"msg":"order \"42\"\n filled done","user_id":12345,"px":101.25,)"
+                                                  R"("ok":true,"side":2,"delta":-3,"ratio":null,"path":"/api/v1 \"x\"\t","name":"cotton"})" "\n")
+          and LogFormatter{"%E"}.format(control) == R"(a\u0001b)"
+          and LogFormatter{"%K"}.format(control) == " user_id=12345 px=101.25 ok=true side=1"
+          and rendered == R"({"msg":"deferred 1 2.5","request":9,"route":"/health"})"
+          and decoded == rendered + expected_json
+          and sizeof(LogEvent) == 192;
+    std::cout << "Structured fields: " << (ok ? "json/logfmt/binary match" : "mismatch") << ", "
+              << allocations << " allocations for scalar fields\n";
+    if(not ok)
+    {
+        std::cout << json << "\n" << logfmt << "\n" << full << rendered << "\n" << decoded << "\n";
+    }
+    return ok;
+}
+
+// TextKernels：各指令集的转义查找与逐字节实现一致，整数、短串拷贝与 to_chars/原样拷贝一致
+auto TestTextKernels() -> bool
+{
+    auto mismatches = size_t{0};
+    // 每个长度、每个位置放一个需要转义的字节，覆盖向量宽度的边界和尾巴
+    auto text = std::string(100, 'a');
+    for(auto length = size_t{0}; length <= text.size(); ++length)
+    {
+        for(auto pos = size_t{0}; pos <= length; ++pos)
+        {
+            for(auto special : {'"', '\\', '\x01', '\x1f', '\n'})
+            {
+                auto probe = text.substr(0, length);
+                if(pos < length)
+                {
+                    probe[pos] = special;
+                }
+                // 0x7f 以上和 0x20 不需要转义
+                if(length > 0 and pos > 0)
+                {
+                    probe[pos - 1] = static_cast<char>(pos % 2 == 0 ? 0xE4 : 0x20);
+                }
+                for(auto isa : {TextKernels::Isa::Scalar, TextKernels::Isa::Sse2, TextKernels::Isa::Avx2})
+                {
+                    mismatches += TextKernels::FindJsonEscape(probe, isa) != pos;
+                }
+                mismatches += TextKernels::FindJsonEscape(probe) != pos;
+            }
+        }
+    }
+
+    auto buf = LogBuffer{};
+    auto expected = std::string{};
+    auto append_int = [&]<typename T>(T value){
+        char digits[24];
+        auto [end, ec] = std::to_chars(digits, digits + sizeof(digits), value);
+        expected.append(digits, end);
+        expected.push_back(' ');
+        buf.appendInt(value);
+        buf.push_back(' ');
+    };
+    for(auto value = uint64_t{1}; value != 0 and value < UINT64_MAX / 10; value *= 10)
+    {
+        append_int(value - 1);
+        append_int(value);
+        append_int(-static_cast<int64_t>(value));
+    }
+    append_int(uint64_t{0});
+    append_int(std::numeric_limits<uint64_t>::max());
+    append_int(std::numeric_limits<int64_t>::min());
+    append_int(std::numeric_limits<int8_t>::min());
+    append_int(std::numeric_limits<uint32_t>::max());
+    // 各种长度的拷贝，累计超过初始容量触发扩容
+    for(auto length = size_t{0}; length <= 80; ++length)
+    {
+        auto piece = std::string(length, static_cast<char>('A' + length % 26));
+        expected += piece;
+        buf.append(piece);
+    }
+    auto moved = std::move(buf);
+    moved.push_back('!');
+    expected.push_back('!');
+
+    auto ok = mismatches == 0 and moved.view() == expected and buf.empty();
+    std::cout << "Text kernels (" << TextKernels::IsaName(TextKernels::BestIsa()) << "): "
+              << mismatches << " escape scan mismatches, integer/copy output "
+              << (moved.view() == expected ? "matches" : "differs") << "\n";
+    return ok;
+}
+
+// 调用点限流：令牌桶和 1-in-N 的放行数、汇总的时机和计数，宏里被挡掉的调用不求值参数
+auto TestCallSiteLimiter() -> bool
+{
+    constexpr int64_t c_ms = 1'000'000;
+    constexpr int64_t c_start = 1'000 * c_ms;
+
+    // 每秒 10 个、突发 5 个：同一时刻只放 5 个，100ms 后补 1 个(开始计时)，再过 1s 放行时汇总前面挡掉的
+    auto bucket = CallSiteLimiter{RateLimit{.per_second = 10, .burst = 5}};
+    auto burst_allowed = size_t{0};
+    auto early_summaries = uint64_t{0};
+    for(auto i = 0; i < 20; ++i)
+    {
+        auto decision = bucket.check(c_start);
+        burst_allowed += decision.allowed_;
+        early_summaries += decision.suppressed_;
+    }
+    auto refill = bucket.check(c_start + 100 * c_ms);
+    auto empty = bucket.check(c_start + 100 * c_ms);
+    auto summary = bucket.check(c_start + 1'100 * c_ms);
+    auto bucket_ok = burst_allowed == 5 and early_summaries == 0 and refill.allowed_ and not empty.allowed_
+                 and summary.allowed_ and summary.suppressed_ == 16;
+
+    auto sampler = CallSiteLimiter{RateLimit{.one_in = 100, .summary_interval = std::chrono::milliseconds{0}}};
+    auto sampled = size_t{0};
+    auto sampled_suppressed = uint64_t{0};
+    for(auto i = int64_t{0}; i < 1000; ++i)
+    {
+        auto decision = sampler.check(c_start + i);
+        sampled += decision.allowed_;
+        sampled_suppressed += decision.suppressed_;
+    }
+    // 汇总间隔为 0：第二次采中时开始计时，之后每次采中都把累计的计数汇总出去；最后 99 条留到下一次采中
+    auto sampler_ok = sampled == 10 and sampled_suppressed == 990 - 99;
+
+    // 宏：1000 次调用只输出 10 条，参数只求值 10 次；汇总间隔取得很长，测试里不会产生汇总
+    auto evaluated = size_t{0};
+    auto logger = std::make_shared<Logger>("LimitedLogger");
+    logger->addAppender(std::make_shared<AppenderProxy<CountingAppender>>());
+    g_logged_count = 0;
+    for(auto i = 0; i < 1000; ++i)
+    {
+        COTTON_LOG_LIMITED(logger, LogLevel::WARN, (RateLimit{.one_in = 100, .summary_interval = std::chrono::hours{1}}),
+                           "flood {}", ++evaluated);
+    }
+    auto macro_ok = evaluated == 10 and g_logged_count == 10;
+
+    std::cout << "Call site limiter: token bucket " << (bucket_ok ? "ok" : "wrong") << ", sampled " << sampled
+              << "/1000 with " << sampled_suppressed << " summarised, macro logged " << g_logged_count
+              << " and evaluated " << evaluated << "\n";
+    return bucket_ok and sampler_ok and macro_ok and alignof(CallSiteLimiter) == c_k_cache_line;
+}
+
+} // namespace
 
 int main() {
     std::cout << "========== 日志系统极简测试 ==========\n";
     
     auto sync_logger = std::make_shared<Logger>();
-    sync_logger->addAppender(std::make_shared<AppenderProxy<RollingFileAppender>>("sync_log.txt", 1_kb));
+    sync_logger->addAppender(std::make_shared<AppenderProxy<RollingFileAppender>>(LogFormatter{}, "sync_log.txt", 1_kb));
 
-    uint32_t tid = static_cast<uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    ThreadContext::SetName("Main");
     auto now_t = SystemClock::to_time_t(SystemClock::now());
     
     // 构造事件并打印
-    LogEvent event{"TestLogger", LogLevel::INFO, 0, tid, "Main", now_t, 0};
+    LogEvent event{LogNameRegistry::Intern("TestLogger"), LogLevel::INFO, 0,
+                   ThreadContext::GetTid(), ThreadContext::GetNameId(), now_t, ThreadContext::GetFiberId()};
     event.print("Hello Cotton Log System! Random: {}", 42);
     
     sync_logger->log(event);
 
+    auto ok = TestThreadLocalStagingFlush();
+    ok = TestThreadLocalStagingPrunesDeadLoggers() and ok;
+    ok = TestDropBelowLevelKeepsFatal() and ok;
+    ok = TestRingDropBelowLevelStalledConsumer() and ok;
+    ok = TestDeferredFormatting() and ok;
+    ok = TestStaticFormatterMatchesRuntime() and ok;
+    ok = TestMmapAppenderRecoversAfterCrash() and ok;
+    ok = TestRollingFileRetention() and ok;
+    ok = TestRollingFileRecoversNext() and ok;
+    ok = TestRotationSyncFallback() and ok;
+    ok = TestBinaryLogRoundTrip() and ok;
+    ok = TestLogNameRegistryGrows() and ok;
+    ok = TestBinaryAppenderKeepsRawArgs() and ok;
+    ok = TestLogMacrosSkipDisabled() and ok;
+    ok = TestAppenderReconfigureWhileLogging() and ok;
+    ok = TestLoggerHierarchy() and ok;
+    ok = TestAsyncLoggerMetrics() and ok;
+    ok = TestParallelConsumersPreserveOrder(AsyncFrontEnd::DoubleBuffer) and ok;
+    ok = TestParallelConsumersPreserveOrder(AsyncFrontEnd::MpscRing) and ok;
+    ok = TestParallelConsumersPreserveOrder(AsyncFrontEnd::ThreadLocal) and ok;
+    ok = TestParallelConsumersReapRemovedLane() and ok;
+    ok = TestBufferPoolBurstNoAllocations() and ok;
+    ok = TestThreadContext() and ok;
+    ok = TestNetworkAppenderReconnect() and ok;
+    ok = TestNetworkAppenderPayloads() and ok;
+    ok = TestStructuredFields() and ok;
+    ok = TestTextKernels() and ok;
+    ok = TestCallSiteLimiter() and ok;
+
     std::cout << "测试完成，请查看 sync_log.txt 是否生成！\n";
-    return 0;
-}
\ No newline at end of file
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,10 @@
+#!/bin/bash
+
+# 编译离线工具，参数与 test/test.bash 一致，额外开启 -O2
+# 用法: ./build.bash [工具名]   不带参数时编译全部
+
+tools=${@:-$(ls *.cpp | sed 's/\.cpp$//')}
+
+for t in $tools; do
+    g++ $t.cpp ../src/*.cpp ../net/*.cpp -I../include -I.. -std=c++23 -O2 -lpthread -lz -o $t
+done
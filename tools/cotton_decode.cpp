@@ -0,0 +1,81 @@
+#include "logger/BinaryLogReader.h"
+#include "logger/LogFormatter.h"
+
+#include <exception>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief 把 BinaryFileAppender 写出的二进制日志还原成文本，输出到标准输出
+ * @details 用法: cotton_decode [-p <LogFormatter 模式>] <文件>...
+ *          不指定 -p 时使用默认模式；有损坏块时在标准错误上报告块数，返回值为 1
+ */
+
+namespace {
+
+auto Usage() -> int
+{
+    std::cerr << "usage: cotton_decode [-p <pattern>] <file>...\n";
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    auto pattern = std::string{c_k_default_pattern};
+    auto files = std::vector<std::string>{};
+    for(auto i = 1; i < argc; ++i)
+    {
+        auto arg = std::string_view{argv[i]};
+        if(arg == "-p")
+        {
+            if(++i == argc)
+            {
+                return Usage();
+            }
+            pattern = argv[i];
+        }
+        else
+        {
+            files.emplace_back(arg);
+        }
+    }
+    if(files.empty())
+    {
+        return Usage();
+    }
+
+    auto formatter = LogFormatter{pattern};
+    auto output = LogBuffer{};
+    auto status = 0;
+    for(const auto& file : files)
+    {
+        try{
+            auto reader = BinaryLogReader{file};
+            auto event = LogEvent{};
+            while(reader.next(event))
+            {
+                formatter.format(output, event);
+                if(output.size() >= 64 * 1024)
+                {
+                    std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+                    output.clear();
+                }
+            }
+            std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+            output.clear();
+            if(reader.getCorruptBlocks() != 0)
+            {
+                std::cerr << file << ": skipped " << reader.getCorruptBlocks() << " corrupt block(s)\n";
+                status = 1;
+            }
+        } catch (const std::exception& e){
+            std::cerr << file << ": " << e.what() << "\n";
+            status = 2;
+        }
+    }
+    return status;
+}